@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Measures the throughput of the software blitter of nds/arm9/blit.h in
+// megapixels per second, drawing to a bitmap background in VRAM and to a
+// buffer in main RAM.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nds.h>
+
+#define SCREEN_W        256
+#define SCREEN_H        192
+
+#define SPRITE_SIZE     64
+#define REPETITIONS     16
+
+static u16 sprite16[SPRITE_SIZE * SPRITE_SIZE] ALIGN(4);
+static u8 sprite8[SPRITE_SIZE * SPRITE_SIZE] ALIGN(4);
+static u16 sprite_palette[256];
+
+static u16 ram16[SCREEN_W * SCREEN_H] ALIGN(4);
+static u8 ram8[SCREEN_W * SCREEN_H] ALIGN(4);
+
+static void report(const char *name, u32 pixels, u32 ticks)
+{
+    unsigned long us = timerTicks2usec(ticks);
+    if (us == 0)
+        us = 1;
+
+    // Pixels per microsecond is the same as megapixels per second
+    unsigned long mpix10 = (unsigned long)pixels * 10 / us;
+
+    printf("%-18s %3lu.%lu MPix/s\n", name, mpix10 / 10, mpix10 % 10);
+}
+
+// Draws the sprite at several positions of the destination surface
+static u32 bench_copy(const BlitSurface *dst, const BlitSurface *src,
+                      BlitMode mode, u16 param)
+{
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+    {
+        for (int y = 0; y + SPRITE_SIZE <= SCREEN_H; y += SPRITE_SIZE)
+        {
+            for (int x = 0; x + SPRITE_SIZE <= SCREEN_W; x += SPRITE_SIZE)
+                blitCopy(dst, x, y, src, 0, 0, SPRITE_SIZE,
+                         SPRITE_SIZE, mode, param);
+        }
+    }
+
+    return cpuEndTiming();
+}
+
+static u32 copy_pixels(void)
+{
+    return REPETITIONS * (SCREEN_W / SPRITE_SIZE) * (SCREEN_H / SPRITE_SIZE)
+           * SPRITE_SIZE * SPRITE_SIZE;
+}
+
+static void bench_surface(const char *title, const BlitSurface *dst16,
+                          const BlitSurface *src16, const BlitSurface *src8)
+{
+    printf("%s\n", title);
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        blitFillRect(dst16, 0, 0, SCREEN_W, SCREEN_H, RGB15(r, 0, 0) | BIT(15));
+
+    report("Fill", REPETITIONS * SCREEN_W * SCREEN_H, cpuEndTiming());
+
+    report("Copy 16 opaque", copy_pixels(),
+           bench_copy(dst16, src16, BlitMode_Opaque, 0));
+    report("Copy 16 transp.", copy_pixels(),
+           bench_copy(dst16, src16, BlitMode_Transparent, 0));
+    report("Copy 16 alpha", copy_pixels(),
+           bench_copy(dst16, src16, BlitMode_Alpha, 16));
+    report("Copy 8 to 16", copy_pixels(),
+           bench_copy(dst16, src8, BlitMode_Transparent, 0));
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        blitScaled(dst16, 0, 0, SCREEN_W, SCREEN_H, src16, 0, 0, SPRITE_SIZE,
+                   SPRITE_SIZE, BlitMode_Opaque, 0);
+
+    report("Scaled 16", REPETITIONS * SCREEN_W * SCREEN_H, cpuEndTiming());
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS * 64; r++)
+        blitLine(dst16, 0, r % SCREEN_H, SCREEN_W - 1, SCREEN_H - 1 - r % SCREEN_H,
+                 RGB15(31, 31, 31) | BIT(15));
+
+    report("Lines", REPETITIONS * 64 * SCREEN_W, cpuEndTiming());
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    videoSetMode(MODE_5_2D);
+    vramSetBankA(VRAM_A_MAIN_BG);
+    int bg = bgInit(3, BgType_Bmp16, BgSize_B16_256x256, 0, 0);
+
+    consoleDemoInit();
+
+    srand(1234);
+
+    // Sprites with a transparent border, like in a typical game
+    for (int y = 0; y < SPRITE_SIZE; y++)
+    {
+        for (int x = 0; x < SPRITE_SIZE; x++)
+        {
+            bool opaque = (x > 4) && (x < SPRITE_SIZE - 4)
+                          && (y > 4) && (y < SPRITE_SIZE - 4);
+            u16 color = rand() & 0x7FFF;
+
+            sprite16[y * SPRITE_SIZE + x] = opaque ? (color | BIT(15)) : 0;
+            sprite8[y * SPRITE_SIZE + x] = opaque ? (1 + (rand() % 255)) : 0;
+        }
+    }
+
+    for (int i = 0; i < 256; i++)
+        sprite_palette[i] = (rand() & 0x7FFF) | BIT(15);
+
+    BlitSurface src16, src8, vram16, main16, main8;
+
+    blitSurfaceInit(&src16, sprite16, SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE,
+                    BlitFormat_16bpp, NULL);
+    blitSurfaceInit(&src8, sprite8, SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE,
+                    BlitFormat_8bpp, sprite_palette);
+    blitSurfaceInitBg(&vram16, bg);
+    blitSurfaceInit(&main16, ram16, SCREEN_W, SCREEN_H, SCREEN_W,
+                    BlitFormat_16bpp, NULL);
+    blitSurfaceInit(&main8, ram8, SCREEN_W, SCREEN_H, SCREEN_W,
+                    BlitFormat_8bpp, NULL);
+
+    printf("Blitter benchmark\n\n");
+
+    bench_surface("VRAM, 16 bpp", &vram16, &src16, &src8);
+    bench_surface("Main RAM, 16 bpp", &main16, &src16, &src8);
+
+    printf("Main RAM, 8 bpp\n");
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        blitFillRect(&main8, 0, 0, SCREEN_W, SCREEN_H, r);
+
+    report("Fill", REPETITIONS * SCREEN_W * SCREEN_H, cpuEndTiming());
+
+    report("Copy 8 opaque", copy_pixels(),
+           bench_copy(&main8, &src8, BlitMode_Opaque, 0));
+    report("Copy 8 transp.", copy_pixels(),
+           bench_copy(&main8, &src8, BlitMode_Transparent, 0));
+
+    printf("\nPress START to exit\n");
+
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Lists a directory with 5000 files in the default FAT drive (SD card or flash
+// cartridge) in several ways: readdir() only, readdir() followed by stat() with
+// and without the directory entry cache, and fatReadDirStat().
+//
+// The directory is created the first time the benchmark runs, which takes a
+// while. It isn't deleted at the end so that the next runs are faster.
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fat.h>
+#include <nds.h>
+
+#define NUM_FILES       5000
+#define DIR_NAME        "libnds_bench_list"
+
+static char base[PATH_MAX];
+
+static void wait_forever(void)
+{
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            exit(0);
+    }
+}
+
+static int create_files(void)
+{
+    char path[PATH_MAX];
+
+    // The last file is created last, so its presence means the directory is
+    // complete.
+    snprintf(path, sizeof(path), "%s/f%04d.bin", base, NUM_FILES - 1);
+    if (access(path, F_OK) == 0)
+        return 0;
+
+    printf("Creating %d files...\n", NUM_FILES);
+
+    if ((mkdir(base, 0777) != 0) && (errno != EEXIST))
+        return -1;
+
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_FILES; i++)
+    {
+        snprintf(path, sizeof(path), "%s/f%04d.bin", base, i);
+
+        FILE *f = fopen(path, "wb");
+        if (f == NULL)
+            return -1;
+
+        fwrite(path, 1, i % 32, f);
+        fclose(f);
+    }
+
+    printf("  Done in %lu ms\n", (unsigned long)timerTicks2msec(cpuEndTiming()));
+
+    return 0;
+}
+
+// Returns the number of entries found, or -1 on error
+static int list(bool use_stat, bool use_readdir_stat)
+{
+    DIR *dir = opendir(base);
+    if (dir == NULL)
+        return -1;
+
+    int count = 0;
+
+    while (1)
+    {
+        struct stat st;
+        struct dirent *ent;
+
+        if (use_readdir_stat)
+            ent = fatReadDirStat(dir, &st);
+        else
+            ent = readdir(dir);
+
+        if (ent == NULL)
+            break;
+
+        if (ent->d_name[0] == '.')
+            continue;
+
+        if (use_stat)
+        {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s", base, ent->d_name);
+
+            if (stat(path, &st) != 0)
+            {
+                closedir(dir);
+                return -1;
+            }
+        }
+
+        count++;
+    }
+
+    closedir(dir);
+
+    return count;
+}
+
+static void bench(const char *name, bool use_stat, bool use_readdir_stat)
+{
+    cpuStartTiming(0);
+
+    int count = list(use_stat, use_readdir_stat);
+
+    u32 ticks = cpuEndTiming();
+
+    if (count < 0)
+    {
+        printf("%s: error\n", name);
+        return;
+    }
+
+    printf("%s\n", name);
+    printf("  %d files, %lu ms\n", count, (unsigned long)timerTicks2msec(ticks));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    consoleDemoInit();
+
+    if (!fatInitDefault())
+    {
+        printf("fatInitDefault() failed\n");
+        wait_forever();
+    }
+
+    // The directory cache only works with absolute paths that include the
+    // name of the drive, like "sd:/".
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+    {
+        printf("getcwd() failed\n");
+        wait_forever();
+    }
+
+    size_t len = strlen(cwd);
+    snprintf(base, sizeof(base), "%s%s" DIR_NAME, cwd,
+             ((len > 0) && (cwd[len - 1] == '/')) ? "" : "/");
+
+    printf("FAT listing benchmark\n\n");
+
+    if (create_files() != 0)
+    {
+        printf("Failed to create files\n");
+        wait_forever();
+    }
+
+    bench("readdir()", false, false);
+
+    fatSetDirCacheSize(0);
+    bench("readdir() + stat()", true, false);
+
+    fatSetDirCacheSize(8192);
+    bench("readdir() + stat(), cache", true, false);
+    bench("Same, second time", true, false);
+    fatSetDirCacheSize(0);
+
+    bench("fatReadDirStat()", false, true);
+
+    printf("\nPress START to exit\n");
+
+    wait_forever();
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Writes a big file to the default FAT drive (SD card or flash cartridge) in
+// chunks, like a game that records a video or streams data to a save file. It
+// measures the average speed and the slowest chunk, with and without
+// fatPreallocate().
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fat.h>
+#include <nds.h>
+
+#define FILE_NAME       "libnds_bench_write.bin"
+#define FILE_SIZE       (8 * 1024 * 1024)
+#define CHUNK_SIZE      (32 * 1024)
+
+static u8 chunk[CHUNK_SIZE] ALIGN(32);
+
+static void wait_forever(void)
+{
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            exit(0);
+    }
+}
+
+static void bench(const char *name, bool preallocate, size_t chunk_size)
+{
+    int fd = open(FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+    {
+        printf("%s: open() failed\n", name);
+        return;
+    }
+
+    if (preallocate && (fatPreallocate(fd, FILE_SIZE) != 0))
+    {
+        printf("%s: fatPreallocate() failed\n", name);
+        close(fd);
+        return;
+    }
+
+    u32 slowest = 0;
+    u32 total = 0;
+
+    for (size_t offset = 0; offset < FILE_SIZE; offset += chunk_size)
+    {
+        cpuStartTiming(0);
+
+        ssize_t ret = write(fd, chunk, chunk_size);
+
+        u32 ticks = cpuEndTiming();
+
+        if (ret != (ssize_t)chunk_size)
+        {
+            printf("%s: write() failed\n", name);
+            close(fd);
+            return;
+        }
+
+        total += ticks;
+        if (ticks > slowest)
+            slowest = ticks;
+    }
+
+    cpuStartTiming(0);
+
+    // Set the final size of the file, as expected by fatPreallocate()
+    if (preallocate)
+        ftruncate(fd, FILE_SIZE);
+    close(fd);
+
+    u32 close_ticks = cpuEndTiming();
+
+    unsigned long ms = timerTicks2msec(total);
+    if (ms == 0)
+        ms = 1;
+
+    printf("%s\n", name);
+    printf("  %lu KB/s, slowest %lu ms\n",
+           (unsigned long)(FILE_SIZE / 1024) * 1000 / ms,
+           (unsigned long)timerTicks2msec(slowest));
+    printf("  Close: %lu ms\n", (unsigned long)timerTicks2msec(close_ticks));
+
+    unlink(FILE_NAME);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    consoleDemoInit();
+
+    if (!fatInitDefault())
+    {
+        printf("fatInitDefault() failed\n");
+        wait_forever();
+    }
+
+    for (size_t i = 0; i < sizeof(chunk); i++)
+        chunk[i] = i;
+
+    printf("FAT write benchmark\n");
+    printf("%d KB in chunks\n\n", FILE_SIZE / 1024);
+
+    bench("32 KB chunks", false, CHUNK_SIZE);
+    bench("32 KB, preallocated", true, CHUNK_SIZE);
+    bench("4 KB chunks", false, 4 * 1024);
+    bench("4 KB, preallocated", true, 4 * 1024);
+    bench("512 B chunks", false, 512);
+    bench("512 B, preallocated", true, 512);
+
+    printf("\nPress START to exit\n");
+
+    wait_forever();
+
+    return 0;
+}
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Two cooperative threads stream a file each, like a game that streams music
+// and level data at the same time. The streams are read one after the other,
+// at the same time from different drives (DSi SD and flashcart), and at the
+// same time from the same drive. When the drives can be used in parallel, the
+// time of the second case is lower than the time of the first one.
+//
+// It needs a DSi in DSi mode with a flashcart that has a DLDI driver. If
+// there's only one drive, only the same drive case is tested.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fat.h>
+#include <nds.h>
+
+#define FILE_SIZE       (2 * 1024 * 1024)
+#define CHUNK_SIZE      (16 * 1024)
+#define STACK_SIZE      (16 * 1024)
+
+typedef struct
+{
+    char path[64];
+    u8 *buffer;
+    u32 ticks;  // Time at which the stream has finished
+    bool ok;
+} stream_t;
+
+static stream_t streams[2];
+
+static void wait_forever(void)
+{
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            exit(0);
+    }
+}
+
+static bool create_file(const char *path, u8 *buffer)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return false;
+
+    for (size_t i = 0; i < CHUNK_SIZE; i++)
+        buffer[i] = i;
+
+    bool ok = true;
+    for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+    {
+        if (write(fd, buffer, CHUNK_SIZE) != CHUNK_SIZE)
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    close(fd);
+    return ok;
+}
+
+static int stream_thread(void *arg)
+{
+    stream_t *s = arg;
+
+    s->ok = false;
+
+    int fd = open(s->path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+    {
+        if (read(fd, s->buffer, CHUNK_SIZE) != CHUNK_SIZE)
+        {
+            close(fd);
+            return -1;
+        }
+
+        // Let the other stream run, like a game that reads one chunk per frame
+        cothread_yield();
+    }
+
+    close(fd);
+
+    s->ticks = cpuGetTiming();
+    s->ok = true;
+
+    return 0;
+}
+
+static void print_result(const char *name, u32 ticks)
+{
+    unsigned long ms = timerTicks2msec(ticks);
+    if (ms == 0)
+        ms = 1;
+
+    printf("%s\n", name);
+    printf("  %lu ms, %lu KB/s\n", ms,
+           (unsigned long)(2 * FILE_SIZE / 1024) * 1000 / ms);
+}
+
+static void bench_sequential(const char *name)
+{
+    cpuStartTiming(0);
+
+    stream_thread(&streams[0]);
+    stream_thread(&streams[1]);
+
+    u32 ticks = cpuEndTiming();
+
+    if (!streams[0].ok || !streams[1].ok)
+    {
+        printf("%s: read failed\n", name);
+        return;
+    }
+
+    print_result(name, ticks);
+}
+
+static void bench_concurrent(const char *name)
+{
+    cpuStartTiming(0);
+
+    cothread_t a = cothread_create(stream_thread, &streams[0], STACK_SIZE, 0);
+    cothread_t b = cothread_create(stream_thread, &streams[1], STACK_SIZE, 0);
+    if ((a == -1) || (b == -1))
+    {
+        printf("%s: can't create threads\n", name);
+        wait_forever();
+    }
+
+    while (!cothread_has_joined(a) || !cothread_has_joined(b))
+        cothread_yield();
+
+    u32 ticks = cpuEndTiming();
+
+    cothread_delete(a);
+    cothread_delete(b);
+
+    if (!streams[0].ok || !streams[1].ok)
+    {
+        printf("%s: read failed\n", name);
+        return;
+    }
+
+    print_result(name, ticks);
+    printf("  Finished at %lu / %lu ms\n",
+           (unsigned long)timerTicks2msec(streams[0].ticks),
+           (unsigned long)timerTicks2msec(streams[1].ticks));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    consoleDemoInit();
+
+    if (!fatInitDefault())
+    {
+        printf("fatInitDefault() failed\n");
+        wait_forever();
+    }
+
+    streams[0].buffer = malloc(CHUNK_SIZE);
+    streams[1].buffer = malloc(CHUNK_SIZE);
+    if ((streams[0].buffer == NULL) || (streams[1].buffer == NULL))
+    {
+        printf("Not enough memory\n");
+        wait_forever();
+    }
+
+    printf("Filesystem concurrency\n");
+    printf("2 x %d KB in %d KB chunks\n\n", FILE_SIZE / 1024, CHUNK_SIZE / 1024);
+
+    // Create one file in each drive that can be written
+    const char *drives[] = { "sd:/", "fat:/" };
+    const char *found[2];
+    int num_drives = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "%slibnds_bench_stream.bin", drives[i]);
+
+        if (create_file(path, streams[0].buffer))
+            found[num_drives++] = drives[i];
+    }
+
+    if (num_drives == 0)
+    {
+        printf("Can't create files\n");
+        wait_forever();
+    }
+
+    if (num_drives == 2)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            snprintf(streams[i].path, sizeof(streams[i].path),
+                     "%slibnds_bench_stream.bin", found[i]);
+        }
+
+        printf("Drives: %s and %s\n\n", found[0], found[1]);
+
+        bench_sequential("Different drives, one by one");
+        bench_concurrent("Different drives, concurrent");
+    }
+    else
+    {
+        printf("Only %s is available\n\n", found[0]);
+    }
+
+    // Both streams from the same drive, from two different files
+    char copy[64];
+    snprintf(copy, sizeof(copy), "%slibnds_bench_stream2.bin", found[0]);
+    if (!create_file(copy, streams[0].buffer))
+    {
+        printf("Can't create %s\n", copy);
+        wait_forever();
+    }
+
+    snprintf(streams[0].path, sizeof(streams[0].path),
+             "%slibnds_bench_stream.bin", found[0]);
+    snprintf(streams[1].path, sizeof(streams[1].path), "%s", copy);
+
+    bench_sequential("Same drive, one by one");
+    bench_concurrent("Same drive, concurrent");
+
+    for (int i = 0; i < num_drives; i++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "%slibnds_bench_stream.bin", found[i]);
+        unlink(path);
+    }
+    unlink(copy);
+
+    printf("\nPress START to exit\n");
+
+    wait_forever();
+
+    return 0;
+}
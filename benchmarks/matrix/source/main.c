@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Compares the CPU matrix functions of nds/arm9/matrix.h with the equivalent
+// operations done by the geometry engine and read back with glGetFixed() or
+// the position test.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nds.h>
+#include <nds/arm9/postest.h>
+
+#define NUM_MATRICES    256
+#define NUM_VERTICES    1024
+#define NUM_BONES       16
+
+static m4x3 mat_a[NUM_MATRICES];
+static m4x3 mat_b[NUM_MATRICES];
+static m4x3 mat_out[NUM_MATRICES];
+
+static v16 vtx_in[NUM_VERTICES * 3];
+static v16 vtx_out[NUM_VERTICES * 3];
+static uint8_t vtx_bone[NUM_VERTICES];
+
+static int32_t random_f32(void)
+{
+    // Values between -1.0 and 1.0
+    return (rand() & 0x1FFF) - 0x1000;
+}
+
+static void random_matrix(m4x3 *m)
+{
+    for (int i = 0; i < 9; i++)
+        m->m[i] = random_f32();
+
+    for (int i = 9; i < 12; i++)
+        m->m[i] = random_f32() * 4;
+}
+
+static unsigned long usec(u32 ticks)
+{
+    return timerTicks2usec(ticks);
+}
+
+static void bench_mult(void)
+{
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_MATRICES; i++)
+        matrixMult4x3(&mat_out[i], &mat_a[i], &mat_b[i]);
+
+    u32 cpu = cpuEndTiming();
+
+    int mismatches = 0;
+
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_MATRICES; i++)
+    {
+        int pos[16];
+
+        glMatrixMode(GL_MODELVIEW);
+        glLoadMatrix4x3(&mat_b[i]);
+        glMultMatrix4x3(&mat_a[i]);
+        glGetFixed(GL_GET_MATRIX_POSITION, pos);
+
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                if (pos[row * 4 + col] != mat_out[i].m[row * 3 + col])
+                    mismatches++;
+            }
+        }
+    }
+
+    u32 hw = cpuEndTiming();
+
+    printf("Mult 4x3 (x%d)\n", NUM_MATRICES);
+    printf("  CPU: %6lu us\n", usec(cpu));
+    printf("  HW:  %6lu us\n", usec(hw));
+    printf("  Different values: %d\n", mismatches);
+}
+
+static void bench_inverse(void)
+{
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_MATRICES; i++)
+        matrixInverse4x3(&mat_out[i], &mat_a[i]);
+
+    u32 cpu = cpuEndTiming();
+
+    printf("Inverse 4x3 (x%d)\n", NUM_MATRICES);
+    printf("  CPU: %6lu us\n", usec(cpu));
+}
+
+static void bench_transform(void)
+{
+    cpuStartTiming(0);
+
+    matrixTransform4x3(&mat_a[0], vtx_in, vtx_out, NUM_VERTICES);
+
+    u32 cpu = cpuEndTiming();
+
+    // The position test multiplies the vertex by the clip matrix. With an
+    // identity projection matrix that's the same as the modelview matrix.
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrix4x3(&mat_a[0]);
+
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_VERTICES; i++)
+    {
+        PosTest(vtx_in[i * 3 + 0], vtx_in[i * 3 + 1], vtx_in[i * 3 + 2]);
+        vtx_out[i * 3 + 0] = PosTestXresult();
+        vtx_out[i * 3 + 1] = PosTestYresult();
+        vtx_out[i * 3 + 2] = PosTestZresult();
+    }
+
+    u32 hw = cpuEndTiming();
+
+    printf("Transform (x%d)\n", NUM_VERTICES);
+    printf("  CPU: %6lu us\n", usec(cpu));
+    printf("  HW:  %6lu us\n", usec(hw));
+}
+
+static void bench_skin(void)
+{
+    cpuStartTiming(0);
+
+    matrixSkin4x3(mat_a, vtx_bone, vtx_in, vtx_out, NUM_VERTICES);
+
+    u32 cpu = cpuEndTiming();
+
+    // The hardware path loads the matrix of the bone of each vertex before
+    // using the position test with it.
+    glMatrixMode(GL_MODELVIEW);
+
+    cpuStartTiming(0);
+
+    for (int i = 0; i < NUM_VERTICES; i++)
+    {
+        glLoadMatrix4x3(&mat_a[vtx_bone[i]]);
+        PosTest(vtx_in[i * 3 + 0], vtx_in[i * 3 + 1], vtx_in[i * 3 + 2]);
+        vtx_out[i * 3 + 0] = PosTestXresult();
+        vtx_out[i * 3 + 1] = PosTestYresult();
+        vtx_out[i * 3 + 2] = PosTestZresult();
+    }
+
+    u32 hw = cpuEndTiming();
+
+    printf("Skinning, %d bones (x%d)\n", NUM_BONES, NUM_VERTICES);
+    printf("  CPU: %6lu us\n", usec(cpu));
+    printf("  HW:  %6lu us\n", usec(hw));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    videoSetMode(MODE_0_3D);
+    glInit();
+
+    consoleDemoInit();
+
+    srand(1234);
+
+    for (int i = 0; i < NUM_MATRICES; i++)
+    {
+        random_matrix(&mat_a[i]);
+        random_matrix(&mat_b[i]);
+    }
+
+    for (int i = 0; i < NUM_VERTICES; i++)
+    {
+        vtx_in[i * 3 + 0] = random_f32();
+        vtx_in[i * 3 + 1] = random_f32();
+        vtx_in[i * 3 + 2] = random_f32();
+        vtx_bone[i] = rand() % NUM_BONES;
+    }
+
+    printf("Matrix benchmark\n\n");
+
+    bench_mult();
+    bench_inverse();
+    bench_transform();
+    bench_skin();
+
+    printf("\nPress START to exit\n");
+
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            break;
+    }
+
+    return 0;
+}
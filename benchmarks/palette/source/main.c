@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Measures the palette effects of nds/arm9/palette.h and compares the packed
+// blend routines with a straightforward loop that blends one color component
+// at a time.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nds.h>
+
+#define EXT_COLORS      4096
+#define REPETITIONS     32
+
+static u16 source_pal[EXT_COLORS];
+static u16 target_pal[EXT_COLORS];
+static u16 reference[EXT_COLORS];
+
+static unsigned long usec(u32 ticks)
+{
+    return timerTicks2usec(ticks);
+}
+
+// Blends each component of each color on its own
+static void reference_blend(u16 *dst, const u16 *src, const u16 *target,
+                            int count, int factor)
+{
+    for (int i = 0; i < count; i++)
+    {
+        u16 a = src[i];
+        u16 b = target[i];
+        u16 out = 0;
+
+        for (int shift = 0; shift < 15; shift += 5)
+        {
+            int ca = (a >> shift) & 31;
+            int cb = (b >> shift) & 31;
+            out |= ((ca * (PAL_BLEND_MAX - factor) + cb * factor) >> 5) << shift;
+        }
+
+        dst[i] = out;
+    }
+}
+
+static int count_mismatches(int count)
+{
+    // The shadow palette isn't accessible, so compare what ends up in palette
+    // RAM after a commit.
+    const u16 *hw = BG_PALETTE;
+    int mismatches = 0;
+
+    palCommit();
+
+    for (int i = 0; i < count; i++)
+    {
+        if (hw[i] != reference[i])
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+static void bench_fade(int colors)
+{
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        reference_blend(reference, source_pal, target_pal, colors, r);
+
+    u32 ref = cpuEndTiming();
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        palBlend(PalId_BgMain, 0, colors, RGB15(0, 0, 0), r);
+
+    u32 lib = cpuEndTiming();
+
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        palBlendPalette(PalId_BgMain, 0, colors, target_pal, r);
+
+    u32 lib_pal = cpuEndTiming();
+
+    // The last blends of both loops use the same factor and target palette
+    int mismatches = count_mismatches(colors);
+
+    printf("Blend %d colors (x%d)\n", colors, REPETITIONS);
+    printf("  Per component:  %6lu us\n", usec(ref));
+    printf("  palBlend:       %6lu us\n", usec(lib));
+    printf("  palBlendPalette:%6lu us\n", usec(lib_pal));
+    printf("  Different colors: %d\n", mismatches);
+}
+
+static void bench_ext_fade(void)
+{
+    palInit(PalId_BgExtMain, 0);
+    palSet(PalId_BgExtMain, 0, source_pal, EXT_COLORS);
+
+    cpuStartTiming(0);
+
+    palBlend(PalId_BgExtMain, 0, 4 * EXT_COLORS, RGB15(31, 31, 31), 16);
+
+    u32 blend = cpuEndTiming();
+
+    vramSetBankE(VRAM_E_BG_EXT_PALETTE);
+
+    cpuStartTiming(0);
+
+    palCommit();
+
+    u32 commit = cpuEndTiming();
+
+    palDeinit(PalId_BgExtMain);
+
+    printf("Extended BG palettes (%d colors)\n", 4 * EXT_COLORS);
+    printf("  palBlend:       %6lu us\n", usec(blend));
+    printf("  palCommit:      %6lu us\n", usec(commit));
+}
+
+static void bench_cycle(void)
+{
+    cpuStartTiming(0);
+
+    for (int r = 0; r < REPETITIONS; r++)
+        palCycle(PalId_BgMain, 16, 64, r);
+
+    u32 cycle = cpuEndTiming();
+
+    cpuStartTiming(0);
+
+    palCommit();
+
+    u32 commit_small = cpuEndTiming();
+
+    palRestore(PalId_BgMain, 0, 256);
+
+    cpuStartTiming(0);
+
+    palCommit();
+
+    u32 commit_full = cpuEndTiming();
+
+    printf("Cycle 64 colors (x%d)\n", REPETITIONS);
+    printf("  palCycle:       %6lu us\n", usec(cycle));
+    printf("Commit\n");
+    printf("  64 colors:      %6lu us\n", usec(commit_small));
+    printf("  256 colors:     %6lu us\n", usec(commit_full));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    // The console uses the sub screen, so the main BG palette can be modified
+    videoSetMode(MODE_0_2D);
+    consoleDemoInit();
+
+    srand(1234);
+
+    for (int i = 0; i < EXT_COLORS; i++)
+    {
+        source_pal[i] = rand() & 0x7FFF;
+        target_pal[i] = rand() & 0x7FFF;
+    }
+
+    palInit(PalId_BgMain, 256);
+    palSet(PalId_BgMain, 0, source_pal, 256);
+
+    printf("Palette benchmark\n\n");
+
+    bench_fade(256);
+    bench_cycle();
+    bench_ext_fade();
+
+    palDeinit(PalId_BgMain);
+
+    printf("\nPress START to exit\n");
+
+    while (1)
+    {
+        swiWaitForVBlank();
+
+        scanKeys();
+        if (keysDown() & KEY_START)
+            break;
+    }
+
+    return 0;
+}
@@ -13,10 +13,13 @@
 extern "C" {
 #endif
 
+#include <dirent.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/stat.h>
 
+#include <nds/disc_io.h>
 #include <nds/ndstypes.h>
 
 /// This function calls fatInit() with the default cache size (5 pages = 20 KB).
@@ -41,6 +44,11 @@ bool fatInitDefault(void);
 /// DSi. On the DSi it is possible to switch between both filesystems with
 /// `chdir()`.
 ///
+/// FAT12, FAT16, FAT32 and exFAT filesystems are supported. The partition
+/// table of the card must be MBR (or there must be no partition table), GPT
+/// isn't supported. Note that off_t is 32-bit, so lseek() and stat() can't
+/// handle files of 2 GB or more, even if exFAT supports them.
+///
 /// This function can be called multiple times, only the first one has any
 /// effect. Any call after the first one returns the value returned the first
 /// time.
@@ -57,6 +65,32 @@ bool fatInitDefault(void);
 WARN_UNUSED_RESULT
 bool fatInit(int32_t cache_size_pages, bool set_as_default_device);
 
+/// Replaces the DLDI driver used by "fat:" by a different driver.
+///
+/// This lets the FAT filesystem run on top of any storage: a RAM disk, a disk
+/// image stored in a file, or a wrapper of the real DLDI driver that adds
+/// simulated latency to each command. This is useful to test and measure
+/// changes that affect filesystem performance in a reproducible way. The
+/// commands sent to the driver are counted by fsStatsGetDrive() as if it was
+/// the DLDI driver.
+///
+/// If it's called before fatInit(), fatInit() mounts "fat:" with the new
+/// driver. If it's called after fatInit(), "fat:" is unmounted, the previous
+/// driver is shut down and the volume is mounted again with the new driver, so
+/// the driver can be replaced as many times as needed. All files and
+/// directories of "fat:" must be closed before doing this (they can't be used
+/// after the volume is mounted again), and the current directory of "fat:" is
+/// reset to the root. The DSi SD and NAND drives aren't affected.
+///
+/// @param io
+///     Driver to use, or NULL to use the DLDI driver again. It must stay valid
+///     while the filesystem is mounted.
+///
+/// @return
+///     0 on success, -1 if "fat:" can't be mounted with the new driver (errno
+///     is set to the error code).
+int fatSetDiscInterface(const DISC_INTERFACE *io);
+
 /// This function mounts the DSi nand if not already mounted by fatInit.
 ///
 /// @warning
@@ -130,6 +164,132 @@ static inline int fatInitLookupCacheFile(FILE *file, uint32_t max_buffer_size)
 #define FAT_INIT_LOOKUP_CACHE_OUT_OF_MEMORY     -2
 #define FAT_INIT_LOOKUP_CACHE_ALREADY_ALLOCATED -3
 
+/// Enables or disables automatic lookup caches for FAT files.
+///
+/// When this is enabled, files opened in read-only mode whose size is at least
+/// the specified minimum get a lookup cache of the exact size they need, like
+/// the one created by fatInitLookupCache(). This makes random access to big
+/// files (like asset packs) much faster.
+///
+/// The memory used by all the automatic caches is limited. If there isn't
+/// enough space for a new cache, the caches of the files that have been used
+/// least recently are freed (those files keep working normally, just without a
+/// cache).
+///
+/// If fatInitLookupCache() is called for a file that already has an automatic
+/// cache, the cache is kept and it is never freed until the file is closed.
+/// That's also the case of the file used by NitroFS when the ROM is read from
+/// the SD card or a flashcard, as long as this mode is enabled before calling
+/// nitroFSInit().
+///
+/// Automatic caches are disabled by default.
+///
+/// @param min_file_size
+///     Minimum size of a file to get a lookup cache, in bytes.
+/// @param memory_budget
+///     Maximum memory used by all the automatic caches, in bytes. Use 0 to
+///     disable them and free the ones that have been created.
+void fatSetAutoLookupCache(uint32_t min_file_size, size_t memory_budget);
+
+/// Enables or disables the maps of free clusters of FAT filesystems.
+///
+/// When this is enabled, a thread is created for each mounted FAT16 or FAT32
+/// volume after fatInit() (or right away, if it has already been called). It
+/// reads the FAT in small batches and builds a bitmap of the free clusters of
+/// the volume. This happens in the background while the application yields to
+/// other threads (for example, by calling cothread_yield_irq(IRQ_VBLANK) in the
+/// main loop instead of swiWaitForVBlank()).
+///
+/// Once the map of a volume is ready:
+///
+/// - statvfs() returns the free space right away, even in FAT32 cards that
+///   don't have a valid FSINFO sector (FatFs would scan the whole FAT the first
+///   time it's called).
+/// - Writes that need new clusters start the search at a cluster that is known
+///   to be free, which is much faster in cards that are almost full.
+///
+/// The map is kept up to date by looking at all the writes to the FAT. It uses
+/// one bit per cluster: 128 KB for a 32 GB card with 32 KB clusters.
+///
+/// @param enable
+///     true to enable the maps, false to disable them and free their memory.
+///
+/// @return
+///     0 on success, -1 on error (and errno is set).
+int fatSetFreeClusterMap(bool enable);
+
+/// Allocates contiguous space for a FAT file before writing to it.
+///
+/// This is useful for files that are written progressively and need a high
+/// sustained write speed, like audio or video recordings. Without it, FatFs
+/// needs to update the FAT every time the file grows, and the file may end up
+/// being fragmented.
+///
+/// The file must be empty and opened for writing. After calling this function
+/// its size is set to the specified size, but its contents are undefined. Use
+/// ftruncate() to set the final size of the file once all the data has been
+/// written.
+///
+/// While the file remains open, writes of whole sectors at sector-aligned
+/// offsets (multiples of 512 bytes) inside the allocated area are sent straight
+/// to the storage device, without going through FatFs. If you use a FILE
+/// pointer, call setvbuf() to make its buffer a multiple of 512 bytes.
+///
+/// @param fd
+///     The file descriptor of the file. Use fileno(file) for FILE * inputs.
+/// @param size
+///     The size to allocate, in bytes.
+///
+/// @return
+///     0 on success, -1 on error (and errno is set). It fails if there isn't
+///     a block of contiguous free space big enough.
+int fatPreallocate(int fd, off_t size);
+
+static inline int fatPreallocateFile(FILE *file, off_t size)
+{
+    return fatPreallocate(fileno(file), size);
+}
+
+/// Sets the size of the cache of directory entries of FAT filesystems.
+///
+/// stat() needs to read all the directories in the path of a file every time
+/// it's called. This cache stores the information of the entries that have
+/// been found by stat() and readdir(), so that calling stat() for a file that
+/// has just been found by readdir() doesn't need to access the filesystem.
+///
+/// Only absolute paths that include the drive name (like "sd:/data/file.bin")
+/// are cached. Any operation that modifies the filesystem clears the cache.
+///
+/// The cache is disabled by default. Each entry uses 32 bytes plus the length
+/// of the path.
+///
+/// @param entries
+///     Number of entries of the cache (it's rounded up to a power of two). Use
+///     0 to disable the cache and free its memory.
+///
+/// @return
+///     0 on success, -1 if there isn't enough memory.
+int fatSetDirCacheSize(size_t entries);
+
+/// Reads the next entry of a directory and gets its information.
+///
+/// This is the same as calling readdir() and then stat() with the path of the
+/// entry, but it's a lot faster in FAT filesystems because the information is
+/// obtained while the directory is read. It works with FAT and NitroFS. Other
+/// filesystems need to implement readdir_stat() in their device_io_t.
+///
+/// @param dirp
+///     Directory opened with opendir().
+/// @param st
+///     Structure to be filled with the information of the entry.
+///
+/// @return
+///     The same as readdir(). On error it sets errno. If the size of the file
+///     doesn't fit in st_size (files of 2 GiB or more in exFAT volumes) it
+///     returns NULL and sets errno to EOVERFLOW, but the next call continues
+///     with the following entry.
+struct dirent *fatReadDirStat(DIR *dirp, struct stat *st);
+
 // FAT file attributes
 #define ATTR_ARCHIVE    0x20 ///< Archive
 #define ATTR_DIRECTORY  0x10 ///< Directory
@@ -146,7 +306,8 @@ static inline int fatInitLookupCacheFile(FILE *file, uint32_t max_buffer_size)
 ///    Volume name, such as "fat:" or "sd:".
 /// @param label
 ///    Buffer to store the volume label. This buffer should be at least
-///    FAT_VOLUME_LABEL_MAX+1 bytes in size.
+///    FAT_VOLUME_LABEL_MAX+1 bytes in size. Labels of exFAT volumes can have
+///    11 characters of any language, which can take up to 33 bytes in UTF-8.
 ///
 /// @return
 ///    True on success, false on error.
@@ -53,6 +53,10 @@ bool nitroFSExit(void);
 /// This function will return 0 on non-DLDI/SD NitroFS accesses, as lookup
 /// caches are unnecessary in these situations.
 ///
+/// If automatic lookup caches are enabled with fatSetAutoLookupCache() before
+/// calling nitroFSInit(), the NitroFS file gets a cache of the right size when
+/// it's opened, and this function keeps it.
+///
 /// @param max_buffer_size
 ///     The maximum buffer size, in bytes.
 ///
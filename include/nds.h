@@ -18,13 +18,24 @@
 /// @section video_2D_api 2D engine API
 /// - @ref nds/arm9/video.h "General video"
 /// - @ref nds/arm9/background.h "2D Background Layers"
+/// - @ref nds/arm9/bgStream.h "Streaming of large background maps"
+/// - @ref nds/arm9/blit.h "Software 2D drawing on bitmaps"
+/// - @ref nds/arm9/palette.h "Palette fades and color cycling"
+/// - @ref nds/arm9/raster.h "Per-scanline effects"
 /// - @ref nds/arm9/sprite.h "2D Sprites"
+/// - @ref nds/arm9/spriteCache.h "Sprite animation frame cache"
+/// - @ref nds/arm9/spriteMux.h "Sprite multiplexer"
+/// - @ref nds/arm9/tilePool.h "Runtime tile deduplication"
 /// - @ref nds/arm9/window.h "Sprite and background windows"
 ///
 /// @section video_3D_api 3D engine API
 /// - @ref nds/arm9/videoGL.h "OpenGL (ish)"
 /// - @ref nds/arm9/boxtest.h "Box Test"
 /// - @ref nds/arm9/postest.h "Position test"
+/// - @ref nds/arm9/glProfiler.h "3D engine frame profiler"
+/// - @ref nds/arm9/glMesh.h "Compact display list encoder"
+/// - @ref nds/arm9/glTransQueue.h "Depth-sorted translucent draw queue"
+/// - @ref nds/arm9/videoCapture.h "Dual-screen 3D and render-to-texture"
 /// - @ref gl2d.h "GL2D: 2D graphics using 3D"
 ///
 /// @section audio_api Audio API
@@ -32,6 +43,7 @@
 ///
 /// @section math_api Math
 /// - @ref nds/arm9/math.h "Hardware Assisted Math"
+/// - @ref nds/arm9/matrix.h "Fixed point matrix functions"
 /// - @ref nds/arm9/trig_lut.h "Fixed point trigonometry functions"
 ///
 /// @section memory_api Memory
@@ -47,6 +59,7 @@
 /// - @ref fat.h "Simple replacement of libfat"
 /// - @ref filesystem.h "NitroFS, filesystem embedded in a NDS ROM"
 /// - @ref nds/arm9/device_io.h "Support for custom user-implemented filesystems."
+/// - @ref nds/arm9/fsStats.h "Filesystem I/O statistics and tracing"
 /// - @ref nds/arm9/sdmmc.h "ARM9 SDMMC Module"
 /// - @ref nds/arm7/nand_crypto.h "ARM7 Low-level NAND cryptographic helper functions"
 ///
@@ -165,29 +178,42 @@ extern "C" {
 
 #ifdef ARM9
 #    include <nds/arm9/background.h>
+#    include <nds/arm9/bgStream.h>
+#    include <nds/arm9/blit.h>
 #    include <nds/arm9/boxtest.h>
 #    include <nds/arm9/cache.h>
 #    include <nds/arm9/camera.h>
 #    include <nds/arm9/console.h>
 #    include <nds/arm9/dynamicArray.h>
+#    include <nds/arm9/fsStats.h>
+#    include <nds/arm9/glMesh.h>
+#    include <nds/arm9/glProfiler.h>
+#    include <nds/arm9/glTransQueue.h>
 #    include <nds/arm9/guitarGrip.h>
 #    include <nds/arm9/image.h>
 #    include <nds/arm9/input.h>
 #    include <nds/arm9/keyboard.h>
 #    include <nds/arm9/linkedlist.h>
 #    include <nds/arm9/math.h>
+#    include <nds/arm9/matrix.h>
 #    include <nds/arm9/ndsmotion.h>
 #    include <nds/arm9/paddle.h>
+#    include <nds/arm9/palette.h>
 #    include <nds/arm9/grf.h>
 #    include <nds/arm9/pcx.h>
 #    include <nds/arm9/piano.h>
+#    include <nds/arm9/raster.h>
 #    include <nds/arm9/rumble.h>
 #    include <nds/arm9/sassert.h>
 #    include <nds/arm9/sdmmc.h>
 #    include <nds/arm9/sound.h>
 #    include <nds/arm9/sprite.h>
+#    include <nds/arm9/spriteCache.h>
+#    include <nds/arm9/spriteMux.h>
+#    include <nds/arm9/tilePool.h>
 #    include <nds/arm9/trig_lut.h>
 #    include <nds/arm9/video.h>
+#    include <nds/arm9/videoCapture.h>
 #    include <nds/arm9/videoGL.h>
 #    include <nds/arm9/window.h>
 #    include <nds/arm9/peripherals/slot2.h>
@@ -531,6 +531,9 @@ bool bgIsText(int id);
 
 /// Must be called once per frame to update scroll/scale/and rotation of
 /// backgrounds.
+///
+/// If the shadow registers are enabled, it also publishes them so that
+/// bgShadowCommit() copies them to the hardware.
 void bgUpdate(void);
 
 /// Sets the rotation angle of the specified background and updates the transform matrix.
@@ -776,6 +779,18 @@ vuint16 *bgSetControlBits(int id, u16 bits);
 ///     Bits to clear in the background control register.
 void bgClearControlBits(int id, u16 bits);
 
+/// Returns the value of the control register of a background.
+///
+/// If the shadow registers are enabled, it returns the value of the shadow
+/// register, which may not have been copied to the hardware yet.
+///
+/// @param id
+///     Background ID returned from bgInit or bgInitSub.
+///
+/// @return
+///     The value of the control register.
+u16 bgGetControl(int id);
+
 /// Turns ON wrap for a background.
 ///
 /// It has no effect on text backgrounds, which are always wrapped.
@@ -862,7 +877,7 @@ static inline void bgSetScroll(int id, int x, int y)
 ///     Background ID returned from bgInit or bgInitSub.
 static inline void bgMosaicEnable(int id)
 {
-    *bgControl[id] |= BIT(6);
+    bgSetControlBits(id, BIT(6));
 }
 
 /// Disables mosaic on the specified background.
@@ -871,7 +886,7 @@ static inline void bgMosaicEnable(int id)
 ///     Background ID returned from bgInit or bgInitSub.
 static inline void bgMosaicDisable(int id)
 {
-    *bgControl[id] &= ~BIT(6);
+    bgClearControlBits(id, BIT(6));
 }
 
 /// Sets the horizontal and vertical mosaic values for all backgrounds.
@@ -900,7 +915,7 @@ void bgSetMosaicSub(unsigned int dx, unsigned int dy);
 ///     Background priority.
 static inline int bgGetPriority(int id)
 {
-    return *bgControl[id] & 3;
+    return bgGetControl(id) & 3;
 }
 
 /// Gets the current map base for the supplied background.
@@ -915,7 +930,7 @@ static inline int bgGetPriority(int id)
 ///     This is the integer offset of the base not a pointer to the map.
 static inline int bgGetMapBase(int id)
 {
-    return (*bgControl[id] >> MAP_BASE_SHIFT) & 31;
+    return (bgGetControl(id) >> MAP_BASE_SHIFT) & 31;
 }
 
 /// Gets the background tile base.
@@ -927,7 +942,7 @@ static inline int bgGetMapBase(int id)
 ///     Background tile base.
 static inline int bgGetTileBase(int id)
 {
-    return (*bgControl[id] >> TILE_BASE_SHIFT) & 15;
+    return (bgGetControl(id) >> TILE_BASE_SHIFT) & 15;
 }
 
 /// Gets a pointer to the background map.
@@ -1052,6 +1067,40 @@ static inline void bgSetCenter(int id, int x, int y)
 void bgSetAffineMatrixScroll(int id, int hdx, int vdx, int hdy, int vdy,
                              int scrollx, int scrolly);
 
+/// Redirects all background register writes to shadow registers.
+///
+/// While the shadow registers are enabled, all functions of this file write the
+/// control, scroll and affine registers of the backgrounds of both engines to
+/// a copy in main RAM instead of the hardware registers.
+///
+/// The shadow registers are double-buffered. bgUpdate() publishes the values
+/// written since the previous call, and bgShadowCommit() copies the last
+/// published values to the hardware during VBlank. The background functions
+/// can be called at any point of the frame: the changes become visible at the
+/// same time, in the first VBlank after the next call to bgUpdate(), and a
+/// VBlank that happens while they are being written doesn't show a mix of old
+/// and new values.
+///
+/// The control registers are initialized with their current hardware values,
+/// and the scroll and affine registers are generated from the state of the
+/// backgrounds. Registers written directly (for example, REG_BG0CNT) are
+/// overwritten by bgShadowCommit().
+void bgShadowEnable(void);
+
+/// Copies the shadow registers to the hardware and makes background functions
+/// write to the hardware registers again.
+///
+/// The values written since the last call to bgUpdate() are copied as well.
+void bgShadowDisable(void);
+
+/// Copies the published shadow registers to the hardware registers.
+///
+/// It must be called during VBlank, for example from the VBlank interrupt
+/// handler, which can be set with irqSet(IRQ_VBLANK, bgShadowCommit). It does
+/// nothing if the shadow registers aren't enabled or if bgUpdate() hasn't
+/// published new values since the last commit.
+void bgShadowCommit(void);
+
 /// Enable extended palettes (main engine).
 static inline void bgExtPaletteEnable(void)
 {
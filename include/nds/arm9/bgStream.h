@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/bgStream.h
+///
+/// @brief Streaming of maps larger than the hardware maps of text backgrounds.
+///
+/// Text backgrounds can't use maps bigger than 512x512 pixels. This module
+/// binds a bigger virtual map stored in main RAM to a text background, and it
+/// copies to VRAM the parts of the map that become visible when the background
+/// is scrolled.
+///
+/// The hardware map is used as a ring buffer: tile (x, y) of the virtual map
+/// is stored in tile (x % 64, y % h) of the hardware map, where h is 32 or 64.
+/// The scroll registers wrap around in the same way, so the scroll values set
+/// with bgSetScroll() are coordinates in the virtual map. Every time
+/// bgStreamUpdate() is called it copies the columns and rows of tiles that have
+/// become visible since the previous call, so the time it takes is proportional
+/// to the scroll speed rather than to the size of the map.
+///
+/// The hardware map must be 512x256 or 512x512 pixels so that the new columns
+/// and rows are written outside of the visible area. It works with 4 bpp and
+/// 8 bpp backgrounds, with or without extended palettes, as all of them use the
+/// same format of map entries.
+///
+/// Usage:
+///
+/// ```c
+/// int bg = bgInit(0, BgType_Text8bpp, BgSize_T_512x256, 0, 1);
+/// bgStreamInit(bg, levelMap, LEVEL_WIDTH, LEVEL_HEIGHT);
+///
+/// while (1)
+/// {
+///     bgSetScroll(bg, camera_x, camera_y);
+///
+///     swiWaitForVBlank();
+///     bgStreamUpdate();
+///     bgUpdate();
+/// }
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_BGSTREAM_H__
+#define LIBNDS_NDS_ARM9_BGSTREAM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+
+#include <nds/ndstypes.h>
+
+/// Binds a virtual map in main RAM to a text background.
+///
+/// The map isn't copied, so it must remain valid until bgStreamDeinit() is
+/// called. The visible part of the map is copied to VRAM the next time that
+/// bgStreamUpdate() is called.
+///
+/// @param id
+///     Background ID returned by bgInit() or bgInitSub().
+/// @param map
+///     Map entries, stored in rows.
+/// @param width
+///     Width of the map in tiles.
+/// @param height
+///     Height of the map in tiles.
+///
+/// @return
+///     0 on success, -1 on error (the background isn't a 512x256 or 512x512
+///     text background, or the size is invalid).
+int bgStreamInit(int id, const u16 *map, int width, int height);
+
+/// Loads a virtual map from a file and binds it to a text background.
+///
+/// The data must start with a header like the ones used by the decompression
+/// functions of the BIOS. It can be uncompressed (type 0) or compressed with
+/// LZ77, Huffman or RLE. The map is decompressed to main RAM, and it's freed
+/// by bgStreamDeinit().
+///
+/// @param id
+///     Background ID returned by bgInit() or bgInitSub().
+/// @param file
+///     File opened for reading, at the position of the header of the data.
+/// @param width
+///     Width of the map in tiles.
+/// @param height
+///     Height of the map in tiles.
+///
+/// @return
+///     0 on success, -1 on error (invalid background or size, the file can't
+///     be read, unknown compression or not enough memory).
+int bgStreamInitFile(int id, FILE *file, int width, int height);
+
+/// Unbinds the virtual map of a background.
+///
+/// The contents of VRAM aren't modified.
+///
+/// @param id
+///     Background ID.
+void bgStreamDeinit(int id);
+
+/// Copies to VRAM the parts of the virtual maps that have become visible.
+///
+/// It must be called during VBlank, before bgUpdate(), for all backgrounds
+/// with a virtual map.
+void bgStreamUpdate(void);
+
+/// Copies the whole visible area of the virtual map to VRAM during the next
+/// call to bgStreamUpdate().
+///
+/// Use this after modifying many entries of the map in RAM.
+///
+/// @param id
+///     Background ID.
+void bgStreamRefresh(int id);
+
+/// Sets an entry of the virtual map.
+///
+/// It's written to VRAM right away if it's in the area of the map that is
+/// currently loaded, so it's better to call it during VBlank. The map passed
+/// to bgStreamInit() must be writable to use this function.
+///
+/// @param id
+///     Background ID.
+/// @param x
+///     X coordinate in tiles.
+/// @param y
+///     Y coordinate in tiles.
+/// @param entry
+///     New map entry.
+void bgStreamSetTile(int id, int x, int y, u16 entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_BGSTREAM_H__
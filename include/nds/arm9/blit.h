@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/blit.h
+///
+/// @brief Software 2D drawing functions for bitmap backgrounds.
+///
+/// This module draws rectangles, lines and images on 8 bpp and 16 bpp bitmaps,
+/// which can be bitmap backgrounds in VRAM or buffers in main RAM. All
+/// functions clip the drawing to the limits of the surfaces.
+///
+/// VRAM ignores 8-bit writes, so 8 bpp surfaces are written with 16-bit
+/// accesses. The inner loops run from ITCM, and big fills and copies use the
+/// word-set and FIQ copy routines of libnds.
+///
+/// Usage:
+///
+/// ```c
+/// int bg = bgInit(3, BgType_Bmp16, BgSize_B16_256x256, 0, 0);
+///
+/// BlitSurface screen, sprite;
+/// blitSurfaceInitBg(&screen, bg);
+/// blitSurfaceInit(&sprite, spriteBitmap, 32, 32, 32, BlitFormat_8bpp,
+///                 spritePal);
+///
+/// blitFillRect(&screen, 0, 0, 256, 192, RGB15(0, 0, 8) | BIT(15));
+/// blitCopy(&screen, x, y, &sprite, 0, 0, 32, 32, BlitMode_Transparent, 0);
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_BLIT_H__
+#define LIBNDS_NDS_ARM9_BLIT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <nds/ndstypes.h>
+
+/// Pixel formats of surfaces.
+typedef enum
+{
+    BlitFormat_8bpp,    ///< 8-bit palette indices
+    BlitFormat_16bpp    ///< RGB15 colors, bit 15 set for opaque pixels
+} BlitFormat;
+
+/// Ways to combine the source pixels with the destination pixels.
+typedef enum
+{
+    /// Copy all pixels.
+    BlitMode_Opaque,
+    /// Skip transparent pixels: color index 0 in 8 bpp sources, and pixels
+    /// with bit 15 cleared in 16 bpp sources.
+    BlitMode_Transparent,
+    /// Skip pixels equal to the color key (a color index in 8 bpp sources).
+    BlitMode_ColorKey,
+    /// Blend the non-transparent pixels with the destination (the destination
+    /// must be a 16 bpp surface). The parameter is the opacity, from 0 to 31.
+    BlitMode_Alpha
+} BlitMode;
+
+/// Bitmap that can be used as source or destination of drawing functions.
+typedef struct BlitSurface
+{
+    void *pixels;           ///< Pointer to the first pixel
+    int width;              ///< Width in pixels
+    int height;             ///< Height in pixels
+    int stride;             ///< Distance between rows in pixels
+    BlitFormat format;      ///< Pixel format
+    const u16 *palette;     ///< Palette used to copy 8 bpp pixels to 16 bpp surfaces
+} BlitSurface;
+
+/// Initializes a surface.
+///
+/// @param surface
+///     Surface to initialize.
+/// @param pixels
+///     Pointer to the pixels. It must be aligned to 2 bytes.
+/// @param width
+///     Width in pixels.
+/// @param height
+///     Height in pixels.
+/// @param stride
+///     Distance between rows in pixels. It must be even for 8 bpp surfaces.
+/// @param format
+///     Pixel format.
+/// @param palette
+///     Palette of 8 bpp surfaces, used when they are copied to 16 bpp surfaces.
+///     It can be NULL.
+void blitSurfaceInit(BlitSurface *surface, void *pixels, int width, int height,
+                     int stride, BlitFormat format, const u16 *palette);
+
+/// Initializes a surface that draws to a bitmap background.
+///
+/// The palette of 8 bpp backgrounds is set to the background palette of the
+/// engine of the background.
+///
+/// @param surface
+///     Surface to initialize.
+/// @param id
+///     Background ID of a BgType_Bmp8 or BgType_Bmp16 background.
+///
+/// @return
+///     0 on success, -1 if the background isn't a bitmap background.
+int blitSurfaceInitBg(BlitSurface *surface, int id);
+
+/// Sets a pixel.
+///
+/// @param dst
+///     Destination surface.
+/// @param x
+///     X coordinate.
+/// @param y
+///     Y coordinate.
+/// @param color
+///     Color index or RGB15 color.
+void blitPutPixel(const BlitSurface *dst, int x, int y, u16 color);
+
+/// Fills a rectangle with a color.
+///
+/// @param dst
+///     Destination surface.
+/// @param x
+///     Left coordinate.
+/// @param y
+///     Top coordinate.
+/// @param w
+///     Width.
+/// @param h
+///     Height.
+/// @param color
+///     Color index or RGB15 color.
+void blitFillRect(const BlitSurface *dst, int x, int y, int w, int h, u16 color);
+
+/// Draws a horizontal span of pixels.
+///
+/// @param dst
+///     Destination surface.
+/// @param x0
+///     First X coordinate.
+/// @param x1
+///     Last X coordinate (included).
+/// @param y
+///     Y coordinate.
+/// @param color
+///     Color index or RGB15 color.
+void blitSpan(const BlitSurface *dst, int x0, int x1, int y, u16 color);
+
+/// Draws a line.
+///
+/// @param dst
+///     Destination surface.
+/// @param x0
+///     X coordinate of the first point.
+/// @param y0
+///     Y coordinate of the first point.
+/// @param x1
+///     X coordinate of the last point.
+/// @param y1
+///     Y coordinate of the last point.
+/// @param color
+///     Color index or RGB15 color.
+void blitLine(const BlitSurface *dst, int x0, int y0, int x1, int y1, u16 color);
+
+/// Copies a rectangle from a surface to another one.
+///
+/// 8 bpp sources can be copied to 8 bpp and 16 bpp surfaces (using the palette
+/// of the source surface). 16 bpp sources can only be copied to 16 bpp
+/// surfaces. The source and destination can be the same surface, even if the
+/// rectangles overlap.
+///
+/// @param dst
+///     Destination surface.
+/// @param dx
+///     Left coordinate in the destination.
+/// @param dy
+///     Top coordinate in the destination.
+/// @param src
+///     Source surface.
+/// @param sx
+///     Left coordinate in the source.
+/// @param sy
+///     Top coordinate in the source.
+/// @param w
+///     Width of the rectangle.
+/// @param h
+///     Height of the rectangle.
+/// @param mode
+///     How to combine the pixels.
+/// @param param
+///     Color key for BlitMode_ColorKey, opacity for BlitMode_Alpha.
+///
+/// @return
+///     0 on success, -1 if the formats or the mode aren't supported.
+int blitCopy(const BlitSurface *dst, int dx, int dy,
+             const BlitSurface *src, int sx, int sy, int w, int h,
+             BlitMode mode, u16 param);
+
+/// Copies a rectangle from a surface to another one, scaling it.
+///
+/// The scaling uses nearest neighbour sampling. The same format and mode
+/// combinations as in blitCopy() are supported, but the source and destination
+/// must not overlap.
+///
+/// @param dst
+///     Destination surface.
+/// @param dx
+///     Left coordinate in the destination.
+/// @param dy
+///     Top coordinate in the destination.
+/// @param dw
+///     Width in the destination.
+/// @param dh
+///     Height in the destination.
+/// @param src
+///     Source surface.
+/// @param sx
+///     Left coordinate in the source.
+/// @param sy
+///     Top coordinate in the source.
+/// @param sw
+///     Width in the source.
+/// @param sh
+///     Height in the source.
+/// @param mode
+///     How to combine the pixels.
+/// @param param
+///     Color key for BlitMode_ColorKey, opacity for BlitMode_Alpha.
+///
+/// @return
+///     0 on success, -1 if the formats or the mode aren't supported.
+int blitScaled(const BlitSurface *dst, int dx, int dy, int dw, int dh,
+               const BlitSurface *src, int sx, int sy, int sw, int sh,
+               BlitMode mode, u16 param);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_BLIT_H__
@@ -30,6 +30,7 @@ extern "C" {
 #include <sys/statvfs.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include <sys/uio.h>
 #include <sys/unistd.h>
 #include <time.h>
 #include <unistd.h>
@@ -209,6 +210,43 @@ typedef struct
 
     int (*ioctl)(int fd, unsigned long cmd, va_list ap);
     int (*fcntl)(int fd, int cmd, va_list ap);
+
+    /// Reads the next entry of a directory and its information.
+    ///
+    /// This is used by fatReadDirStat(). It's meant to be used by filesystems
+    /// that can get the information of the entries while they read the
+    /// directory, so that it isn't needed to call stat() for each entry.
+    ///
+    /// @param dirp
+    ///     DIR structure associated to the opened directory.
+    /// @param st
+    ///     Structure to be filled with the information of the entry.
+    ///
+    /// @return
+    ///     The same as readdir().
+    struct dirent *(*readdir_stat)(DIR *dirp, struct stat *st);
+
+    /// Reads data from a file into several buffers, like readv().
+    ///
+    /// If it's NULL, read() is called for each buffer instead.
+    ssize_t (*readv)(int fd, const struct iovec *iov, int iovcnt);
+
+    /// Writes data from several buffers to a file, like writev().
+    ///
+    /// If it's NULL, write() is called for each buffer instead.
+    ssize_t (*writev)(int fd, const struct iovec *iov, int iovcnt);
+
+    /// Reads data from the specified offset of a file into several buffers
+    /// without moving the file pointer, like preadv().
+    ///
+    /// If it's NULL, lseek() and readv() are used instead.
+    ssize_t (*preadv)(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+
+    /// Writes data from several buffers to the specified offset of a file
+    /// without moving the file pointer, like pwritev().
+    ///
+    /// If it's NULL, lseek() and writev() are used instead.
+    ssize_t (*pwritev)(int fd, const struct iovec *iov, int iovcnt, off_t offset);
 }
 device_io_t;
 
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/fsStats.h
+///
+/// @brief Filesystem I/O statistics and tracing.
+///
+/// When statistics are enabled, libnds records information about all the
+/// filesystem operations done by the application:
+///
+/// - Per file and per device: number of calls to open(), read(), write(),
+///   lseek() and close(), number of bytes transferred and time spent in them.
+///   This works for FAT, NitroFS and user devices (see device_io.h).
+///
+/// - Per storage drive (DLDI, DSi SD and DSi NAND): number of commands sent to
+///   the driver, number of sectors transferred, time spent in the driver, and
+///   hits and misses of the sector cache of FatFs.
+///
+/// Comparing the numbers helps find the cause of slow loading times. For
+/// example, a lot of driver commands for few bytes read by the application
+/// suggests that FatFs is reading a lot of metadata, and a lot of read() calls
+/// that transfer few bytes each suggest that the application should use bigger
+/// buffers.
+///
+/// Times are measured with the system tick counter, so systemCounterSetup()
+/// needs to be called before enabling statistics.
+///
+/// Usage:
+///
+/// ```c
+/// systemCounterSetup();
+/// fsStatsEnable(true);
+///
+/// // Load the assets of the game
+///
+/// fsStatsDump("sd:/fs_stats.txt");
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_FSSTATS_H__
+#define LIBNDS_NDS_ARM9_FSSTATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Operations that are recorded.
+typedef enum
+{
+    FS_STATS_OP_OPEN,   ///< open()
+    FS_STATS_OP_READ,   ///< read()
+    FS_STATS_OP_WRITE,  ///< write()
+    FS_STATS_OP_SEEK,   ///< lseek()
+    FS_STATS_OP_CLOSE,  ///< close()
+
+    FS_STATS_OP_COUNT   ///< Number of operations
+} FsStatsOp;
+
+/// Storage drives that are recorded.
+typedef enum
+{
+    FS_STATS_DRIVE_DLDI, ///< Flashcard (DLDI driver)
+    FS_STATS_DRIVE_SD,   ///< SD slot of the DSi
+    FS_STATS_DRIVE_NAND, ///< Internal NAND of the DSi
+
+    FS_STATS_DRIVE_COUNT ///< Number of drives
+} FsStatsDrive;
+
+/// Statistics of a file or a device.
+typedef struct FsIoStats
+{
+    uint32_t calls[FS_STATS_OP_COUNT];  ///< Number of calls of each operation
+    uint64_t ticks[FS_STATS_OP_COUNT];  ///< Time spent in each operation
+    uint32_t errors;                    ///< Number of calls that failed
+    uint64_t bytesRead;                 ///< Bytes returned by read()
+    uint64_t bytesWritten;              ///< Bytes accepted by write()
+} FsIoStats;
+
+/// Statistics of a storage drive.
+typedef struct FsDriveStats
+{
+    uint32_t readCommands;      ///< Read commands sent to the driver
+    uint32_t writeCommands;     ///< Write commands sent to the driver
+    uint64_t sectorsRead;       ///< Sectors read by the driver
+    uint64_t sectorsWritten;    ///< Sectors written by the driver
+    uint64_t readTicks;         ///< Time spent in read commands
+    uint64_t writeTicks;        ///< Time spent in write commands
+    uint32_t errors;            ///< Commands that have failed
+    uint32_t cacheHits;         ///< Sectors found in the sector cache
+    uint32_t cacheMisses;       ///< Sectors not found in the sector cache
+} FsDriveStats;
+
+/// Information about an operation passed to the trace callback.
+typedef struct FsTraceEvent
+{
+    FsStatsOp op;       ///< Operation
+    int fd;             ///< File descriptor (returned by open() for opens)
+    const char *path;   ///< Path of the file for opens, NULL otherwise
+    size_t size;        ///< Size requested for reads and writes
+    int64_t result;     ///< Value returned by the operation
+    uint32_t ticks;     ///< Duration of the operation
+} FsTraceEvent;
+
+/// Type of the trace callback.
+typedef void (*FsTraceCallback)(const FsTraceEvent *event, void *arg);
+
+/// Maximum number of open files whose statistics are recorded at a time.
+#define FS_STATS_MAX_FILES 32
+
+/// Enables or disables the recording of statistics.
+///
+/// Enabling statistics doesn't clear the values recorded previously. Files
+/// opened while statistics were disabled don't have per-file statistics, but
+/// they count towards the statistics of their device.
+///
+/// @param enable
+///     true to enable statistics, false to disable them.
+///
+/// @return
+///     0 on success, -1 if there isn't enough memory.
+int fsStatsEnable(bool enable);
+
+/// Sets all the statistics to zero.
+void fsStatsReset(void);
+
+/// Gets the statistics of an open file.
+///
+/// @param fd
+///     File descriptor. Use fileno(file) for FILE * inputs.
+/// @param stats
+///     Pointer to the destination of the statistics.
+///
+/// @return
+///     0 on success, -1 if the file isn't being recorded.
+int fsStatsGetFile(int fd, FsIoStats *stats);
+
+/// Gets the statistics of the device that contains a path.
+///
+/// All FAT drives ("fat:/", "sd:/", "nand:/") are the same device. Use
+/// fsStatsGetDrive() to get information about each one of them.
+///
+/// @param path
+///     A path in the device, like "nitro:/" or "sd:/".
+/// @param stats
+///     Pointer to the destination of the statistics.
+///
+/// @return
+///     0 on success, -1 on error.
+int fsStatsGetDevice(const char *path, FsIoStats *stats);
+
+/// Gets the statistics of a storage drive.
+///
+/// @param drive
+///     Storage drive.
+/// @param stats
+///     Pointer to the destination of the statistics.
+///
+/// @return
+///     0 on success, -1 on error.
+int fsStatsGetDrive(FsStatsDrive drive, FsDriveStats *stats);
+
+/// Sets a function that is called after every recorded operation.
+///
+/// The callback is called from the thread that does the operation. It can't
+/// use any filesystem function.
+///
+/// @param callback
+///     Function to call, or NULL to disable tracing.
+/// @param arg
+///     Argument passed to the callback.
+void fsStatsSetTraceCallback(FsTraceCallback callback, void *arg);
+
+/// Writes a text report with all the statistics to a file.
+///
+/// Statistics are paused while the report is being written so that it doesn't
+/// affect them.
+///
+/// @param path
+///     Path of the destination file. It is overwritten if it exists.
+///
+/// @return
+///     0 on success, -1 on error.
+int fsStatsDump(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_FSSTATS_H__
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/glMesh.h
+///
+/// @brief Encoder of vertex streams into compact display lists.
+///
+/// The geometry engine has several commands to send vertices. VTX_16 needs two
+/// words of parameters, but VTX_10, VTX_XY, VTX_XZ, VTX_YZ and VTX_DIFF only
+/// need one. This encoder picks the cheapest command that represents each
+/// vertex exactly, and it skips normal, texture coordinate and color commands
+/// that don't change the current state of the geometry engine. The result is a
+/// packed display list that can be sent with glCallList(), which reduces the
+/// size of the display list and the time needed to send it to the GPU.
+///
+/// The order of preference for each vertex is:
+///
+/// - VTX_XY, VTX_XZ or VTX_YZ if one coordinate is the same as in the previous
+///   vertex.
+/// - VTX_DIFF if the difference with the previous vertex is a multiple of 8 and
+///   it fits in 10 bits after dividing it by 8 (the differences are stored in
+///   1.0.9 format).
+/// - VTX_10 if the 6 lowest bits of all coordinates are zero.
+/// - VTX_16 otherwise.
+///
+/// The encoder doesn't access any hardware register, so it can also be built
+/// for the host to convert models as part of the build process of a game.
+
+#ifndef LIBNDS_NDS_ARM9_GLMESH_H__
+#define LIBNDS_NDS_ARM9_GLMESH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Flags that modify the behaviour of glMeshEncode().
+typedef enum
+{
+    /// Round vertices that can't be encoded exactly to VTX_10 instead of using
+    /// VTX_16. The error is at most 1/128 units in each axis, except for
+    /// coordinates over 7.9921875, which are clamped to 7.984375.
+    GL_MESH_ROUND_VTX10 = (1 << 0),
+    /// Don't add the BEGIN_VTXS and END_VTXS commands to the display list.
+    GL_MESH_NO_BEGIN_END = (1 << 1),
+} GL_MESH_FLAGS_ENUM;
+
+/// Vertex stream to be encoded with glMeshEncode().
+typedef struct glMeshStream
+{
+    /// Vertex coordinates in 4.12 format. 3 values (x, y, z) per vertex.
+    const int16_t *positions;
+    /// Normals packed with NORMAL_PACK() (one per vertex), or NULL.
+    const uint32_t *normals;
+    /// Texture coordinates packed with TEXTURE_PACK() (one per vertex), or
+    /// NULL.
+    const uint32_t *texcoords;
+    /// RGB15 vertex colors (one per vertex), or NULL.
+    const uint16_t *colors;
+    /// Number of vertices in the stream.
+    size_t count;
+    /// Polygon type (a value of GL_GLBEGIN_ENUM).
+    uint32_t primitive;
+} glMeshStream;
+
+/// Statistics of an encoded display list.
+typedef struct glMeshStats
+{
+    uint32_t words; ///< Size of the display list in words (including the size)
+    uint32_t vtx16; ///< Number of VTX_16 commands
+    uint32_t vtx10; ///< Number of VTX_10 commands
+    uint32_t vtx_xy_xz_yz; ///< Number of VTX_XY, VTX_XZ and VTX_YZ commands
+    uint32_t vtx_diff; ///< Number of VTX_DIFF commands
+    uint32_t rounded; ///< Number of vertices that have been rounded
+    uint32_t skipped_attrs; ///< Number of redundant attributes removed
+} glMeshStats;
+
+/// Encodes a vertex stream as a packed display list.
+///
+/// The first word of the display list is its size in words (not including the
+/// first word), so it can be passed directly to glCallList().
+///
+/// Pass NULL as output buffer to get the required size of the buffer.
+///
+/// @param stream
+///     Vertex stream to encode.
+/// @param out
+///     Destination buffer, or NULL.
+/// @param out_words
+///     Size of the destination buffer in words.
+/// @param flags
+///     Flags from GL_MESH_FLAGS_ENUM.
+/// @param stats
+///     Pointer to a struct to store statistics of the list, or NULL.
+///
+/// @return
+///     The number of words of the display list (including the first word). It
+///     returns 0 if the arguments are invalid or the buffer is too small.
+size_t glMeshEncode(const glMeshStream *stream, uint32_t *out, size_t out_words,
+                    unsigned int flags, glMeshStats *stats);
+
+/// Decodes the vertex coordinates of a display list.
+///
+/// It simulates the way the geometry engine updates the current vertex for all
+/// vertex commands of the list. This can be used to verify that a list
+/// generated by glMeshEncode() has the expected coordinates.
+///
+/// @param list
+///     Display list in the format accepted by glCallList().
+/// @param positions
+///     Destination buffer for the coordinates (3 values per vertex).
+/// @param max_vertices
+///     Maximum number of vertices that fit in the destination buffer.
+///
+/// @return
+///     Number of vertices in the list, or -1 if the list is invalid or there
+///     isn't enough space in the destination buffer.
+int glMeshDecodePositions(const uint32_t *list, int16_t *positions,
+                          size_t max_vertices);
+
+/// Packs a normal in 20.12 fixed point format for the NORMAL command.
+///
+/// Unlike NORMAL_PACK() the components are clamped to the valid range.
+///
+/// @param x
+///     X component (20.12).
+/// @param y
+///     Y component (20.12).
+/// @param z
+///     Z component (20.12).
+///
+/// @return
+///     The packed normal.
+static inline uint32_t glMeshPackNormalf32(int32_t x, int32_t y, int32_t z)
+{
+    // Convert to 1.0.9 and clamp to the range that can be represented
+    x >>= 3;
+    y >>= 3;
+    z >>= 3;
+    x = x > 0x1FF ? 0x1FF : (x < -0x200 ? -0x200 : x);
+    y = y > 0x1FF ? 0x1FF : (y < -0x200 ? -0x200 : y);
+    z = z > 0x1FF ? 0x1FF : (z < -0x200 ? -0x200 : z);
+
+    return ((uint32_t)x & 0x3FF) | (((uint32_t)y & 0x3FF) << 10)
+           | (((uint32_t)z & 0x3FF) << 20);
+}
+
+/// Packs texture coordinates in 20.12 fixed point format for the TEXCOORD
+/// command.
+///
+/// The coordinates are converted to texels and clamped to the range of the
+/// signed 12.4 format (-2048.0 to 2047.9375 texels), so values out of range
+/// don't wrap around.
+///
+/// @param u
+///     U coordinate (0.0 to 1.0 in 20.12 format).
+/// @param v
+///     V coordinate (0.0 to 1.0 in 20.12 format).
+/// @param width
+///     Width of the texture in pixels.
+/// @param height
+///     Height of the texture in pixels.
+///
+/// @return
+///     The packed texture coordinates in 12.4 format.
+static inline uint32_t glMeshPackTexCoordf32(int32_t u, int32_t v,
+                                             int width, int height)
+{
+    // Round to the nearest 12.4 value and clamp it to the valid range
+    int64_t tu = ((int64_t)u * width + (1 << 7)) >> 8;
+    int64_t tv = ((int64_t)v * height + (1 << 7)) >> 8;
+    tu = tu > 0x7FFF ? 0x7FFF : (tu < -0x8000 ? -0x8000 : tu);
+    tv = tv > 0x7FFF ? 0x7FFF : (tv < -0x8000 ? -0x8000 : tv);
+
+    return ((uint32_t)tu & 0xFFFF) | (((uint32_t)tv & 0xFFFF) << 16);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_GLMESH_H__
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/glProfiler.h
+///
+/// @brief Frame profiler for the 3D engine.
+///
+/// The DS can only store 2048 polygons and 6144 vertices per frame. Any polygon
+/// sent after one of the limits is reached is dropped. This profiler records
+/// how much of the budget has been used by each frame, how much of the geometry
+/// has been sent with glCallList(), and how much time the CPU has spent waiting
+/// for the geometry engine.
+///
+/// Usage:
+///
+/// ```c
+/// systemCounterSetup(); // The profiler uses the system counter
+/// glProfilerInit(64);   // Keep the samples of the last 64 frames
+///
+/// while (1)
+/// {
+///     // Draw the scene...
+///
+///     glProfilerFlush(0); // Replaces glFlush(0) + swiWaitForVBlank()
+/// }
+/// ```
+///
+/// Display lists sent with glCallList() are parsed while the profiler is
+/// active, so it's possible to know how many vertices and polygons were sent
+/// and compare it with the number of them that have been stored in the
+/// polygon and vertex RAM after clipping and culling. The "dlist" counters
+/// only include display lists. Immediate mode functions like glBegin() and
+/// glVertex3v16() write to the hardware directly, so the geometry sent with
+/// them is only included in the totals read from the hardware.
+
+#ifndef LIBNDS_NDS_ARM9_GLPROFILER_H__
+#define LIBNDS_NDS_ARM9_GLPROFILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <nds/arm9/videoGL.h>
+#include <nds/ndstypes.h>
+
+/// Maximum number of polygons that can be stored in polygon RAM.
+#define GL_MAX_POLYGONS 2048
+/// Maximum number of vertices that can be stored in vertex RAM.
+#define GL_MAX_VERTICES 6144
+
+/// Statistics of one frame.
+typedef struct glProfilerSample
+{
+    uint32_t frame; ///< Number of frame since glProfilerInit() was called
+
+    uint16_t polygons; ///< Polygons stored in polygon RAM
+    uint16_t vertices; ///< Vertices stored in vertex RAM
+    bool overflow; ///< True if polygons were dropped due to lack of space
+
+    // Geometry sent in display lists. Immediate mode commands (glBegin(),
+    // glVertex3v16(), etc) aren't included.
+    uint32_t dlist_calls; ///< Number of calls to glCallList()
+    uint32_t dlist_words; ///< Number of words sent in display lists
+    uint32_t dlist_commands; ///< Number of commands sent in display lists
+    uint32_t dlist_vertices; ///< Number of vertices sent in display lists
+    uint32_t dlist_polygons; ///< Number of polygons sent in display lists
+
+    /// Ticks spent waiting for the geometry FIFO (glCallList() and the wait
+    /// for the geometry engine to be idle at the end of the frame).
+    uint32_t fifo_stall_ticks;
+    /// Ticks spent waiting for the buffers to be swapped in glProfilerFlush().
+    uint32_t swap_wait_ticks;
+} glProfilerSample;
+
+/// Starts the 3D profiler.
+///
+/// systemCounterSetup() must have been called before using the profiler.
+///
+/// @param num_samples
+///     Number of frames to keep in the ring buffer of samples.
+///
+/// @return
+///     1 on success, 0 on failure (not enough memory).
+int glProfilerInit(size_t num_samples);
+
+/// Stops the 3D profiler and frees all memory used by it.
+void glProfilerDeinit(void);
+
+/// Resets the statistics of the frame being drawn and clears the ring buffer.
+void glProfilerReset(void);
+
+/// Ends the current frame and saves its statistics in the ring buffer.
+///
+/// This waits for the geometry engine to finish processing all commands sent
+/// in this frame, reads the hardware polygon and vertex counters, and then
+/// calls glFlush() and swiWaitForVBlank(). It needs to be used instead of those
+/// two functions.
+///
+/// If the profiler isn't active it just calls glFlush() and swiWaitForVBlank().
+///
+/// @param mode
+///     Flags from GLFLUSH_ENUM.
+void glProfilerFlush(u32 mode);
+
+/// Returns the number of samples available in the ring buffer.
+///
+/// @return
+///     Number of samples.
+size_t glProfilerGetSampleCount(void);
+
+/// Returns a sample from the ring buffer.
+///
+/// @param index
+///     Index of the sample. 0 is the most recent frame, 1 is the frame before
+///     that one, etc.
+///
+/// @return
+///     A pointer to the sample, or NULL if the index is out of bounds.
+const glProfilerSample *glProfilerGetSample(size_t index);
+
+/// Prints a summary of the recorded samples with printf().
+///
+/// It prints the last frame and the average and maximum values of all the
+/// samples in the ring buffer. If the console is initialized on the screen that
+/// isn't used for 3D graphics it can be used as an on-screen overlay.
+void glProfilerPrintSummary(void);
+
+/// Writes all the samples of the ring buffer to a file as CSV data.
+///
+/// The oldest sample is written first.
+///
+/// @param file
+///     File to write to.
+///
+/// @return
+///     0 on success, -1 on error.
+int glProfilerDump(FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_GLPROFILER_H__
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/glTransQueue.h
+///
+/// @brief Depth-sorted queue of translucent draw calls.
+///
+/// Translucent polygons only blend correctly with the polygons behind them if
+/// they are drawn from back to front. The GPU can sort them by Y coordinate,
+/// but that's only useful in some 2D-like scenes. With GL_TRANS_MANUALSORT the
+/// GPU draws them in the order they are sent, so the CPU has to sort them.
+///
+/// This queue records translucent objects (a display list, the modelview
+/// matrix to use with it and its polygon format) with a depth key. When the
+/// queue is flushed, the objects are sorted with a radix sort and sent to the
+/// GPU from back to front. The cost of sorting and sending the objects is
+/// linear with the number of objects.
+///
+/// Usage:
+///
+/// ```c
+/// glTransQueueInit(128);
+///
+/// while (1)
+/// {
+///     // Draw opaque objects...
+///
+///     for (int i = 0; i < num_glass; i++)
+///     {
+///         // modelview = camera * model
+///         glTransQueueAdd(glass_list, &glass[i].modelview,
+///                         POLY_ALPHA(15) | POLY_ID(i + 1) | POLY_CULL_BACK);
+///     }
+///
+///     glTransQueueFlush();
+///
+///     glFlush(GL_TRANS_MANUALSORT);
+///     swiWaitForVBlank();
+/// }
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_GLTRANSQUEUE_H__
+#define LIBNDS_NDS_ARM9_GLTRANSQUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nds/arm9/videoGL.h>
+#include <nds/ndstypes.h>
+
+/// Allocates the memory used by the queue.
+///
+/// If the queue had already been initialized, the objects in it are discarded.
+///
+/// @param max_entries
+///     Maximum number of objects that can be added to the queue every frame.
+///
+/// @return
+///     1 on success, 0 on failure (not enough memory).
+int glTransQueueInit(size_t max_entries);
+
+/// Frees the memory used by the queue.
+void glTransQueueDeinit(void);
+
+/// Adds an object to the queue with an explicit depth key.
+///
+/// The matrix is copied to the queue, but the display list isn't copied, so it
+/// must remain valid until glTransQueueFlush() is called.
+///
+/// @param list
+///     Display list in the format accepted by glCallList().
+/// @param modelview
+///     Matrix that will be loaded as modelview matrix before calling the list.
+/// @param poly_format
+///     Polygon format for the object, as passed to glPolyFmt().
+/// @param depth
+///     Depth key in the same coordinate system as the modelview matrix (20.12
+///     fixed point). Objects with lower values are further away from the camera
+///     and they are drawn first.
+///
+/// @return
+///     1 on success, 0 if the queue is full or it hasn't been initialized.
+int glTransQueueAddDepth(const void *list, const m4x3 *modelview,
+                         u32 poly_format, int32_t depth);
+
+/// Adds an object to the queue.
+///
+/// The depth key is the Z coordinate of the origin of the object in view
+/// space, which is the Z component of the translation of the modelview matrix.
+/// The matrix is copied to the queue, but the display list isn't copied, so it
+/// must remain valid until glTransQueueFlush() is called.
+///
+/// @param list
+///     Display list in the format accepted by glCallList().
+/// @param modelview
+///     Matrix that will be loaded as modelview matrix before calling the list.
+/// @param poly_format
+///     Polygon format for the object, as passed to glPolyFmt().
+///
+/// @return
+///     1 on success, 0 if the queue is full or it hasn't been initialized.
+static inline int glTransQueueAdd(const void *list, const m4x3 *modelview,
+                                  u32 poly_format)
+{
+    return glTransQueueAddDepth(list, modelview, poly_format,
+                                modelview->m[11]);
+}
+
+/// Returns the number of objects in the queue.
+///
+/// @return
+///     Number of objects.
+size_t glTransQueueGetCount(void);
+
+/// Sorts the objects of the queue and sends them to the GPU from back to front.
+///
+/// The matrix mode is set to GL_MODELVIEW and the modelview matrix is
+/// preserved, but the polygon format is left with the value of the last object
+/// that has been sent. The queue is empty after calling this function.
+///
+/// glFlush() must be called with GL_TRANS_MANUALSORT for the GPU to respect
+/// the order of the objects.
+void glTransQueueFlush(void);
+
+/// Removes all objects from the queue without sending them to the GPU.
+void glTransQueueClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_GLTRANSQUEUE_H__
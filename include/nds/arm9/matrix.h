@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/matrix.h
+///
+/// @brief Fixed point matrix functions that run on the CPU.
+///
+/// The geometry engine can multiply matrices very quickly, but reading the
+/// results back with glGetFixed() requires waiting for it to be idle. The
+/// functions in this file do the same operations on the CPU so that the results
+/// can be used right away (for example, to calculate the bone matrices of a
+/// skeleton, or for collision checks).
+///
+/// All matrices use the same layout as the geometry engine. A m4x3 matrix is
+/// stored as 4 rows of 3 elements, and the last row is the translation. Vectors
+/// are row vectors, so transforming a vertex by a matrix is done like this:
+///
+/// ```
+/// x' = x * m[0] + y * m[3] + z * m[6] + m[9]
+/// y' = x * m[1] + y * m[4] + z * m[7] + m[10]
+/// z' = x * m[2] + y * m[5] + z * m[8] + m[11]
+/// ```
+///
+/// All the results can be loaded in the geometry engine with glLoadMatrix4x3(),
+/// glLoadMatrix4x4(), glMultMatrix4x3() and glMultMatrix4x4().
+///
+/// The functions that process many vertices at once are placed in ITCM.
+
+#ifndef LIBNDS_NDS_ARM9_MATRIX_H__
+#define LIBNDS_NDS_ARM9_MATRIX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nds/arm9/videoGL.h>
+#include <nds/ndstypes.h>
+
+/// Sets a 4x3 matrix to the identity matrix.
+///
+/// @param m
+///     Matrix to set.
+void matrixIdentity4x3(m4x3 *m);
+
+/// Sets a 4x4 matrix to the identity matrix.
+///
+/// @param m
+///     Matrix to set.
+void matrixIdentity4x4(m4x4 *m);
+
+/// Multiplies two 4x3 matrices.
+///
+/// The result is the same matrix the geometry engine would have if "b" was
+/// loaded with glLoadMatrix4x3() and then multiplied by "a" with
+/// glMultMatrix4x3(). In the hierarchy of a skeleton, "a" is the local matrix of
+/// a bone and "b" is the matrix of its parent.
+///
+/// The result matrix may be the same as any of the source matrices.
+///
+/// @param result
+///     Destination matrix.
+/// @param a
+///     First matrix.
+/// @param b
+///     Second matrix.
+void matrixMult4x3(m4x3 *result, const m4x3 *a, const m4x3 *b);
+
+/// Multiplies two 4x4 matrices.
+///
+/// The result is the same matrix the geometry engine would have if "b" was
+/// loaded with glLoadMatrix4x4() and then multiplied by "a" with
+/// glMultMatrix4x4().
+///
+/// The result matrix may be the same as any of the source matrices.
+///
+/// @param result
+///     Destination matrix.
+/// @param a
+///     First matrix.
+/// @param b
+///     Second matrix.
+void matrixMult4x4(m4x4 *result, const m4x4 *a, const m4x4 *b);
+
+/// Calculates the inverse of a 4x3 matrix.
+///
+/// This is useful to calculate the inverse bind pose of a bone, or to convert
+/// points from world space to the local space of an object.
+///
+/// The result matrix may be the same as the source matrix.
+///
+/// @param result
+///     Destination matrix.
+/// @param m
+///     Matrix to invert.
+///
+/// @return
+///     It returns true on success. It returns false if the matrix can't be
+///     inverted (the determinant of the 3x3 part is zero or too small to be
+///     represented with 20.12 fixed point values). In that case the result
+///     matrix isn't modified.
+bool matrixInverse4x3(m4x3 *result, const m4x3 *m);
+
+/// Calculates the inverse of a 4x4 matrix.
+///
+/// The result matrix may be the same as the source matrix.
+///
+/// @param result
+///     Destination matrix.
+/// @param m
+///     Matrix to invert.
+///
+/// @return
+///     It returns true on success. It returns false if the matrix can't be
+///     inverted. In that case the result matrix isn't modified.
+bool matrixInverse4x4(m4x4 *result, const m4x4 *m);
+
+/// Transforms a list of vertices by a 4x3 matrix.
+///
+/// Each vertex is formed by 3 consecutive v16 values (x, y, z). The source and
+/// destination buffers may be the same buffer.
+///
+/// @param m
+///     Matrix to use.
+/// @param in
+///     Source vertices.
+/// @param out
+///     Destination vertices.
+/// @param count
+///     Number of vertices.
+void matrixTransform4x3(const m4x3 *m, const v16 *in, v16 *out, size_t count);
+
+/// Transforms a list of vectors by a 4x4 matrix.
+///
+/// Each input vector is formed by 3 consecutive 20.12 values (x, y, z), and w
+/// is assumed to be 1.0. Each output vector is formed by 4 consecutive 20.12
+/// values (x, y, z, w). This is useful to project points to the screen.
+///
+/// @param m
+///     Matrix to use.
+/// @param in
+///     Source vectors.
+/// @param out
+///     Destination vectors.
+/// @param count
+///     Number of vectors.
+void matrixTransform4x4(const m4x4 *m, const int32_t *in, int32_t *out,
+                        size_t count);
+
+/// Transforms a list of vertices by a palette of bone matrices.
+///
+/// Each vertex is transformed by the matrix of the bone it is assigned to. This
+/// can be used to skin a mesh on the CPU and send it to the GPU as a regular
+/// mesh, which avoids loading one matrix in the geometry engine per bone.
+///
+/// Each vertex is formed by 3 consecutive v16 values (x, y, z). The source and
+/// destination buffers may be the same buffer.
+///
+/// @param bones
+///     Array of bone matrices.
+/// @param bone_index
+///     Index of the bone used by each vertex.
+/// @param in
+///     Source vertices.
+/// @param out
+///     Destination vertices.
+/// @param count
+///     Number of vertices.
+void matrixSkin4x3(const m4x3 *bones, const uint8_t *bone_index,
+                   const v16 *in, v16 *out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_MATRIX_H__
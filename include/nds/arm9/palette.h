@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/palette.h
+///
+/// @brief Palette fades, blends and color cycling with shadow palettes.
+///
+/// This module keeps two copies in main RAM of each palette that it manages:
+/// the base palette, set by the application, and the shadow palette, which is
+/// the result of applying effects to the base palette. Effects are computed
+/// from the base palette, so they can be applied any number of times without
+/// losing precision. palCommit() copies the range of colors of each shadow
+/// palette that has been modified since the last commit to palette RAM or VRAM
+/// with DMA.
+///
+/// The standard palettes of both engines and their extended palettes are
+/// supported. Extended palettes are copied to the VRAM bank that is mapped to
+/// them, which is temporarily mapped as LCD during the copy.
+///
+/// Blends process two colors in each 32-bit word with routines that run from
+/// ITCM. A fade of a full 256-color palette takes 256 multiplications.
+///
+/// Usage:
+///
+/// ```c
+/// palInit(PalId_BgMain, 256);
+/// palSet(PalId_BgMain, 0, levelPal, 256);
+///
+/// for (int i = 0; i <= 32; i++)
+/// {
+///     // Fade to black
+///     palBlend(PalId_BgMain, 0, 256, RGB15(0, 0, 0), i);
+///
+///     swiWaitForVBlank();
+///     palCommit();
+/// }
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_PALETTE_H__
+#define LIBNDS_NDS_ARM9_PALETTE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <nds/ndstypes.h>
+
+/// Palettes that can be managed by this module.
+typedef enum
+{
+    PalId_BgMain,           ///< Main engine BG palette (256 colors)
+    PalId_SpriteMain,       ///< Main engine sprite palette (256 colors)
+    PalId_BgSub,            ///< Sub engine BG palette (256 colors)
+    PalId_SpriteSub,        ///< Sub engine sprite palette (256 colors)
+    PalId_BgExtMain,        ///< Main engine BG extended palettes (4 x 4096 colors)
+    PalId_SpriteExtMain,    ///< Main engine sprite extended palette (4096 colors)
+    PalId_BgExtSub,         ///< Sub engine BG extended palettes (4 x 4096 colors)
+    PalId_SpriteExtSub,     ///< Sub engine sprite extended palette (4096 colors)
+
+    PalId_Count             ///< Number of palettes
+} PalId;
+
+/// Maximum blend factor.
+#define PAL_BLEND_MAX   32
+
+/// Starts managing a palette.
+///
+/// The base and shadow palettes are filled with black. If the palette was
+/// already being managed its colors are discarded.
+///
+/// @param id
+///     Palette to manage.
+/// @param count
+///     Number of colors to manage, starting from the first one of the palette.
+///     Use 0 to manage all the colors of the palette.
+///
+/// @return
+///     0 on success, -1 on error (invalid arguments or not enough memory).
+int palInit(PalId id, int count);
+
+/// Stops managing a palette and frees its memory.
+///
+/// @param id
+///     Palette.
+void palDeinit(PalId id);
+
+/// Sets colors of the base palette and resets them in the shadow palette.
+///
+/// @param id
+///     Palette.
+/// @param start
+///     First color to set.
+/// @param colors
+///     New colors.
+/// @param count
+///     Number of colors.
+void palSet(PalId id, int start, const u16 *colors, int count);
+
+/// Returns a pointer to the base palette.
+///
+/// After modifying the base palette directly, call palRestore() or apply any
+/// effect to update the shadow palette.
+///
+/// @param id
+///     Palette.
+///
+/// @return
+///     Pointer to the base palette, or NULL if it isn't being managed.
+u16 *palGetBase(PalId id);
+
+/// Copies colors of the base palette to the shadow palette.
+///
+/// @param id
+///     Palette.
+/// @param start
+///     First color.
+/// @param count
+///     Number of colors.
+void palRestore(PalId id, int start, int count);
+
+/// Blends colors of the base palette with a color.
+///
+/// This can be used to fade to black or white, or to tint the palette.
+///
+/// @param id
+///     Palette.
+/// @param start
+///     First color.
+/// @param count
+///     Number of colors.
+/// @param color
+///     Color to blend with.
+/// @param factor
+///     Amount of the blend color (0 to PAL_BLEND_MAX). With 0 the result is
+///     the base palette, with PAL_BLEND_MAX it's the blend color.
+void palBlend(PalId id, int start, int count, u16 color, int factor);
+
+/// Blends colors of the base palette with the colors of another palette.
+///
+/// @param id
+///     Palette.
+/// @param start
+///     First color.
+/// @param count
+///     Number of colors.
+/// @param target
+///     Palette to blend with, starting at the color that corresponds to
+///     "start". It must be aligned to 4 bytes if "start" is even, and to 2
+///     bytes otherwise.
+/// @param factor
+///     Amount of the target palette (0 to PAL_BLEND_MAX).
+void palBlendPalette(PalId id, int start, int count, const u16 *target,
+                     int factor);
+
+/// Rotates a range of colors of the base palette.
+///
+/// Color "start + i" of the shadow palette is set to color
+/// "start + (i + offset) % count" of the base palette.
+///
+/// @param id
+///     Palette.
+/// @param start
+///     First color.
+/// @param count
+///     Number of colors.
+/// @param offset
+///     Rotation (it can be negative).
+void palCycle(PalId id, int start, int count, int offset);
+
+/// Copies the modified colors of all shadow palettes to the hardware.
+///
+/// It must be called during VBlank.
+void palCommit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_PALETTE_H__
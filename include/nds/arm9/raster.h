@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/raster.h
+///
+/// @brief Per-scanline register changes with HBlank DMA.
+///
+/// Effects like wavy backgrounds, perspective floors, or color gradients need
+/// to change some video registers between scanlines. This module does it with
+/// DMA transfers started automatically in every HBlank period, so it doesn't
+/// need any interrupt handler and it uses almost no CPU time.
+///
+/// Each effect uses one DMA channel and a table with the values to write to a
+/// group of consecutive registers for every scanline. The tables are double
+/// buffered: the application fills the back table while the front table is
+/// being displayed, and rasterSwap() makes the back table visible from the next
+/// frame, so updates never tear.
+///
+/// rasterVBlank() must be called at the start of each VBlank period. It writes
+/// the values of scanline 0 and restarts the DMA transfers. Call it after any
+/// other function that writes the same registers, like bgUpdate().
+///
+/// Usage:
+///
+/// ```c
+/// int bg = bgInit(0, BgType_Text8bpp, BgSize_T_256x256, 0, 1);
+/// rasterInitScroll(0, bg);
+///
+/// while (1)
+/// {
+///     bg_scroll *table = rasterGetTable(0);
+///     for (int i = 0; i < SCREEN_HEIGHT; i++)
+///     {
+///         table[i].x = sinLerp(i * 200 + frame * 300) >> 9;
+///         table[i].y = 0;
+///     }
+///     rasterSwap(0);
+///
+///     swiWaitForVBlank();
+///     bgUpdate();
+///     rasterVBlank();
+/// }
+/// ```
+///
+/// @note
+///     DMA channel 3 is used by dmaCopy() and other functions of libnds, so
+///     it's better to use channels 0 to 2.
+
+#ifndef LIBNDS_NDS_ARM9_RASTER_H__
+#define LIBNDS_NDS_ARM9_RASTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <nds/arm9/window.h>
+#include <nds/ndstypes.h>
+
+/// Creates an entry for a table of horizontal window bounds.
+///
+/// @param left
+///     Left bound (0 - 255).
+/// @param right
+///     Right bound (0 - 255).
+#define RASTER_WINDOW_H(left, right)    (((left) << 8) | (right))
+
+/// Starts a per-scanline effect on a group of registers.
+///
+/// Each entry of the table has as many bytes as the group of registers, and it
+/// must be a multiple of 2. If it's a multiple of 4 the registers are written
+/// with 32-bit accesses.
+///
+/// If the channel was already used by an effect, that effect is stopped.
+///
+/// @param channel
+///     DMA channel (0 - 3).
+/// @param reg
+///     Address of the first register.
+/// @param entryBytes
+///     Size of the group of registers in bytes.
+///
+/// @return
+///     0 on success, -1 on error (invalid arguments or not enough memory).
+int rasterInit(int channel, volatile void *reg, size_t entryBytes);
+
+/// Starts a per-scanline effect on the scroll registers of a background.
+///
+/// The entries of the table are bg_scroll structs.
+///
+/// @param channel
+///     DMA channel (0 - 3).
+/// @param id
+///     Background ID returned by bgInit() or bgInitSub().
+///
+/// @return
+///     0 on success, -1 on error.
+int rasterInitScroll(int channel, int id);
+
+/// Starts a per-scanline effect on the affine registers of a background.
+///
+/// The entries of the table are bg_transform structs. Writing the reference
+/// point registers in the middle of the frame resets the internal reference
+/// point of the background, so dx and dy are the map coordinates of the left
+/// pixel of each scanline.
+///
+/// @param channel
+///     DMA channel (0 - 3).
+/// @param id
+///     Background ID of an affine background.
+///
+/// @return
+///     0 on success, -1 on error (the background doesn't have affine
+///     registers).
+int rasterInitAffine(int channel, int id);
+
+/// Starts a per-scanline effect on the horizontal bounds of a window.
+///
+/// The entries of the table are u16 values created with RASTER_WINDOW_H(). The
+/// vertical bounds of the window should cover the scanlines of the effect.
+///
+/// @param channel
+///     DMA channel (0 - 3).
+/// @param window
+///     WINDOW_0 or WINDOW_1.
+/// @param sub
+///     True to use the window of the sub engine.
+///
+/// @return
+///     0 on success, -1 on error.
+int rasterInitWindow(int channel, WINDOW window, bool sub);
+
+/// Starts a per-scanline effect on a range of palette entries.
+///
+/// The entries of the table are arrays of "count" colors.
+///
+/// @param channel
+///     DMA channel (0 - 3).
+/// @param palette
+///     Address of the first color in palette RAM (for example, BG_PALETTE).
+/// @param count
+///     Number of colors to write in each scanline.
+///
+/// @return
+///     0 on success, -1 on error.
+int rasterInitPalette(int channel, u16 *palette, int count);
+
+/// Stops an effect and frees its tables.
+///
+/// The registers keep the last values written to them.
+///
+/// @param channel
+///     DMA channel used by the effect.
+void rasterDeinit(int channel);
+
+/// Returns the table of an effect that can be modified by the application.
+///
+/// The table has one entry for each scanline (SCREEN_HEIGHT entries). The
+/// pointer changes every time rasterSwap() is called. Right after rasterInit()
+/// it's filled with zeroes.
+///
+/// @param channel
+///     DMA channel used by the effect.
+///
+/// @return
+///     Pointer to the table, or NULL if the channel isn't used by any effect.
+void *rasterGetTable(int channel);
+
+/// Makes the table returned by rasterGetTable() visible from the next frame.
+///
+/// The contents of the table aren't copied to the new back table, so all
+/// entries must be written again before the next swap.
+///
+/// @param channel
+///     DMA channel used by the effect.
+void rasterSwap(int channel);
+
+/// Writes the values of scanline 0 and restarts the DMA transfers.
+///
+/// It must be called at the start of every VBlank period.
+void rasterVBlank(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_RASTER_H__
@@ -300,6 +300,34 @@ typedef enum
     SpriteMode_Bitmap = OBJMODE_BITMAP      ///< Sprite is not using tiles, per pixel image data.
 } SpriteMode;
 
+/// Ways in which oamUpdate() copies the shadow OAM to OAM.
+typedef enum
+{
+    /// Flush and copy the whole shadow OAM (1 KB) with a blocking DMA copy.
+    OamUpdateMode_Full = 0,
+    /// Flush and copy only the ranges of entries that have been modified since
+    /// the last update, with blocking DMA copies.
+    OamUpdateMode_Dirty = 1,
+    /// Flush all entries between the first and the last modified entries and
+    /// copy them with one DMA transfer. oamUpdate() returns without waiting
+    /// for the transfer to end.
+    OamUpdateMode_DirtyAsync = 2
+} OamUpdateMode;
+
+/// Allocators of sprite graphics memory used by oamAllocateGfx().
+typedef enum
+{
+    /// First fit allocator with a list of free blocks. The time needed to
+    /// allocate and free graphics grows with the number of free blocks.
+    OamAllocator_FirstFit = 0,
+    /// Buddy allocator. Allocating and freeing graphics takes a constant time
+    /// and blocks are always aligned to their size. Graphics can be moved with
+    /// oamAllocCompact() to reduce fragmentation.
+    OamAllocator_Buddy = 1
+} OamAllocator;
+
+struct OamBuddyState;
+
 typedef struct AllocHeader
 {
     u16 nextFree;
@@ -322,6 +350,10 @@ typedef struct OamState
         SpriteRotation *oamRotationMemory; ///< Pointer to shadow oam memory for rotation
     };
     SpriteMapping spriteMapping; ///< The mapping of the OAM.
+    u32 dirtyMask[SPRITE_COUNT / 32]; ///< Entries modified since the last update
+    OamUpdateMode updateMode; ///< How oamUpdate() copies the shadow OAM
+    int updateDmaChannel;     ///< DMA channel used by OamUpdateMode_DirtyAsync
+    struct OamBuddyState *buddyState; ///< Buddy allocator state (NULL if unused)
 } OamState;
 
 /// An object representing the main 2D engine.
@@ -330,6 +362,35 @@ extern OamState oamMain;
 /// An object representing the sub 2D engine.
 extern OamState oamSub;
 
+/// Marks an OAM entry as modified.
+///
+/// All functions of this file that modify the shadow OAM call this function.
+/// It only needs to be called when the shadow OAM is modified directly and
+/// oamUpdate() doesn't use OamUpdateMode_Full.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param id
+///     The OAM number that has been modified [0 - 127].
+static inline void oamMarkEntryDirty(OamState *oam, int id)
+{
+    oam->dirtyMask[id >> 5] |= BIT(id & 31);
+}
+
+/// Marks the OAM entries that hold an affine matrix as modified.
+///
+/// Each affine matrix is stored in the unused fourth halfword of four
+/// consecutive OAM entries.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param rotId
+///     The affine matrix that has been modified [0 - 31].
+static inline void oamMarkAffineDirty(OamState *oam, int rotId)
+{
+    oam->dirtyMask[rotId >> 3] |= 0xFu << ((rotId & 7) * 4);
+}
+
 /// Convert a VRAM address to an OAM offset
 ///
 /// @param oam
@@ -448,6 +509,8 @@ static inline void oamSetBlendMode(OamState *oam, int id, SpriteMode mode)
     sassert(mode <= SpriteMode_Bitmap, "oamSetBlendMode() mode is invalid");
 
     oam->oamMemory[id].blendMode = (ObjBlendMode)mode;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Returns a SpriteSize enumeration value from dimensions in pixels.
@@ -521,6 +584,8 @@ static inline void oamSetXY(OamState *oam, int id, int x, int y)
 
     oam->oamMemory[id].x = x;
     oam->oamMemory[id].y = y;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets an OAM entry to the supplied priority.
@@ -541,6 +606,8 @@ static inline void oamSetPriority(OamState *oam, int id, int priority)
             "oamSetPriority() priority is out of bounds, must be 0-3");
 
     oam->oamMemory[id].priority = (ObjPriority)priority;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets a paletted OAM entry to the supplied palette.
@@ -564,6 +631,8 @@ static inline void oamSetPalette(OamState *oam, int id, int palette)
             "oamSetPalette() cannot set palette on a bitmapped sprite");
 
     oam->oamMemory[id].palette = palette;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets a bitmapped OAM entry to the supplied transparency.
@@ -587,6 +656,8 @@ static inline void oamSetAlpha(OamState *oam, int id, int alpha)
             "oamSetAlpha() cannot set alpha on a paletted sprite");
 
     oam->oamMemory[id].palette = alpha;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets an OAM entry to the supplied shape/size/pointer.
@@ -634,6 +705,8 @@ static inline void oamSetAffineIndex(OamState *oam, int id, int affineIndex,
         oam->oamMemory[id].isSizeDouble  = false;
         oam->oamMemory[id].isRotateScale = false;
     }
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets an OAM entry to the supplied hidden state.
@@ -654,6 +727,8 @@ static inline void oamSetHidden(OamState *oam, int id, bool hide)
             "oamSetHidden() cannot set hide on a RotateScale sprite");
 
     oam->oamMemory[id].isHidden = hide ? true : false;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets an OAM entry to the supplied flipping.
@@ -677,6 +752,8 @@ static inline void oamSetFlip(OamState *oam, int id, bool hflip, bool vflip)
 
     oam->oamMemory[id].hFlip = hflip ? true : false;
     oam->oamMemory[id].vFlip = vflip ? true : false;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Sets an OAM entry to enable or disable mosaic.
@@ -695,6 +772,8 @@ static inline void oamSetMosaicEnabled(OamState *oam, int id, bool mosaic)
             "oamSetMosaicEnabled() index is out of bounds, must be 0-127");
 
     oam->oamMemory[id].isMosaic = mosaic ? true : false;
+
+    oamMarkEntryDirty(oam, id);
 }
 
 /// Hides the sprites in the supplied range.
@@ -719,16 +798,59 @@ static inline void oamClearSprite(OamState *oam, int index)
             "oamClearSprite() index is out of bounds, must be 0-127");
 
     oam->oamMemory[index].attribute[0] = ATTR0_DISABLED;
+
+    oamMarkEntryDirty(oam, index);
 }
 
 /// Causes OAM to be updated.
 ///
-/// It must be called during vblank if using the OAM API.
+/// It must be called during vblank if using the OAM API. The way the data is
+/// copied depends on the mode set with oamSetUpdateMode().
 ///
 /// @param oam
 ///     Must be &oamMain or &oamSub.
 void oamUpdate(OamState *oam);
 
+/// Sets the way oamUpdate() copies the shadow OAM to OAM.
+///
+/// The default mode is OamUpdateMode_Full. The other modes only copy the
+/// entries that have been modified since the last update. They are useful when
+/// only a few sprites change every frame.
+///
+/// With OamUpdateMode_DirtyAsync the shadow OAM must not be modified until the
+/// transfer has finished (see oamUpdateWait()), and the DMA channel must not be
+/// used by anything else in the meantime. Channel 3 can't be used in this mode
+/// because it's used by dmaCopy() and other functions of libnds.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param mode
+///     The new update mode.
+/// @param dmaChannel
+///     DMA channel used by OamUpdateMode_DirtyAsync (0 - 2). The other modes
+///     don't use it, but it must still be between 0 and 3.
+///
+/// @return
+///     0 on success, -1 if the DMA channel isn't valid for the mode.
+int oamSetUpdateMode(OamState *oam, OamUpdateMode mode, int dmaChannel);
+
+/// Marks a range of OAM entries as modified.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param start
+///     The first entry.
+/// @param count
+///     The number of entries (zero will mark all entries).
+void oamMarkDirty(OamState *oam, int start, int count);
+
+/// Waits until the transfer started by oamUpdate() in OamUpdateMode_DirtyAsync
+/// mode ends.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+void oamUpdateWait(OamState *oam);
+
 /// Sets the specified rotation scale entry.
 ///
 /// @param oam
@@ -771,6 +893,8 @@ static inline void oamAffineTransformation(OamState *oam, int rotId, int hdx, in
     oam->oamRotationMemory[rotId].vdx = vdx;
     oam->oamRotationMemory[rotId].hdy = hdy;
     oam->oamRotationMemory[rotId].vdy = vdy;
+
+    oamMarkAffineDirty(oam, rotId);
 }
 
 /// Determines the number of fragments in the allocation engine.
@@ -784,6 +908,56 @@ int oamCountFragments(OamState *oam);
 
 void oamAllocReset(OamState *oam);
 
+/// Selects the allocator used by oamAllocateGfx() and oamFreeGfx().
+///
+/// All graphics allocated with the previous allocator are freed, so this
+/// should be called right after oamInit(). oamInit() resets the allocations,
+/// but it doesn't change the selected allocator.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param allocator
+///     The allocator to use.
+///
+/// @return
+///     0 on success, -1 on error (not enough memory).
+int oamSetAllocator(OamState *oam, OamAllocator allocator);
+
+/// Callback called by oamAllocCompact() for each block that has been moved.
+///
+/// @param oldGfx
+///     Previous address of the graphics in VRAM.
+/// @param newGfx
+///     New address of the graphics in VRAM.
+/// @param userdata
+///     Value passed to oamAllocCompact().
+typedef void (*OamRelocateFn)(const u16 *oldGfx, u16 *newGfx, void *userdata);
+
+/// Moves all blocks of sprite graphics to the start of sprite VRAM.
+///
+/// This only works with OamAllocator_Buddy and 1D sprite mappings. The blocks
+/// are sorted by size and packed so that all the free space ends up in one
+/// contiguous area at the end of sprite VRAM. The graphics are moved with DMA
+/// (using a temporary buffer in main RAM) and the tile index of all entries of
+/// the shadow OAM that pointed to a moved block is updated.
+///
+/// The graphics are moved right away, but OAM isn't updated until oamUpdate()
+/// is called, so this should be called during VBlank, followed by oamUpdate().
+/// Any pointer returned by oamAllocateGfx() that refers to a moved block must
+/// be updated by the caller, which is what the callback is for.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param callback
+///     Function called for each moved block, or NULL.
+/// @param userdata
+///     Value passed to the callback.
+///
+/// @return
+///     Number of blocks that have been moved, or -1 on error (wrong allocator
+///     or mapping, or not enough memory for the temporary buffer).
+int oamAllocCompact(OamState *oam, OamRelocateFn callback, void *userdata);
+
 #ifdef __cplusplus
 }
 #endif
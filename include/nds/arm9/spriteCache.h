@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/spriteCache.h
+///
+/// @brief Cache of sprite animation frames in VRAM.
+///
+/// Games with many animated sprites can't keep all animation frames in VRAM at
+/// the same time. This cache keeps the source of all frames in main RAM or in
+/// a file (for example, in NitroFS), and it only keeps the frames that are
+/// being displayed in VRAM.
+///
+/// Each frame is identified by an index. Sprites that display the same frame
+/// share the same copy in VRAM, which is reference counted. Frames registered
+/// from main RAM with the same contents as a frame registered before are
+/// merged with it too. When a frame isn't used anymore it stays in VRAM until
+/// the space is needed by another frame, and the least recently used frames
+/// are evicted first.
+///
+/// New frames are copied to VRAM by oamCacheUpdate(), which should be called
+/// during VBlank. It copies at most a given number of bytes every frame so
+/// that the copy doesn't exceed the VBlank period. Frames that haven't been
+/// copied yet are copied in the following calls, so oamCacheIsReady() should
+/// be checked before displaying a new frame.
+///
+/// Usage:
+///
+/// ```c
+/// oamInit(&oamMain, SpriteMapping_1D_32, false);
+/// oamCacheInit(&oamMain, NUM_FRAMES, 4 * 1024);
+///
+/// for (int i = 0; i < NUM_FRAMES; i++)
+///     oamCacheSetFrameRAM(&oamMain, i, &playerTiles[i * 512],
+///                         SpriteSize_32x32, SpriteColorFormat_256Color);
+///
+/// u16 *gfx = oamCacheAcquire(&oamMain, frame);
+///
+/// while (1)
+/// {
+///     // Change animation frame
+///     u16 *new_gfx = oamCacheAcquire(&oamMain, new_frame);
+///     ...
+///     if (oamCacheIsReady(&oamMain, new_frame))
+///     {
+///         oamCacheRelease(&oamMain, frame);
+///         gfx = new_gfx;
+///         frame = new_frame;
+///     }
+///
+///     oamSet(&oamMain, 0, x, y, 0, 0, SpriteSize_32x32,
+///            SpriteColorFormat_256Color, gfx, -1, false, false, false, false,
+///            false);
+///
+///     swiWaitForVBlank();
+///     oamCacheUpdate(&oamMain);
+///     oamUpdate(&oamMain);
+/// }
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_SPRITECACHE_H__
+#define LIBNDS_NDS_ARM9_SPRITECACHE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include <nds/arm9/sprite.h>
+#include <nds/ndstypes.h>
+
+/// Statistics of a sprite frame cache.
+typedef struct OamCacheStats
+{
+    u32 hits;           ///< Acquired frames that were already in VRAM
+    u32 misses;         ///< Acquired frames that had to be copied to VRAM
+    u32 evictions;      ///< Frames removed from VRAM to make space
+    u32 failures;       ///< Acquired frames that didn't fit in VRAM
+    u32 bytesUploaded;  ///< Bytes copied to VRAM by the last oamCacheUpdate()
+    u16 resident;       ///< Frames currently in VRAM
+    u16 pending;        ///< Frames waiting to be copied to VRAM
+} OamCacheStats;
+
+/// Initializes the frame cache of a 2D engine.
+///
+/// oamInit() must have been called before. If the cache had already been
+/// initialized, all its frames are removed from VRAM and unregistered.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param numFrames
+///     Number of frames that can be registered.
+/// @param uploadBudget
+///     Maximum number of bytes copied to VRAM by each call to
+///     oamCacheUpdate(). At least one frame is always copied if there are
+///     pending frames.
+///
+/// @return
+///     0 on success, -1 on error (invalid arguments or not enough memory).
+int oamCacheInit(OamState *oam, int numFrames, size_t uploadBudget);
+
+/// Frees the frame cache of a 2D engine and the VRAM used by its frames.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+void oamCacheDeinit(OamState *oam);
+
+/// Registers a frame whose graphics are stored in main RAM.
+///
+/// The data isn't copied, so it must remain valid while the cache is used. If
+/// the contents are the same as the ones of another frame registered from RAM
+/// with the same size in bytes, both frames share the same copy in VRAM.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param frame
+///     Frame index (0 to numFrames - 1).
+/// @param data
+///     Graphics of the frame.
+/// @param size
+///     Size of the sprite.
+/// @param format
+///     Color format of the sprite.
+///
+/// @return
+///     0 on success, -1 on error (invalid frame, the frame is in use or other
+///     frames share its graphics).
+int oamCacheSetFrameRAM(OamState *oam, int frame, const void *data,
+                        SpriteSize size, SpriteColorFormat format);
+
+/// Registers a frame whose graphics are stored in a file.
+///
+/// The file isn't closed by the cache, and it must remain open while the cache
+/// is used. The graphics are read from the file by oamCacheAcquire() when the
+/// frame isn't in VRAM, so that oamCacheUpdate() doesn't need to access the
+/// filesystem.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param frame
+///     Frame index (0 to numFrames - 1).
+/// @param file
+///     File that contains the graphics (for example, opened from NitroFS).
+/// @param offset
+///     Offset of the graphics in the file.
+/// @param size
+///     Size of the sprite.
+/// @param format
+///     Color format of the sprite.
+///
+/// @return
+///     0 on success, -1 on error (invalid frame, the frame is in use or other
+///     frames share its graphics).
+int oamCacheSetFrameFile(OamState *oam, int frame, FILE *file, long offset,
+                         SpriteSize size, SpriteColorFormat format);
+
+/// Gets a reference to a frame and returns its address in VRAM.
+///
+/// If the frame isn't in VRAM, space is allocated for it (evicting unused
+/// frames if required) and it's queued to be copied by oamCacheUpdate().
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param frame
+///     Frame index.
+///
+/// @return
+///     Address of the frame in VRAM, or NULL on error (invalid frame, not
+///     enough VRAM, or the file couldn't be read).
+u16 *oamCacheAcquire(OamState *oam, int frame);
+
+/// Releases a reference to a frame obtained with oamCacheAcquire().
+///
+/// When a frame has no references it stays in VRAM until the space is needed.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param frame
+///     Frame index.
+void oamCacheRelease(OamState *oam, int frame);
+
+/// Returns true if the graphics of a frame have been copied to VRAM.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param frame
+///     Frame index.
+///
+/// @return
+///     True if the frame is in VRAM and it can be displayed.
+bool oamCacheIsReady(OamState *oam, int frame);
+
+/// Copies pending frames to VRAM.
+///
+/// It should be called during VBlank. It copies frames in the order in which
+/// they have been acquired until the upload budget is used.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+void oamCacheUpdate(OamState *oam);
+
+/// Removes all unused frames from VRAM.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+void oamCacheFlush(OamState *oam);
+
+/// Returns the statistics of the frame cache of a 2D engine.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+///
+/// @return
+///     Pointer to the statistics, or NULL if the cache isn't initialized.
+const OamCacheStats *oamCacheGetStats(OamState *oam);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_SPRITECACHE_H__
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/spriteMux.h
+///
+/// @brief Sprite multiplexer to display more than 128 sprites per screen.
+///
+/// The 2D engines can only display 128 sprites per frame. However, the OAM can
+/// be modified while the screen is being drawn, so an OAM entry whose sprite
+/// has already been drawn can be reused by another sprite that is displayed
+/// further down the screen.
+///
+/// The multiplexer keeps a list of logical sprites that can be larger than 128
+/// entries. Every frame it sorts the list by Y coordinate and assigns OAM
+/// entries to the sprites in a round-robin way. The first 128 sprites are
+/// written to the shadow OAM of the OamState and copied to OAM during VBlank.
+/// The following ones are grouped in bands: each band is a range of OAM
+/// entries that is rewritten with a HBlank DMA transfer started from the VCOUNT
+/// interrupt handler at the right scanline.
+///
+/// Sorting and assigning OAM entries to up to 1024 sprites takes too long to
+/// be done during VBlank, so it's done by oamMuxPrepare() while the previous
+/// frame is being drawn. The bands are double buffered, and oamMuxCommit() only
+/// has to swap the buffers and copy the shadow OAM to OAM during VBlank.
+///
+/// A sprite can only reuse an OAM entry if the previous sprite in that entry
+/// ends at least one scanline before the new sprite starts. If there are too
+/// many sprites in the same scanlines some of them won't be displayed. This is
+/// reported by oamMuxGetStats(), together with the number of sprites and the
+/// number of sprite rendering cycles used in each scanline (the hardware can
+/// only draw a limited number of sprite pixels per scanline).
+///
+/// The multiplexer uses the affine matrices of the OamState. They are shared
+/// by all sprites of the frame, so they can be set with oamRotateScale() and
+/// oamAffineTransformation() as usual.
+///
+/// Only one multiplexer can be active at the same time (for the main or the sub
+/// engine), as it uses the VCOUNT interrupt.
+///
+/// Usage:
+///
+/// ```c
+/// oamInit(&oamMain, SpriteMapping_1D_32, false);
+/// oamMuxInit(&oamMain, 512, 0);
+///
+/// while (1)
+/// {
+///     for (int i = 0; i < 512; i++)
+///     {
+///         oamMuxSet(i, bullet[i].x, bullet[i].y, 0, 0, SpriteSize_8x8,
+///                   SpriteColorFormat_16Color, bullet_gfx, -1, false,
+///                   !bullet[i].active, false, false, false);
+///     }
+///
+///     oamMuxPrepare();
+///
+///     swiWaitForVBlank();
+///     oamMuxCommit(); // Replaces oamUpdate()
+/// }
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_SPRITEMUX_H__
+#define LIBNDS_NDS_ARM9_SPRITEMUX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <nds/arm9/sprite.h>
+#include <nds/ndstypes.h>
+
+/// Number of cycles that the 2D engine can spend drawing sprites per scanline.
+#define OAM_MUX_LINE_CYCLES         1210
+/// Same as OAM_MUX_LINE_CYCLES if DISPLAY_SPR_HBLANK is set in REG_DISPCNT.
+#define OAM_MUX_LINE_CYCLES_HBLANK  954
+
+/// Statistics of the last frame prepared by oamMuxPrepare().
+typedef struct OamMuxStats
+{
+    u16 visible;            ///< Logical sprites that are on the screen
+    u16 dropped;            ///< Visible sprites that couldn't get an OAM entry
+    u16 bands;              ///< Number of OAM rewrites during the frame
+    u16 max_line_sprites;   ///< Highest number of sprites in one scanline
+    u16 max_line_cycles;    ///< Highest number of sprite cycles in one scanline
+    u16 busiest_line;       ///< Scanline with the highest number of cycles
+    u16 overflow_lines;     ///< Scanlines that exceed the cycle budget
+} OamMuxStats;
+
+/// Starts the sprite multiplexer.
+///
+/// oamInit() must have been called for the OamState before calling this. It
+/// sets the handler of the VCOUNT interrupt and enables it.
+///
+/// @param oam
+///     Must be &oamMain or &oamSub.
+/// @param max_sprites
+///     Number of logical sprites (up to 1024).
+/// @param dma_channel
+///     DMA channel used to update OAM during HBlank (0 to 3). It must not be
+///     used by anything else while the screen is being drawn.
+///
+/// @return
+///     1 on success, 0 on failure (invalid arguments or not enough memory).
+int oamMuxInit(OamState *oam, int max_sprites, int dma_channel);
+
+/// Stops the sprite multiplexer and frees its memory.
+///
+/// It disables the VCOUNT interrupt and removes its handler.
+void oamMuxDeinit(void);
+
+/// Sets all the attributes of a logical sprite.
+///
+/// The arguments are the same ones as in oamSet(), but the Y coordinate can be
+/// outside of the range of the hardware.
+///
+/// @param id
+///     Logical sprite index (0 to max_sprites - 1).
+/// @param x
+///     X location of the sprite.
+/// @param y
+///     Y location of the sprite.
+/// @param priority
+///     Sprite priority (0 to 3).
+/// @param palette_alpha
+///     Palette index for 16 color sprites, alpha for bitmap sprites.
+/// @param size
+///     The size of the sprite.
+/// @param format
+///     The color format of the sprite.
+/// @param gfxOffset
+///     Pointer to the graphics in VRAM.
+/// @param affineIndex
+///     Affine matrix to use (0 to 31), or -1 to disable affine transformations.
+/// @param sizeDouble
+///     If affineIndex is valid, this doubles the bounds of the sprite.
+/// @param hide
+///     If non zero, the sprite isn't displayed.
+/// @param hflip
+///     Flip the sprite horizontally.
+/// @param vflip
+///     Flip the sprite vertically.
+/// @param mosaic
+///     Enable the mosaic effect.
+void oamMuxSet(int id, int x, int y, int priority, int palette_alpha,
+               SpriteSize size, SpriteColorFormat format, const void *gfxOffset,
+               int affineIndex, bool sizeDouble, bool hide, bool hflip,
+               bool vflip, bool mosaic);
+
+/// Sets the position of a logical sprite.
+///
+/// @param id
+///     Logical sprite index.
+/// @param x
+///     X location of the sprite.
+/// @param y
+///     Y location of the sprite.
+void oamMuxSetXY(int id, int x, int y);
+
+/// Hides or shows a logical sprite.
+///
+/// @param id
+///     Logical sprite index.
+/// @param hide
+///     True to hide the sprite.
+void oamMuxSetHidden(int id, bool hide);
+
+/// Hides all logical sprites.
+void oamMuxClear(void);
+
+/// Prepares the OAM updates of the next frame.
+///
+/// It sorts the logical sprites, writes the first 128 ones to the shadow OAM
+/// and builds the list of OAM rewrites of the next frame. It's slow, so it
+/// should be called outside of VBlank, after the last call to oamMuxCommit()
+/// and before the next one. The affine matrices must be set before calling it.
+void oamMuxPrepare(void);
+
+/// Starts displaying the frame prepared by oamMuxPrepare().
+///
+/// It copies the shadow OAM to OAM and sets up the OAM rewrites of the frame.
+/// It must be called during VBlank, instead of oamUpdate(). If no frame has
+/// been prepared since the last call, the previous frame is displayed again.
+void oamMuxCommit(void);
+
+/// Calls oamMuxPrepare() and oamMuxCommit().
+///
+/// With many sprites oamMuxPrepare() may not finish before the end of VBlank,
+/// so it's better to call them separately.
+void oamMuxUpdate(void);
+
+/// Returns the statistics of the last frame prepared by oamMuxPrepare().
+///
+/// @return
+///     Pointer to the statistics.
+const OamMuxStats *oamMuxGetStats(void);
+
+/// Returns the sprite rendering cycles needed by a scanline in the last frame
+/// prepared by oamMuxPrepare().
+///
+/// Compare the result with OAM_MUX_LINE_CYCLES or OAM_MUX_LINE_CYCLES_HBLANK.
+///
+/// @param line
+///     Scanline (0 to 191).
+///
+/// @return
+///     Number of cycles, or -1 if the scanline isn't valid.
+int oamMuxGetLineCycles(int line);
+
+/// Returns the number of sprites displayed in a scanline in the last frame
+/// prepared by oamMuxPrepare().
+///
+/// @param line
+///     Scanline (0 to 191).
+///
+/// @return
+///     Number of sprites, or -1 if the scanline isn't valid.
+int oamMuxGetLineSprites(int line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_SPRITEMUX_H__
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/tilePool.h
+///
+/// @brief Runtime deduplication of background tiles.
+///
+/// Tilesets usually contain tiles that are identical to other tiles, or that
+/// are flipped versions of other tiles. A tile pool stores each unique tile
+/// once in the tile base of a background, and rewrites the map entries that
+/// use duplicated tiles so that they point to the stored tile, setting the
+/// flip bits of the entry if required.
+///
+/// The same pool can be shared by several layers that use the same tile base,
+/// so that tiles that appear in more than one layer are only stored once.
+///
+/// Tiles are looked up with a hash table. The hash of each stored tile is kept
+/// in main RAM, so the stored tiles are only read back to confirm matches.
+///
+/// This module doesn't access any hardware register: the destination of the
+/// tiles can be VRAM or a buffer in main RAM.
+///
+/// Usage:
+///
+/// ```c
+/// int bg0 = bgInit(0, BgType_Text4bpp, BgSize_T_256x256, 0, 1);
+/// int bg1 = bgInit(1, BgType_Text4bpp, BgSize_T_256x256, 1, 1);
+///
+/// TilePool pool;
+/// tilePoolInit(&pool, bgGetGfxPtr(bg0), 1024, 4);
+///
+/// // Tiles and maps loaded with grfLoadMem() or similar functions
+/// tilePoolAddMap(&pool, tiles0, tiles0Count, map0, bgGetMapPtr(bg0), 32 * 32);
+/// tilePoolAddMap(&pool, tiles1, tiles1Count, map1, bgGetMapPtr(bg1), 32 * 32);
+///
+/// // The pool is only needed to add more tiles later
+/// tilePoolDeinit(&pool);
+/// ```
+
+#ifndef LIBNDS_NDS_ARM9_TILEPOOL_H__
+#define LIBNDS_NDS_ARM9_TILEPOOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include <nds/ndstypes.h>
+
+/// Maximum number of tiles that can be referenced by a map entry.
+#define TILE_POOL_MAX_TILES 1024
+
+/// State of a tile pool.
+typedef struct TilePool
+{
+    u32 *gfx;           ///< Destination of the unique tiles
+    int bpp;            ///< Bits per pixel of the tiles (4 or 8)
+    int maxTiles;       ///< Maximum number of tiles in the pool
+    int numTiles;       ///< Number of tiles stored in the pool
+    u32 *hashes;        ///< Hash of each stored tile
+    u16 *next;          ///< Next tile with the same bucket (index + 1)
+    u16 *buckets;       ///< First tile of each bucket (index + 1)
+    u32 bucketMask;     ///< Number of buckets minus one
+} TilePool;
+
+/// Initializes an empty tile pool.
+///
+/// @param pool
+///     Pool to initialize.
+/// @param gfx
+///     Destination of the tiles, like the pointer returned by bgGetGfxPtr(). It
+///     must be aligned to 4 bytes.
+/// @param maxTiles
+///     Maximum number of tiles that can be stored (1 to TILE_POOL_MAX_TILES).
+/// @param bpp
+///     Bits per pixel of the tiles (4 or 8).
+///
+/// @return
+///     0 on success, -1 on error (invalid arguments or not enough memory).
+int tilePoolInit(TilePool *pool, void *gfx, int maxTiles, int bpp);
+
+/// Frees the memory used by a tile pool.
+///
+/// The tiles that have been stored in the destination aren't modified.
+///
+/// @param pool
+///     Pool to free.
+void tilePoolDeinit(TilePool *pool);
+
+/// Removes all tiles from a tile pool.
+///
+/// @param pool
+///     Pool to reset.
+void tilePoolReset(TilePool *pool);
+
+/// Adds a tile to a tile pool, unless it's already in the pool.
+///
+/// @param pool
+///     Pool.
+/// @param tile
+///     Tile data (32 bytes for 4 bpp tiles, 64 bytes for 8 bpp tiles). It must
+///     be aligned to 4 bytes.
+///
+/// @return
+///     The map entry that displays the tile (the tile index, with TILE_FLIP_H
+///     and TILE_FLIP_V set if the stored tile is a flipped version of the tile)
+///     or -1 if the pool is full.
+int tilePoolAddTile(TilePool *pool, const void *tile);
+
+/// Adds the tiles used by a map to a tile pool and rewrites the map.
+///
+/// Only the tiles that are used by the map are added to the pool. The tile
+/// index and flip bits of the entries are adjusted to use the tiles of the
+/// pool. The palette bits are preserved.
+///
+/// If there isn't enough space in the pool the destination map isn't modified,
+/// but some of the tiles may have been added to the pool.
+///
+/// @param pool
+///     Pool.
+/// @param tiles
+///     Tileset used by the source map. It must be aligned to 4 bytes.
+/// @param numTiles
+///     Number of tiles in the tileset.
+/// @param srcMap
+///     Map entries that use the tileset.
+/// @param dstMap
+///     Destination of the rewritten map entries. It can be the same as srcMap,
+///     and it can be in VRAM.
+/// @param numEntries
+///     Number of map entries.
+///
+/// @return
+///     0 on success, -1 on error (the pool is full, the map uses tiles that
+///     aren't in the tileset or there isn't enough memory).
+int tilePoolAddMap(TilePool *pool, const void *tiles, int numTiles,
+                   const u16 *srcMap, u16 *dstMap, size_t numEntries);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_TILEPOOL_H__
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+/// @file nds/arm9/videoCapture.h
+///
+/// @brief Dual-screen 3D and render-to-texture using display capture.
+///
+/// The 3D engine can only display its output on the screen of the main engine.
+/// The display capture circuit can save the output of the 3D engine in a VRAM
+/// bank while it's being displayed, which can be used for two things:
+///
+/// - Dual-screen 3D: The main engine is swapped between the top and bottom
+///   screens every frame. The frame rendered for one screen is captured and
+///   displayed by the sub engine on the other screen during the next frame, so
+///   each screen shows 3D graphics at 30 FPS. VRAM banks C and D are used for
+///   this. They are rotated every frame: one is used as capture destination
+///   while the other one is displayed by the sub engine, as a 16-bit bitmap
+///   background (bank C) or as a grid of 64x64 bitmap sprites (bank D).
+///
+/// - Render-to-texture: The output of the 3D engine is captured directly into
+///   the VRAM of a GL_RGBA texture so that it can be used in the next frames.
+///
+/// All VRAM bank changes are done by videoCaptureVBlank(), which must be called
+/// once per frame during the vertical blanking period, so the CPU never needs
+/// to copy any pixel and there is no tearing:
+///
+/// ```c
+/// glInit();
+/// videoDual3DInit();
+///
+/// while (1)
+/// {
+///     if (videoDual3DIsTopScreen())
+///         draw_top_screen_scene();
+///     else
+///         draw_bottom_screen_scene();
+///
+///     glFlush(0);
+///     swiWaitForVBlank();
+///     videoCaptureVBlank();
+/// }
+/// ```
+///
+/// videoCaptureVBlank() can also be used as VBlank interrupt handler with
+/// irqSet(), but only if the game never takes more than one frame to draw a
+/// scene. If it does, the captured frames end up on the wrong screen.
+
+#ifndef LIBNDS_NDS_ARM9_VIDEOCAPTURE_H__
+#define LIBNDS_NDS_ARM9_VIDEOCAPTURE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/// Starts dual-screen 3D mode.
+///
+/// This takes control of VRAM banks C and D and of the sub engine (video mode,
+/// background 2 and OAM). Banks C and D are locked with glLockVRAMBank() so
+/// that videoGL doesn't allocate textures in them, which means that glInit()
+/// must be called before this function. The main engine must be set to a video
+/// mode with 3D enabled by the caller.
+///
+/// Background 2 of the sub engine is set up with bgInitSub(), so it works with
+/// the shadow registers enabled by bgShadowEnable().
+///
+/// @return
+///     1 on success, 0 on failure (dual-screen 3D mode is already active, a
+///     render-to-texture capture is in progress, videoGL has textures in banks
+///     C or D, or the banks can't be locked). Banks C and D aren't modified if
+///     it fails.
+int videoDual3DInit(void);
+
+/// Stops dual-screen 3D mode.
+///
+/// The main engine is left on the top screen. Banks C and D are left mapped to
+/// LCD mode and unlocked.
+///
+/// @return
+///     1 on success, 0 if dual-screen 3D mode wasn't active or the banks
+///     couldn't be unlocked.
+int videoDual3DDeinit(void);
+
+/// Returns the screen that the scene drawn in this frame will be shown on.
+///
+/// @return
+///     True for the top screen, false for the bottom screen.
+bool videoDual3DIsTopScreen(void);
+
+/// Allocates the VRAM of a texture so that it can be used with
+/// videoCaptureTexture().
+///
+/// The texture is converted to a GL_RGBA texture and its previous data is
+/// discarded. Its address is aligned so that the capture circuit can write to
+/// it. The valid sizes are 128x128, 256x64, 256x128 and 256x256. The capture
+/// circuit can only write 192 lines, so the last 64 lines of 256x256 textures
+/// are never written.
+///
+/// This isn't an actual OpenGL function.
+///
+/// @param name
+///     Texture name created with glGenTextures().
+/// @param width
+///     Width of the texture in pixels.
+/// @param height
+///     Height of the texture in pixels.
+///
+/// @return
+///     1 on success, 0 on failure (invalid name or size, or not enough VRAM).
+int videoCaptureTextureInit(int name, int width, int height);
+
+/// Captures the next frame rendered by the 3D engine into a texture.
+///
+/// The scene that is sent to the geometry engine before the next call to
+/// glFlush() is captured into the texture, starting from the top left corner
+/// of the screen. Use glViewport() to render the scene with the size of the
+/// texture.
+///
+/// The VRAM bank of the texture is mapped to LCD mode while the frame is
+/// captured, so the captured scene can't use textures stored in the same bank.
+/// The rendered scene is also displayed on the screen during that frame (it can
+/// be hidden with setBrightness(), for example).
+///
+/// The texture can already be used by the scene drawn in the next frame: the
+/// capture ends before that scene starts to be rendered.
+///
+/// This can't be used in dual-screen 3D mode, which uses the capture circuit
+/// every frame.
+///
+/// @param name
+///     Texture name prepared with videoCaptureTextureInit().
+///
+/// @return
+///     1 on success, 0 if the texture isn't valid or the capture circuit is
+///     busy.
+int videoCaptureTexture(int name);
+
+/// Returns true if a render-to-texture capture hasn't finished yet.
+///
+/// @return
+///     True if a capture is pending or in progress.
+bool videoCaptureIsBusy(void);
+
+/// Updates the state of the capture circuit and rotates VRAM banks.
+///
+/// It must be called once per frame during the vertical blanking period, right
+/// after the scene drawn in that frame has been flushed with glFlush().
+void videoCaptureVBlank(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBNDS_NDS_ARM9_VIDEOCAPTURE_H__
@@ -47,6 +47,20 @@ static inline u32 systemCounterTicksToUsec(u32 ticks)
     return (((u64)ticks) * 1000000) / (BUS_CLOCK / 64);
 }
 
+/// Converts system counter ticks to microseconds (64-bit version).
+///
+/// It can convert the result of subtracting two values returned by
+/// systemCounterGetTicks() even if they are more than 2^32 ticks apart.
+///
+/// @param ticks
+///     Number of ticks.
+/// @return
+///     Number of microseconds.
+static inline u64 systemCounterTicksToUsec64(u64 ticks)
+{
+    return (ticks * 1000000) / (BUS_CLOCK / 64);
+}
+
 /// Converts system counter ticks to milliseconds.
 ///
 /// @param ticks
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef SYS_UIO_H__
+#define SYS_UIO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Maximum number of elements of an iovec array
+#ifndef IOV_MAX
+#define IOV_MAX 64
+#endif
+
+struct iovec
+{
+    void *iov_base;
+    size_t iov_len;
+};
+
+// lwIP defines its own struct iovec unless this macro is defined
+#define iovec iovec
+
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+ssize_t preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+ssize_t pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYS_UIO_H__
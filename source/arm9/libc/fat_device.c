@@ -13,8 +13,20 @@
 #include <nds/arm9/device_io.h>
 
 #include "device_io_internal.h"
+#include "fat_device.h"
+#include "fat_dircache.h"
+#include "fat_freemap.h"
+#include "fat_linkmap.h"
 #include "filesystem_includes.h"
 
+// Flags of FIL.flag that are private to ff.c
+#ifndef FA_MODIFIED
+#define FA_MODIFIED 0x40 // The file has been modified
+#endif
+#ifndef FA_DIRTY
+#define FA_DIRTY    0x80 // FIL.buf[] needs to be written back
+#endif
+
 int fat_open(const char *path, int flags, mode_t mode_)
 {
     (void)mode_;
@@ -96,28 +108,38 @@ int fat_open(const char *path, int flags, mode_t mode_)
         mode |= FA_OPEN_EXISTING; // r
     }
 
-    FIL *fp = calloc(1, sizeof(FIL));
-    if (fp == NULL)
+    fat_file_t *file = calloc(1, sizeof(fat_file_t));
+    if (file == NULL)
     {
         errno = ENOMEM;
         return -1;
     }
 
-    FRESULT result = f_open(fp, path, mode);
+    // Creating or truncating files changes the information of the entries
+    if (can_write)
+        fat_dircache_invalidate();
+
+    FRESULT result = f_open(&file->fil, path, mode);
 
     if (result == FR_OK)
-        return FD_FAT_PACK(fp);
+    {
+        fat_linkmap_create(file);
+        return FD_FAT_PACK(&file->fil);
+    }
 
-    free(fp);
+    free(file);
     errno = fatfs_error_to_posix(result);
     return -1;
 }
 
 ssize_t fat_read(int fd, void *ptr, size_t len)
 {
-    FIL *fp = FD_FAT_UNPACK(fd);
+    fat_file_t *file = fat_file_from_fd(fd);
+    FIL *fp = &file->fil;
     UINT bytes_read = 0;
 
+    fat_linkmap_touch(file);
+
     FRESULT result = f_read(fp, ptr, len, &bytes_read);
 
     if (result == FR_OK)
@@ -127,24 +149,230 @@ ssize_t fat_read(int fd, void *ptr, size_t len)
     return -1;
 }
 
+// Writes as many whole sectors as possible to the area of the file allocated by
+// fat_preallocate(). The clusters of that area are contiguous, so there is no
+// need to read the FAT to find them. It returns the number of bytes written.
+static ssize_t fat_write_contiguous(fat_file_t *file, const void *ptr, size_t len)
+{
+    FIL *fp = &file->fil;
+    FATFS *fs = fp->obj.fs;
+    FSIZE_t fptr = f_tell(fp);
+
+    // Let FatFs handle partial sectors and report errors
+    if ((fp->err != 0) || ((fptr % FF_MAX_SS) != 0) || (fptr >= file->contig_size))
+        return 0;
+
+    size_t count = len / FF_MAX_SS;
+    size_t available = (file->contig_size - fptr) / FF_MAX_SS;
+    if (count > available)
+        count = available;
+    if (count == 0)
+        return 0;
+
+    // Other threads may be using the same volume
+    ff_mutex_take(fs->ldrv);
+
+    // The sector buffer of the file may have data that hasn't been written yet
+    if (fp->flag & FA_DIRTY)
+    {
+        if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK)
+        {
+            ff_mutex_give(fs->ldrv);
+            errno = EIO;
+            return -1;
+        }
+        fp->flag &= ~FA_DIRTY;
+    }
+
+    LBA_t sect = file->contig_sect + (fptr / FF_MAX_SS);
+
+    DRESULT result = disk_write(fs->pdrv, ptr, sect, count);
+
+    ff_mutex_give(fs->ldrv);
+
+    if (result != RES_OK)
+    {
+        errno = EIO;
+        return -1;
+    }
+
+    // If the sector in the buffer of the file has been overwritten, refresh it
+    if ((fp->sect - sect) < count)
+        memcpy(fp->buf, (const BYTE *)ptr + ((fp->sect - sect) * FF_MAX_SS), FF_MAX_SS);
+
+    size_t size = count * FF_MAX_SS;
+
+    // FatFs expects "clust" to be the cluster that contains the byte right
+    // before the file pointer.
+    fp->fptr += size;
+    fp->clust = fp->obj.sclust + ((fp->fptr - 1) / ((FSIZE_t)fs->csize * FF_MAX_SS));
+    fp->flag |= FA_MODIFIED;
+
+    return size;
+}
+
 ssize_t fat_write(int fd, const void *ptr, size_t len)
 {
-    FIL *fp = FD_FAT_UNPACK(fd);
+    fat_file_t *file = fat_file_from_fd(fd);
+    FIL *fp = &file->fil;
     UINT bytes_written = 0;
+    ssize_t bytes_direct = 0;
+
+    fat_dircache_invalidate();
+
+    if (file->contig_size > 0)
+    {
+        bytes_direct = fat_write_contiguous(file, ptr, len);
+        if (bytes_direct < 0)
+            return -1;
+
+        ptr = (const char *)ptr + bytes_direct;
+        len -= bytes_direct;
+
+        if (len == 0)
+            return bytes_direct;
+    }
+
+    // If the file may grow, tell FatFs where to find free clusters
+    if (fat_freemap_active && ((f_tell(fp) + len) > f_size(fp)))
+        fat_freemap_hint(fp->obj.fs);
 
     FRESULT result = f_write(fp, ptr, len, &bytes_written);
 
     if (result == FR_OK)
-        return bytes_written;
+        return bytes_direct + bytes_written;
+
+    // Report the data that has been written before the error
+    if (bytes_direct > 0)
+        return bytes_direct;
 
     errno = fatfs_error_to_posix(result);
     return -1;
 }
 
+// Each buffer is passed to FatFs as it is. The sectors that FatFs transfers
+// whole are sent to disk_read() or disk_write() with the buffer of the caller,
+// and they are copied by the driver straight from or to the buffer if it's in
+// main RAM.
+
+ssize_t fat_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+
+    for (int i = 0; i < iovcnt; i++)
+    {
+        ssize_t ret = fat_read(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret == -1)
+            return total > 0 ? total : -1;
+
+        total += ret;
+
+        // End of file
+        if ((size_t)ret < iov[i].iov_len)
+            break;
+    }
+
+    return total;
+}
+
+ssize_t fat_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+
+    for (int i = 0; i < iovcnt; i++)
+    {
+        ssize_t ret = fat_write(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret == -1)
+            return total > 0 ? total : -1;
+
+        total += ret;
+
+        // The filesystem is full
+        if ((size_t)ret < iov[i].iov_len)
+            break;
+    }
+
+    return total;
+}
+
+static int ftruncate_internal(int fd, off_t length);
+
+static ssize_t fat_positioned_io(int fd, const struct iovec *iov, int iovcnt,
+                                 off_t offset, bool write)
+{
+    FIL *fp = FD_FAT_UNPACK(fd);
+
+    if (offset < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // If the file is opened for writing, f_lseek() would make it bigger
+    if (!write && ((FSIZE_t)offset >= f_size(fp)))
+        return 0;
+
+    FSIZE_t prev_offset = f_tell(fp);
+
+    FRESULT result;
+    ssize_t ret;
+    int ret_errno;
+
+    // f_lseek() past the end of the file makes it bigger, but the contents of
+    // the new area are undefined. POSIX requires the gap to read as zeroes, so
+    // fill it the same way as ftruncate().
+    if (write && ((FSIZE_t)offset > f_size(fp)))
+    {
+        if (ftruncate_internal(fd, offset) != 0)
+        {
+            ret = -1;
+            ret_errno = errno;
+            goto restore;
+        }
+    }
+
+    result = f_lseek(fp, offset);
+    if (result != FR_OK)
+    {
+        ret = -1;
+        ret_errno = fatfs_error_to_posix(result);
+        goto restore;
+    }
+
+    ret = write ? fat_writev(fd, iov, iovcnt) : fat_readv(fd, iov, iovcnt);
+    ret_errno = errno;
+
+restore:
+    // The file pointer must not be modified
+    result = f_lseek(fp, prev_offset);
+    if (result != FR_OK)
+    {
+        errno = fatfs_error_to_posix(result);
+        return -1;
+    }
+
+    errno = ret_errno;
+    return ret;
+}
+
+ssize_t fat_preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    return fat_positioned_io(fd, iov, iovcnt, offset, false);
+}
+
+ssize_t fat_pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    return fat_positioned_io(fd, iov, iovcnt, offset, true);
+}
+
 int fat_fsync(int fd)
 {
     FIL *fp = FD_FAT_UNPACK(fd);
 
+    // The size and timestamps of the directory entry are updated
+    if (fp->flag & FA_WRITE)
+        fat_dircache_invalidate();
+
     FRESULT result = f_sync(fp);
 
     if (result == FR_OK)
@@ -158,11 +386,16 @@ int fat_close(int fd)
 {
     FIL *fp = FD_FAT_UNPACK(fd);
 
+    if (fp->flag & FA_WRITE)
+        fat_dircache_invalidate();
+
     FRESULT result = f_close(fp);
 
+    fat_linkmap_detach(fat_file_from_fd(fd));
+
     if (fp->cltbl != NULL)
         free(fp->cltbl);
-    free(fp);
+    free(fat_file_from_fd(fd));
 
     if (result == FR_OK)
         return 0;
@@ -173,19 +406,24 @@ int fat_close(int fd)
 
 off_t fat_lseek(int fd, off_t offset, int whence)
 {
-    FIL *fp = FD_FAT_UNPACK(fd);
+    fat_file_t *file = fat_file_from_fd(fd);
+    FIL *fp = &file->fil;
+
+    fat_linkmap_touch(file);
+
+    // exFAT files can be bigger than what fits in off_t, so the new position
+    // is calculated with 64-bit values.
+    int64_t position = offset;
 
     if (whence == SEEK_END)
     {
         // The file offset is set to the size of the file plus offset bytes
-        whence = SEEK_SET;
-        offset += f_size(fp);
+        position += f_size(fp);
     }
     else if (whence == SEEK_CUR)
     {
         // The file offset is set to its current location plus offset bytes
-        whence = SEEK_SET;
-        offset += f_tell(fp);
+        position += f_tell(fp);
     }
     else if (whence == SEEK_SET)
     {
@@ -197,10 +435,22 @@ off_t fat_lseek(int fd, off_t offset, int whence)
         return -1;
     }
 
-    FRESULT result = f_lseek(fp, offset);
+    if (position < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((off_t)position != position)
+    {
+        errno = EOVERFLOW;
+        return -1;
+    }
+
+    FRESULT result = f_lseek(fp, position);
 
     if (result == FR_OK)
-        return offset;
+        return position;
 
     errno = fatfs_error_to_posix(result);
     return -1;
@@ -208,6 +458,8 @@ off_t fat_lseek(int fd, off_t offset, int whence)
 
 int fat_unlink(const char *name)
 {
+    fat_dircache_invalidate();
+
     FRESULT result = f_unlink(name);
 
     if (result == FR_OK)
@@ -219,6 +471,8 @@ int fat_unlink(const char *name)
 
 int fat_rmdir(const char *name)
 {
+    fat_dircache_invalidate();
+
     FRESULT result = f_rmdir(name);
 
     if (result == FR_OK)
@@ -228,36 +482,54 @@ int fat_rmdir(const char *name)
     return -1;
 }
 
-int fat_stat(const char *path, struct stat *st)
+// Looks for the information of an entry in the directory entry cache before
+// looking for it in the filesystem.
+static FRESULT fat_stat_cached(const char *path, FILINFO *fno)
 {
-    FILINFO fno = { 0 };
-    FRESULT result = f_stat(path, &fno);
+    if (fat_dircache_lookup(path, fno))
+        return FR_OK;
 
-    if (result != FR_OK)
+    FRESULT result = f_stat(path, fno);
+
+    if ((result == FR_OK) && fat_dircache_enabled()
+        && fat_dircache_path_is_cacheable(path))
+        fat_dircache_insert(path, NULL, fno);
+
+    return result;
+}
+
+// Returns 0 on success, -1 if the size of the file doesn't fit in st_size
+static int fat_filinfo_to_stat(const FILINFO *fno, struct stat *st)
+{
+    // exFAT files can be bigger than what fits in off_t
+    if ((FSIZE_t)(off_t)fno->fsize != fno->fsize)
     {
-        errno = fatfs_error_to_posix(result);
+        errno = EOVERFLOW;
         return -1;
     }
 
     // On FatFS, st_dev is either 0 (DLDI) or 1 (DSi SD),
     // while st_ino is the file's starting cluster in FAT.
-    st->st_dev = fno.fpdrv;
-    st->st_ino = fno.fclust;
+    //
+    // FatFs doesn't fill fpdrv and fclust for exFAT volumes, so they are 0 in
+    // that case (all callers clear the FILINFO structure).
+    st->st_dev = fno->fpdrv;
+    st->st_ino = fno->fclust;
 
-    st->st_size = fno.fsize;
+    st->st_size = fno->fsize;
 
 #if FF_MAX_SS != FF_MIN_SS
 #error "Set the block size to the right value"
 #endif
     st->st_blksize = FF_MAX_SS;
-    st->st_blocks = (fno.fsize + FF_MAX_SS - 1) / FF_MAX_SS;
+    st->st_blocks = (fno->fsize + FF_MAX_SS - 1) / FF_MAX_SS;
 
-    st->st_mode = (fno.fattrib & AM_DIR) ?
+    st->st_mode = (fno->fattrib & AM_DIR) ?
                    S_IFDIR : // Directory
                    S_IFREG;  // Regular file
 
-    time_t time = fatfs_fattime_to_timestamp(fno.fdate, fno.ftime);
-    time_t crtime = fatfs_fattime_to_timestamp(fno.crdate, fno.crtime);
+    time_t time = fatfs_fattime_to_timestamp(fno->fdate, fno->ftime);
+    time_t crtime = fatfs_fattime_to_timestamp(fno->crdate, fno->crtime);
 
     st->st_atim.tv_sec = time; // Time of last access
     st->st_mtim.tv_sec = time; // Time of last modification
@@ -266,14 +538,40 @@ int fat_stat(const char *path, struct stat *st)
     return 0;
 }
 
+int fat_stat(const char *path, struct stat *st)
+{
+    FILINFO fno = { 0 };
+    FRESULT result = fat_stat_cached(path, &fno);
+
+    if (result != FR_OK)
+    {
+        errno = fatfs_error_to_posix(result);
+        return -1;
+    }
+
+    return fat_filinfo_to_stat(&fno, st);
+}
+
 int fat_fstat(int fd, struct stat *st)
 {
     FIL *fp = FD_FAT_UNPACK(fd);
 
+    if ((FSIZE_t)(off_t)fp->obj.objsize != fp->obj.objsize)
+    {
+        errno = EOVERFLOW;
+        return -1;
+    }
+
     // On FatFS, st_dev is either 0 (DLDI) or 1 (DSi SD),
     // while st_ino is the file's starting cluster in FAT.
     st->st_dev = fp->obj.fs->pdrv;
     st->st_ino = fp->obj.sclust;
+#if FF_FS_EXFAT
+    // stat() and readdir() can't get the cluster of exFAT files, so they
+    // report 0. Do the same here so that the values can be compared.
+    if (fp->obj.fs->fs_type == FS_EXFAT)
+        st->st_ino = 0;
+#endif
     st->st_size = fp->obj.objsize;
 
 #if FF_MAX_SS != FF_MIN_SS
@@ -309,6 +607,8 @@ int fat_isatty(int fd)
 
 int fat_rename(const char *old, const char *new_)
 {
+    fat_dircache_invalidate();
+
     FRESULT result = f_rename(old, new_);
 
     if (result == FR_OK)
@@ -324,10 +624,18 @@ static int ftruncate_internal(int fd, off_t length)
     // one, so it doesn't have any shortcuts in case they are the same. The
     // callers must implement them.
 
-    FIL *fp = FD_FAT_UNPACK(fd);
+    fat_file_t *file = fat_file_from_fd(fd);
+    FIL *fp = &file->fil;
+
+    fat_dircache_invalidate();
 
     FSIZE_t fsize = f_size(fp);
 
+    // f_truncate() frees the clusters after the new end of the file, and the
+    // file may grow later with clusters that aren't contiguous.
+    if (file->contig_size > (FSIZE_t)length)
+        file->contig_size = length;
+
     // If the new size is bigger, it's not enough to use f_lseek to set the
     // pointer to the new size, or to use f_expand. Both of them increase the
     // size of the file, but the contents are undefined. According to the
@@ -338,7 +646,7 @@ static int ftruncate_internal(int fd, off_t length)
     // If the new file is smaller, it is enough to call f_lseek to set the
     // pointer to the new size, and then call f_truncate.
 
-    if ((size_t)length > (size_t)fsize)
+    if ((FSIZE_t)length > fsize)
     {
         // Expand the file to a bigger size
 
@@ -393,7 +701,7 @@ int fat_ftruncate(int fd, off_t length)
 {
     FIL *fp = FD_FAT_UNPACK(fd);
 
-    if ((size_t)length == (size_t)f_size(fp))
+    if ((FSIZE_t)length == f_size(fp))
         return 0; // There is nothing to do
 
     // Preserve the current pointer
@@ -418,6 +726,43 @@ int fat_ftruncate(int fd, off_t length)
     return 0;
 }
 
+int fat_preallocate(int fd, off_t size)
+{
+    fat_file_t *file = fat_file_from_fd(fd);
+    FIL *fp = &file->fil;
+
+    if (size <= 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // f_expand() can only allocate clusters for files that don't have any
+    if (!(fp->flag & FA_WRITE) || (f_size(fp) != 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fat_dircache_invalidate();
+
+    // Allocate the clusters right away. This fails if there isn't a block of
+    // contiguous free clusters big enough.
+    FRESULT result = f_expand(fp, size, 1);
+    if (result != FR_OK)
+    {
+        errno = fatfs_error_to_posix(result);
+        return -1;
+    }
+
+    FATFS *fs = fp->obj.fs;
+
+    file->contig_sect = fs->database + ((LBA_t)fs->csize * (fp->obj.sclust - 2));
+    file->contig_size = size;
+
+    return 0;
+}
+
 int fat_truncate(const char *path, off_t length)
 {
     int fd = fat_open(path, O_RDWR, 0);
@@ -432,7 +777,7 @@ int fat_truncate(const char *path, off_t length)
     }
 
     FIL *fp = FD_FAT_UNPACK(fd);
-    if ((size_t)length != (size_t)f_size(fp))
+    if ((FSIZE_t)length != f_size(fp))
     {
         int ret = ftruncate_internal(fd, length);
         if (ret != 0)
@@ -453,6 +798,8 @@ int fat_mkdir(const char *path, mode_t mode)
 {
     (void)mode; // There are no permissions in FAT filesystems
 
+    fat_dircache_invalidate();
+
     FRESULT result = f_mkdir(path);
     if (result != FR_OK)
     {
@@ -466,7 +813,7 @@ int fat_mkdir(const char *path, mode_t mode)
 int fat_access(const char *path, int amode)
 {
     FILINFO fno = { 0 };
-    FRESULT result = f_stat(path, &fno);
+    FRESULT result = fat_stat_cached(path, &fno);
     if (result != FR_OK)
     {
         errno = fatfs_error_to_posix(result);
@@ -552,16 +899,35 @@ int fat_fstatvfs(int fd, struct statvfs *buf)
 #define INDEX_NO_ENTRY          -1
 #define INDEX_END_OF_DIRECTORY  -2
 
+// Number of positions saved by telldir() that can be restored by seekdir()
+// without reading the directory from the start.
+#define FAT_DIR_POSITIONS       8
+
+typedef struct
+{
+    long index;
+    DIRff dir;
+} fat_dir_position_t;
+
+// State of an open directory. The path is only saved if the entries of the
+// directory can be added to the directory entry cache.
+typedef struct
+{
+    DIRff dir;
+    char *path;
+    fat_dir_position_t *positions; // Allocated by the first call to telldir()
+} fat_dir_t;
+
 void *fat_opendir(const char *name, DIR *dirp)
 {
-    DIRff *dp = calloc(1, sizeof(DIRff));
+    fat_dir_t *dp = calloc(1, sizeof(fat_dir_t));
     if (dp == NULL)
     {
         errno = ENOMEM;
         return NULL;
     }
 
-    FRESULT result = f_opendir(dp, name);
+    FRESULT result = f_opendir(&dp->dir, name);
     if (result != FR_OK)
     {
         errno = fatfs_error_to_posix(result);
@@ -569,6 +935,22 @@ void *fat_opendir(const char *name, DIR *dirp)
         return NULL;
     }
 
+    if (fat_dircache_enabled())
+    {
+        // Remove the trailing slash, unless this is the root of the drive
+        size_t len = strlen(name);
+        if ((len > 1) && (name[len - 1] == '/') && (name[len - 2] != ':'))
+            len--;
+
+        dp->path = strndup(name, len);
+
+        if ((dp->path != NULL) && !fat_dircache_path_is_cacheable(dp->path))
+        {
+            free(dp->path);
+            dp->path = NULL;
+        }
+    }
+
     dirp->index = INDEX_NO_ENTRY;
 
     return dp;
@@ -576,10 +958,12 @@ void *fat_opendir(const char *name, DIR *dirp)
 
 int fat_closedir(DIR *dirp)
 {
-    DIRff *dp = dirp->dp;
-    FRESULT result = f_closedir(dp);
+    fat_dir_t *dp = dirp->dp;
+    FRESULT result = f_closedir(&dp->dir);
 
-    free(dirp->dp);
+    free(dp->path);
+    free(dp->positions);
+    free(dp);
 
     if (result != FR_OK)
     {
@@ -590,7 +974,7 @@ int fat_closedir(DIR *dirp)
     return 0;
 }
 
-struct dirent *fat_readdir(DIR *dirp)
+static struct dirent *fat_readdir_internal(DIR *dirp, FILINFO *fno)
 {
     if (dirp->index <= INDEX_END_OF_DIRECTORY)
     {
@@ -598,33 +982,37 @@ struct dirent *fat_readdir(DIR *dirp)
         return NULL;
     }
 
-    DIRff *dp = dirp->dp;
+    fat_dir_t *dp = dirp->dp;
 
-    FILINFO fno = { 0 };
-    FRESULT result = f_readdir(dp, &fno);
+    FRESULT result = f_readdir(&dp->dir, fno);
     if (result != FR_OK)
     {
         errno = fatfs_error_to_posix(result);
         return NULL;
     }
 
-    if (fno.fname[0] == '\0')
+    if (fno->fname[0] == '\0')
     {
         // End of directory reached
         dirp->index = INDEX_END_OF_DIRECTORY;
         return NULL;
     }
 
+    // f_readdir() has already read all the information of the entry, so it's
+    // free to save it in case the application calls stat() later.
+    if (dp->path != NULL)
+        fat_dircache_insert(dp->path, fno->fname, fno);
+
     dirp->index++;
 
     struct dirent *ent = &(dirp->dirent);
     ent->d_off = dirp->index;
-    ent->d_ino = fno.fclust;
+    ent->d_ino = fno->fclust;
 
-    strncpy(ent->d_name, fno.fname, sizeof(ent->d_name));
+    strncpy(ent->d_name, fno->fname, sizeof(ent->d_name));
     ent->d_name[sizeof(ent->d_name) - 1] = '\0';
 
-    if (fno.fattrib & AM_DIR)
+    if (fno->fattrib & AM_DIR)
         ent->d_type = DT_DIR; // Directory
     else
         ent->d_type = DT_REG; // Regular file
@@ -632,15 +1020,59 @@ struct dirent *fat_readdir(DIR *dirp)
     return ent;
 }
 
+struct dirent *fat_readdir(DIR *dirp)
+{
+    FILINFO fno = { 0 };
+    return fat_readdir_internal(dirp, &fno);
+}
+
+struct dirent *fat_readdir_stat(DIR *dirp, struct stat *st)
+{
+    FILINFO fno = { 0 };
+    struct dirent *ent = fat_readdir_internal(dirp, &fno);
+
+    if ((ent != NULL) && (fat_filinfo_to_stat(&fno, st) != 0))
+        return NULL;
+
+    return ent;
+}
+
 void fat_rewinddir(DIR *dirp)
 {
-    DIRff *dp = dirp->dp;
-    (void)f_rewinddir(dp); // Ignore returned value
+    fat_dir_t *dp = dirp->dp;
+    (void)f_rewinddir(&dp->dir); // Ignore returned value
     dirp->index = INDEX_NO_ENTRY;
 }
 
 void fat_seekdir(DIR *dirp, long loc)
 {
+    fat_dir_t *dp = dirp->dp;
+
+    if (loc == dirp->index)
+        return;
+
+    if (loc == INDEX_NO_ENTRY)
+    {
+        fat_rewinddir(dirp);
+        return;
+    }
+
+    // If the position has been saved by telldir(), restore the state of the
+    // directory object. It contains the cluster, sector and offset of the next
+    // entry, so FatFs can continue reading from there.
+    if ((dp->positions != NULL) && (loc >= 0))
+    {
+        fat_dir_position_t *pos = &dp->positions[loc % FAT_DIR_POSITIONS];
+        if (pos->index == loc)
+        {
+            dp->dir = pos->dir;
+            dirp->index = loc;
+            return;
+        }
+    }
+
+    // The position is unknown. Read the directory until the entry is found.
+
     if (dirp->index <= INDEX_END_OF_DIRECTORY) // If we're at the end
         fat_rewinddir(dirp);
     else if (loc < dirp->index) // If we have already passed this entry
@@ -670,6 +1102,27 @@ void fat_seekdir(DIR *dirp, long loc)
 
 long fat_telldir(DIR *dirp)
 {
+    fat_dir_t *dp = dirp->dp;
+
+    if (dirp->index < 0)
+        return dirp->index;
+
+    if (dp->positions == NULL)
+    {
+        dp->positions = malloc(FAT_DIR_POSITIONS * sizeof(fat_dir_position_t));
+
+        // If there isn't enough memory seekdir() will use the slow path
+        if (dp->positions == NULL)
+            return dirp->index;
+
+        for (int i = 0; i < FAT_DIR_POSITIONS; i++)
+            dp->positions[i].index = INDEX_NO_ENTRY;
+    }
+
+    fat_dir_position_t *pos = &dp->positions[dirp->index % FAT_DIR_POSITIONS];
+    pos->index = dirp->index;
+    pos->dir = dp->dir;
+
     return dirp->index;
 }
 
@@ -684,6 +1137,8 @@ int fat_utimes(const char *filename, const struct timeval times[2])
     fno.ftime = modstamp;
     fno.fdate = modstamp >> 16;
 
+    fat_dircache_invalidate();
+
     FRESULT result = f_utime(filename, &fno);
 
     if (result == FR_OK)
@@ -753,7 +1208,7 @@ int fat_getcwd(char *buf, size_t size)
 int fat_get_attr(const char *file)
 {
     FILINFO fno = { 0 };
-    FRESULT result = f_stat(file, &fno);
+    FRESULT result = fat_stat_cached(file, &fno);
 
     if (result != FR_OK)
     {
@@ -769,6 +1224,8 @@ int fat_set_attr(const char *file, uint8_t attr)
     // Modify all attributes (except for directory and volume)
     BYTE mask = AM_RDO | AM_ARC | AM_SYS | AM_HID;
 
+    fat_dircache_invalidate();
+
     FRESULT result = f_chmod(file, attr, mask);
 
     if (result != FR_OK)
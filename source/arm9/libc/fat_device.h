@@ -7,9 +7,36 @@
 
 #include "filesystem_includes.h"
 
+// State of a file opened in a FAT filesystem. "fil" must be the first member so
+// that FD_FAT_UNPACK() returns a valid FIL pointer.
+typedef struct fat_file_t
+{
+    FIL fil;
+
+    // Area of the file that has been allocated with fat_preallocate(). Writes
+    // to it skip FatFs and go straight to the storage device.
+    LBA_t contig_sect;   // First sector of the file
+    FSIZE_t contig_size; // Size of the area in bytes, 0 if there isn't one
+
+    // Link map created automatically (see fat_linkmap.c). The files with one
+    // are kept in a list sorted by the time they were last used.
+    size_t linkmap_size; // Size of fil.cltbl in bytes, 0 if not managed
+    struct fat_file_t *linkmap_prev;
+    struct fat_file_t *linkmap_next;
+} fat_file_t;
+
+static inline fat_file_t *fat_file_from_fd(int fd)
+{
+    return (fat_file_t *)FD_FAT_UNPACK(fd);
+}
+
 int fat_open(const char *path, int flags, mode_t mode_);
 ssize_t fat_read(int fd, void *ptr, size_t len);
 ssize_t fat_write(int fd, const void *ptr, size_t len);
+ssize_t fat_readv(int fd, const struct iovec *iov, int iovcnt);
+ssize_t fat_writev(int fd, const struct iovec *iov, int iovcnt);
+ssize_t fat_preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset);
+ssize_t fat_pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset);
 int fat_fsync(int fd);
 int fat_close(int fd);
 off_t fat_lseek(int fd, off_t offset, int whence);
@@ -20,6 +47,7 @@ int fat_fstat(int fd, struct stat *st);
 int fat_isatty(int fd);
 int fat_rename(const char *old, const char *new_);
 int fat_ftruncate(int fd, off_t length);
+int fat_preallocate(int fd, off_t size);
 int fat_truncate(const char *path, off_t length);
 int fat_mkdir(const char *path, mode_t mode);
 int fat_access(const char *path, int amode);
@@ -28,6 +56,7 @@ int fat_fstatvfs(int fd, struct statvfs *buf);
 void *fat_opendir(const char *name, DIR *dirp);
 int fat_closedir(DIR *dirp);
 struct dirent *fat_readdir(DIR *dirp);
+struct dirent *fat_readdir_stat(DIR *dirp, struct stat *st);
 void fat_rewinddir(DIR *dirp);
 void fat_seekdir(DIR *dirp, long loc);
 long fat_telldir(DIR *dirp);
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+// Cache of directory entries of FAT filesystems.
+//
+// f_stat() resolves the full path from the root directory every time it's
+// called, reading all the directory entries of all the directories in the path.
+// This cache stores the information of entries that have been found by stat()
+// or readdir() so that stat() of the same path doesn't need to access the
+// filesystem again.
+//
+// The cache is direct-mapped: each path can only be stored in the slot that
+// corresponds to its hash. Only absolute paths with a drive name are cached,
+// and they are compared without taking case into account (like FAT does).
+//
+// Any operation that modifies the filesystem clears the whole cache.
+
+#include <ctype.h>
+
+#include "fat_dircache.h"
+
+typedef struct
+{
+    char *path; // Allocated with malloc(), NULL if the slot is empty
+    uint32_t hash;
+    FSIZE_t fsize;
+    DWORD fclust;
+    WORD fdate;
+    WORD ftime;
+    WORD crdate;
+    WORD crtime;
+    BYTE fattrib;
+    BYTE fpdrv;
+} fat_dircache_entry;
+
+static fat_dircache_entry *dircache_entries;
+static size_t dircache_size; // Power of two, 0 if the cache is disabled
+static size_t dircache_used; // Number of slots in use
+
+static uint32_t fat_dircache_hash(const char *str)
+{
+    // FNV-1a of the lowercase version of the string
+    uint32_t hash = 2166136261u;
+
+    while (*str != '\0')
+        hash = (hash ^ (uint8_t)tolower((unsigned char)*str++)) * 16777619u;
+
+    return hash;
+}
+
+int fat_dircache_set_size(size_t entries)
+{
+    fat_dircache_invalidate();
+    free(dircache_entries);
+
+    dircache_entries = NULL;
+    dircache_size = 0;
+
+    if (entries == 0)
+        return 0;
+
+    size_t size = 1;
+    while (size < entries)
+        size <<= 1;
+
+    dircache_entries = calloc(size, sizeof(fat_dircache_entry));
+    if (dircache_entries == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    dircache_size = size;
+
+    return 0;
+}
+
+bool fat_dircache_enabled(void)
+{
+    return dircache_size > 0;
+}
+
+bool fat_dircache_path_is_cacheable(const char *path)
+{
+    // Only cache absolute paths like "sd:/folder/file.txt". Relative paths
+    // depend on the current working directory, and paths with components like
+    // "." or ".." can refer to the same entry as other paths.
+
+    const char *root = strstr(path, ":/");
+    if (root == NULL)
+        return false;
+
+    const char *s = root + 2;
+
+    // The root directory of a drive
+    if (*s == '\0')
+        return true;
+
+    while (1)
+    {
+        const char *end = strchr(s, '/');
+        size_t len = (end == NULL) ? strlen(s) : (size_t)(end - s);
+
+        // Empty components ("//" or a trailing slash), "." and ".."
+        if (len == 0)
+            return false;
+        if ((s[0] == '.') && ((len == 1) || ((len == 2) && (s[1] == '.'))))
+            return false;
+
+        if (end == NULL)
+            return true;
+
+        s = end + 1;
+    }
+}
+
+static fat_dircache_entry *fat_dircache_find(const char *path, uint32_t hash)
+{
+    fat_dircache_entry *e = &dircache_entries[hash & (dircache_size - 1)];
+
+    if ((e->path == NULL) || (e->hash != hash))
+        return NULL;
+
+    if (strcasecmp(e->path, path) != 0)
+        return NULL;
+
+    return e;
+}
+
+bool fat_dircache_lookup(const char *path, FILINFO *fno)
+{
+    if ((dircache_used == 0) || !fat_dircache_path_is_cacheable(path))
+        return false;
+
+    uint32_t hash = fat_dircache_hash(path);
+
+    fat_dircache_entry *e = fat_dircache_find(path, hash);
+    if (e == NULL)
+        return false;
+
+    fno->fsize = e->fsize;
+    fno->fclust = e->fclust;
+    fno->fdate = e->fdate;
+    fno->ftime = e->ftime;
+    fno->crdate = e->crdate;
+    fno->crtime = e->crtime;
+    fno->fattrib = e->fattrib;
+    fno->fpdrv = e->fpdrv;
+
+    return true;
+}
+
+void fat_dircache_insert(const char *dir, const char *name, const FILINFO *fno)
+{
+    // "dir" must have been checked with fat_dircache_path_is_cacheable(). If
+    // "name" is NULL, "dir" is the full path of the entry.
+
+    if (dircache_size == 0)
+        return;
+
+    size_t dir_len = strlen(dir);
+    size_t name_len = 0;
+    bool add_slash = false;
+
+    if (name != NULL)
+    {
+        if ((strcmp(name, ".") == 0) || (strcmp(name, "..") == 0))
+            return;
+
+        name_len = strlen(name);
+        add_slash = dir[dir_len - 1] != '/';
+    }
+
+    char *path = malloc(dir_len + add_slash + name_len + 1);
+    if (path == NULL)
+        return; // Not an error, the entry simply isn't cached
+
+    memcpy(path, dir, dir_len);
+    if (add_slash)
+        path[dir_len] = '/';
+    memcpy(path + dir_len + add_slash, name == NULL ? "" : name, name_len + 1);
+
+    uint32_t hash = fat_dircache_hash(path);
+
+    fat_dircache_entry *e = &dircache_entries[hash & (dircache_size - 1)];
+
+    if (e->path == NULL)
+        dircache_used++;
+    else
+        free(e->path);
+
+    e->path = path;
+    e->hash = hash;
+    e->fsize = fno->fsize;
+    e->fclust = fno->fclust;
+    e->fdate = fno->fdate;
+    e->ftime = fno->ftime;
+    e->crdate = fno->crdate;
+    e->crtime = fno->crtime;
+    e->fattrib = fno->fattrib;
+    e->fpdrv = fno->fpdrv;
+}
+
+void fat_dircache_invalidate(void)
+{
+    if (dircache_used == 0)
+        return;
+
+    for (size_t i = 0; i < dircache_size; i++)
+    {
+        free(dircache_entries[i].path);
+        dircache_entries[i].path = NULL;
+    }
+
+    dircache_used = 0;
+}
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef FAT_DIRCACHE_H__
+#define FAT_DIRCACHE_H__
+
+#include "filesystem_includes.h"
+
+int fat_dircache_set_size(size_t entries);
+bool fat_dircache_enabled(void);
+bool fat_dircache_path_is_cacheable(const char *path);
+bool fat_dircache_lookup(const char *path, FILINFO *fno);
+void fat_dircache_insert(const char *dir, const char *name, const FILINFO *fno);
+void fat_dircache_invalidate(void);
+
+#endif // FAT_DIRCACHE_H__
@@ -0,0 +1,357 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+// Map of free clusters of FAT filesystems.
+//
+// FatFs needs to scan the whole FAT to know how much free space a filesystem
+// has if the FSINFO sector of a FAT32 filesystem isn't valid. Also, when it
+// needs to allocate a new cluster it checks the clusters of the FAT one by one
+// until it finds a free one, which is very slow in filesystems that are almost
+// full.
+//
+// This module keeps a bitmap with one bit per cluster (set if the cluster is
+// free) for each mounted volume:
+//
+// - The bitmap is built by a thread that reads the FAT in small batches and
+//   yields between them. When it's done, it gives FatFs the number of free
+//   clusters, so f_getfree() (and statvfs()) don't need to scan the FAT.
+//
+// - FatFs code can't be modified, but all changes to the FAT go through
+//   disk_write(). diskio.c calls fat_freemap_write_hook() with all the sectors
+//   that are written, and the bitmap is updated from the new contents of the
+//   sectors that belong to the FAT.
+//
+// - Before writes that can make a file grow, fat_freemap_hint() looks for the
+//   next free cluster in the bitmap and tells FatFs to start looking for free
+//   clusters from there.
+//
+// Only FAT16 and FAT32 are supported. In FAT12 entries can cross sector
+// boundaries, and FAT12 filesystems are so small that it isn't worth it.
+
+#include <nds/cothread.h>
+
+#include "fat_freemap.h"
+
+// Number of FAT sectors read by the thread that builds the map between yields
+#define FREEMAP_BATCH_SECTORS   8
+
+typedef struct
+{
+    FATFS *fs;          // NULL if the slot is unused
+    uint32_t *bits;     // One bit per cluster, set if the cluster is free
+    DWORD n_fatent;     // Number of clusters + 2
+    LBA_t fatbase;      // First sector of the first FAT
+    DWORD fsize;        // Number of sectors of a FAT
+    BYTE pdrv;
+    BYTE fs_type;
+    bool ready;         // The map has been built
+    bool building;      // The builder thread is running
+    bool stop;          // The builder thread needs to stop and free the map
+} fat_freemap_t;
+
+bool fat_freemap_active;
+
+static fat_freemap_t freemaps[FF_VOLUMES];
+
+static void fat_freemap_update_active(void)
+{
+    fat_freemap_active = false;
+
+    for (int i = 0; i < FF_VOLUMES; i++)
+    {
+        if (freemaps[i].bits != NULL)
+            fat_freemap_active = true;
+    }
+}
+
+// Returns the map of a volume, or a free slot if "fs" is NULL. Maps that are
+// waiting for their builder thread to free them still use their slot, but they
+// don't belong to the volume anymore: it may have been mounted again with a new
+// map.
+static fat_freemap_t *fat_freemap_find(FATFS *fs)
+{
+    for (int i = 0; i < FF_VOLUMES; i++)
+    {
+        if ((freemaps[i].fs == fs) && !freemaps[i].stop)
+            return &freemaps[i];
+    }
+
+    return NULL;
+}
+
+static void fat_freemap_release(fat_freemap_t *map)
+{
+    free(map->bits);
+    memset(map, 0, sizeof(fat_freemap_t));
+
+    fat_freemap_update_active();
+}
+
+// Updates the bits of the clusters of some consecutive sectors of the FAT.
+// "sector" is relative to the start of the FAT.
+static void fat_freemap_parse(fat_freemap_t *map, DWORD sector, const BYTE *buf,
+                              UINT count)
+{
+    DWORD entries_per_sector = (map->fs_type == FS_FAT32) ? FF_MAX_SS / 4
+                                                          : FF_MAX_SS / 2;
+    DWORD clst = sector * entries_per_sector;
+    DWORD end = clst + (count * entries_per_sector);
+
+    if (end > map->n_fatent)
+        end = map->n_fatent;
+
+    // The buffer isn't always aligned, read the entries byte by byte
+    for (; clst < end; clst++)
+    {
+        bool free_clst;
+
+        if (map->fs_type == FS_FAT32)
+        {
+            free_clst = ((buf[0] | buf[1] | buf[2] | (buf[3] & 0x0F)) == 0);
+            buf += 4;
+        }
+        else
+        {
+            free_clst = ((buf[0] | buf[1]) == 0);
+            buf += 2;
+        }
+
+        // Clusters 0 and 1 don't exist
+        if (clst < 2)
+            continue;
+
+        if (free_clst)
+            map->bits[clst >> 5] |= 1u << (clst & 31);
+        else
+            map->bits[clst >> 5] &= ~(1u << (clst & 31));
+    }
+}
+
+void fat_freemap_write_hook(BYTE pdrv, LBA_t sector, UINT count, const BYTE *buf)
+{
+    for (int i = 0; i < FF_VOLUMES; i++)
+    {
+        fat_freemap_t *map = &freemaps[i];
+
+        if ((map->bits == NULL) || (map->pdrv != pdrv))
+            continue;
+
+        // Only look at the first FAT, the other one is a copy
+
+        LBA_t start = sector;
+        LBA_t end = sector + count;
+
+        if (start < map->fatbase)
+            start = map->fatbase;
+        if (end > map->fatbase + map->fsize)
+            end = map->fatbase + map->fsize;
+        if (start >= end)
+            continue;
+
+        fat_freemap_parse(map, start - map->fatbase,
+                          buf + ((start - sector) * FF_MAX_SS), end - start);
+    }
+}
+
+static int fat_freemap_builder(void *arg)
+{
+    fat_freemap_t *map = arg;
+    FATFS *fs = map->fs;
+
+    BYTE *buf = malloc(FREEMAP_BATCH_SECTORS * FF_MAX_SS);
+    if (buf == NULL)
+    {
+        fat_freemap_release(map);
+        return -1;
+    }
+
+    for (DWORD sector = 0; sector < map->fsize; sector += FREEMAP_BATCH_SECTORS)
+    {
+        if (map->stop)
+            break;
+
+        UINT count = map->fsize - sector;
+        if (count > FREEMAP_BATCH_SECTORS)
+            count = FREEMAP_BATCH_SECTORS;
+
+        // Make sure that FatFs doesn't write to the FAT while the sectors are
+        // read and parsed.
+        ff_mutex_take(fs->ldrv);
+
+        DRESULT result = disk_read(map->pdrv, buf, map->fatbase + sector, count);
+        if (result == RES_OK)
+            fat_freemap_parse(map, sector, buf, count);
+
+        ff_mutex_give(fs->ldrv);
+
+        if (result != RES_OK)
+        {
+            map->stop = true;
+            break;
+        }
+
+        cothread_yield();
+    }
+
+    free(buf);
+
+    if (map->stop)
+    {
+        fat_freemap_release(map);
+        return -1;
+    }
+
+    ff_mutex_take(fs->ldrv);
+
+    if (map->stop)
+    {
+        ff_mutex_give(fs->ldrv);
+        fat_freemap_release(map);
+        return -1;
+    }
+
+    // The window of FatFs may contain changes to the FAT that haven't been
+    // written to the storage device yet.
+    if (fs->wflag && (fs->winsect >= map->fatbase)
+        && (fs->winsect < map->fatbase + map->fsize))
+    {
+        fat_freemap_parse(map, fs->winsect - map->fatbase, fs->win, 1);
+    }
+
+    DWORD free_clusters = 0;
+    for (DWORD i = 0; i < (map->n_fatent + 31) / 32; i++)
+        free_clusters += __builtin_popcount(map->bits[i]);
+
+    // FatFs keeps the count up to date once it's valid. It's only invalid if
+    // the FSINFO sector is invalid and f_getfree() hasn't been called yet.
+    if (fs->free_clst > fs->n_fatent - 2)
+        fs->free_clst = free_clusters;
+
+    map->ready = true;
+    map->building = false;
+
+    ff_mutex_give(fs->ldrv);
+
+    return 0;
+}
+
+int fat_freemap_start(FATFS *fs)
+{
+    if ((fs->fs_type != FS_FAT16) && (fs->fs_type != FS_FAT32))
+        return 0; // Not supported, but not an error either
+
+    if (fat_freemap_find(fs) != NULL)
+        return 0; // It already has a map
+
+    fat_freemap_t *map = fat_freemap_find(NULL);
+    if (map == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    uint32_t *bits = calloc((fs->n_fatent + 31) / 32, sizeof(uint32_t));
+    if (bits == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    map->fs = fs;
+    map->bits = bits;
+    map->n_fatent = fs->n_fatent;
+    map->fatbase = fs->fatbase;
+    map->fsize = fs->fsize;
+    map->pdrv = fs->pdrv;
+    map->fs_type = fs->fs_type;
+    map->ready = false;
+    map->building = true;
+    map->stop = false;
+
+    fat_freemap_update_active();
+
+    if (cothread_create(fat_freemap_builder, map, 0, COTHREAD_DETACHED) == -1)
+    {
+        fat_freemap_release(map);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void fat_freemap_stop_map(fat_freemap_t *map)
+{
+    // The builder thread frees the map when it sees the flag
+    if (map->building)
+        map->stop = true;
+    else
+        fat_freemap_release(map);
+}
+
+void fat_freemap_stop(FATFS *fs)
+{
+    fat_freemap_t *map = fat_freemap_find(fs);
+    if (map != NULL)
+        fat_freemap_stop_map(map);
+}
+
+void fat_freemap_stop_all(void)
+{
+    for (int i = 0; i < FF_VOLUMES; i++)
+    {
+        fat_freemap_t *map = &freemaps[i];
+
+        if (map->fs == NULL)
+            continue;
+
+        fat_freemap_stop_map(map);
+    }
+}
+
+void fat_freemap_hint(FATFS *fs)
+{
+    fat_freemap_t *map = fat_freemap_find(fs);
+    if ((map == NULL) || !map->ready)
+        return;
+
+    ff_mutex_take(fs->ldrv);
+
+    // FatFs starts looking for free clusters right after last_clst
+    DWORD start = fs->last_clst + 1;
+    if ((start < 2) || (start >= map->n_fatent))
+        start = 2;
+
+    DWORD words = (map->n_fatent + 31) / 32;
+    DWORD first = start >> 5;
+
+    // Check the words from the one of the start cluster until the end of the
+    // map, and then from the start of the map until the first word again. The
+    // first time only the bits from the start cluster are checked, and the
+    // bits below it are checked at the end. If there are no free clusters,
+    // FatFs is left to find out by itself.
+    for (DWORD i = 0; i <= words; i++)
+    {
+        DWORD index = first + i;
+        if (index >= words)
+            index -= words;
+
+        uint32_t word = map->bits[index];
+        if (i == 0)
+            word &= 0xFFFFFFFFu << (start & 31);
+        else if (i == words)
+            word &= ~(0xFFFFFFFFu << (start & 31));
+
+        if (word != 0)
+        {
+            DWORD clst = (index << 5) + __builtin_ctz(word);
+            if (clst < map->n_fatent)
+            {
+                fs->last_clst = clst - 1;
+                break;
+            }
+        }
+    }
+
+    ff_mutex_give(fs->ldrv);
+}
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef FAT_FREEMAP_H__
+#define FAT_FREEMAP_H__
+
+#include "filesystem_includes.h"
+
+// This is checked by disk_write() before calling fat_freemap_write_hook()
+extern bool fat_freemap_active;
+
+int fat_freemap_start(FATFS *fs);
+void fat_freemap_stop(FATFS *fs);
+void fat_freemap_stop_all(void);
+void fat_freemap_hint(FATFS *fs);
+void fat_freemap_write_hook(BYTE pdrv, LBA_t sector, UINT count, const BYTE *buf);
+
+#endif // FAT_FREEMAP_H__
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+// Automatic lookup caches (FatFs link maps) of FAT files.
+//
+// Without a link map, FatFs needs to follow the FAT chain of a file from the
+// start every time the file pointer is moved backwards, and from the current
+// cluster when it's moved forwards. A link map stores the list of fragments of
+// the file so that the cluster of any offset can be found right away.
+//
+// When this is enabled, files above a size threshold that are opened in
+// read-only mode get a link map of the exact size they need. All maps share a
+// global memory budget. When a new map doesn't fit, the maps of the files
+// that have been used least recently are freed. The files are kept in a list
+// sorted from the most recently used one to the least recently used one.
+//
+// Maps created by fatInitLookupCache() aren't part of this list and are never
+// freed by it.
+
+#include "fat_linkmap.h"
+
+// Number of DWORDs of the temporary table used to find out the size of a map.
+// That's enough for 15 fragments, most files won't need more than that.
+#define LINKMAP_INITIAL_SIZE    32
+
+static uint32_t linkmap_min_file_size;
+static size_t linkmap_budget; // 0 if automatic link maps are disabled
+static size_t linkmap_used;
+
+static fat_file_t *linkmap_head; // Most recently used file
+static fat_file_t *linkmap_tail; // Least recently used file
+
+static void fat_linkmap_unlink(fat_file_t *file)
+{
+    if (file->linkmap_prev != NULL)
+        file->linkmap_prev->linkmap_next = file->linkmap_next;
+    else
+        linkmap_head = file->linkmap_next;
+
+    if (file->linkmap_next != NULL)
+        file->linkmap_next->linkmap_prev = file->linkmap_prev;
+    else
+        linkmap_tail = file->linkmap_prev;
+
+    file->linkmap_prev = NULL;
+    file->linkmap_next = NULL;
+
+    linkmap_used -= file->linkmap_size;
+    file->linkmap_size = 0;
+}
+
+static void fat_linkmap_push_front(fat_file_t *file, size_t size)
+{
+    file->linkmap_size = size;
+    file->linkmap_prev = NULL;
+    file->linkmap_next = linkmap_head;
+
+    if (linkmap_head != NULL)
+        linkmap_head->linkmap_prev = file;
+    else
+        linkmap_tail = file;
+
+    linkmap_head = file;
+
+    linkmap_used += size;
+}
+
+static void fat_linkmap_evict(size_t budget)
+{
+    while ((linkmap_used > budget) && (linkmap_tail != NULL))
+    {
+        fat_file_t *file = linkmap_tail;
+        FIL *fp = &file->fil;
+
+        fat_linkmap_unlink(file);
+
+        // Another thread may be in the middle of a FatFs call that uses the
+        // map. FatFs falls back to following the FAT chain without it.
+        int vol = fp->obj.fs->ldrv;
+
+        ff_mutex_take(vol);
+        DWORD *cltbl = fp->cltbl;
+        fp->cltbl = NULL;
+        ff_mutex_give(vol);
+
+        free(cltbl);
+    }
+}
+
+void fat_linkmap_configure(uint32_t min_file_size, size_t budget)
+{
+    linkmap_min_file_size = min_file_size;
+    linkmap_budget = budget;
+
+    // Free maps until the ones that are left fit in the new budget
+    fat_linkmap_evict(budget);
+}
+
+void fat_linkmap_create(fat_file_t *file)
+{
+    FIL *fp = &file->fil;
+
+    if (linkmap_budget == 0)
+        return;
+
+    // Writing to a file with a link map can't make it grow
+    if (fp->flag & FA_WRITE)
+        return;
+
+    if ((f_size(fp) < linkmap_min_file_size) || (fp->cltbl != NULL))
+        return;
+
+#if FF_FS_EXFAT
+    // exFAT marks files that are stored in contiguous clusters, and FatFs
+    // calculates their clusters without reading the FAT.
+    if (fp->obj.stat == 2)
+        return;
+#endif
+
+    // Find out how big the map needs to be. It's very likely that the
+    // temporary table is big enough, so the map can be copied from it.
+
+    DWORD table[LINKMAP_INITIAL_SIZE];
+    table[0] = LINKMAP_INITIAL_SIZE;
+
+    fp->cltbl = table;
+    FRESULT result = f_lseek(fp, CREATE_LINKMAP);
+    fp->cltbl = NULL;
+
+    if ((result != FR_OK) && (result != FR_NOT_ENOUGH_CORE))
+        return;
+
+    // FatFs sets the first element to the number of DWORDs that it needs
+    size_t entries = table[0];
+    size_t size = entries * sizeof(DWORD);
+
+    if (size > linkmap_budget)
+        return;
+
+    fat_linkmap_evict(linkmap_budget - size);
+
+    DWORD *cltbl = malloc(size);
+    if (cltbl == NULL)
+        return; // Not an error, the file simply doesn't have a map
+
+    if (result == FR_OK)
+    {
+        memcpy(cltbl, table, size);
+    }
+    else
+    {
+        cltbl[0] = entries;
+
+        fp->cltbl = cltbl;
+        result = f_lseek(fp, CREATE_LINKMAP);
+        fp->cltbl = NULL;
+
+        if (result != FR_OK)
+        {
+            free(cltbl);
+            return;
+        }
+    }
+
+    fp->cltbl = cltbl;
+
+    fat_linkmap_push_front(file, size);
+}
+
+void fat_linkmap_touch(fat_file_t *file)
+{
+    if ((file->linkmap_size == 0) || (linkmap_head == file))
+        return;
+
+    size_t size = file->linkmap_size;
+
+    fat_linkmap_unlink(file);
+    fat_linkmap_push_front(file, size);
+}
+
+bool fat_linkmap_detach(fat_file_t *file)
+{
+    // The map stays assigned to the file, but it stops being managed by this
+    // module. The caller becomes responsible for freeing it.
+
+    if (file->linkmap_size == 0)
+        return false;
+
+    fat_linkmap_unlink(file);
+
+    return true;
+}
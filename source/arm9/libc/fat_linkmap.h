@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef FAT_LINKMAP_H__
+#define FAT_LINKMAP_H__
+
+#include "fat_device.h"
+#include "filesystem_includes.h"
+
+void fat_linkmap_configure(uint32_t min_file_size, size_t budget);
+void fat_linkmap_create(fat_file_t *file);
+void fat_linkmap_touch(fat_file_t *file);
+bool fat_linkmap_detach(fat_file_t *file);
+
+#endif // FAT_LINKMAP_H__
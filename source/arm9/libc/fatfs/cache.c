@@ -8,10 +8,12 @@
 #include <string.h>
 
 #include "ff.h"
+#include "../fs_stats.h"
 
 typedef struct
 {
     uint8_t  valid;
+    uint8_t  busy; // The buffer is being used by a driver, don't reuse it
     uint8_t  pdrv;
     LBA_t    sector;
     uint32_t used_at;
@@ -124,9 +126,15 @@ void *cache_sector_get(uint8_t pdrv, uint32_t sector)
 
         entry->used_at = usage_counter++;
 
+        if (fs_stats_enabled)
+            fs_stats_drive_cache(pdrv, true);
+
         return cache_sector_address(i);
     }
 
+    if (fs_stats_enabled)
+        fs_stats_drive_cache(pdrv, false);
+
     return NULL;
 }
 
@@ -138,10 +146,19 @@ void *cache_sector_add(uint8_t pdrv, uint32_t sector)
     if (!cache_num_sectors)
         return NULL;
 
+    bool found = false;
+
     // Assumption: cache_sector_get() has been called,
     // and we know the sector is not present
     for (uint32_t i = 0; i < cache_num_sectors; i++)
     {
+        // Drivers that wait for the ARM7 yield, so other threads may be using
+        // buffers of the cache with a different drive.
+        if (cache_entries[i].busy)
+            continue;
+
+        found = true;
+
         if (cache_entries[i].valid == 0)
         {
             // Entry free, use it
@@ -158,8 +175,13 @@ void *cache_sector_add(uint8_t pdrv, uint32_t sector)
         }
     }
 
+    if (!found)
+        return NULL;
+
     cache_entry_t *entry = &(cache_entries[selected_entry]);
 
+    entry->busy = 1;
+
     if (pdrv != 0xFF)
     {
         entry->pdrv = pdrv;
@@ -175,6 +197,18 @@ void *cache_sector_add(uint8_t pdrv, uint32_t sector)
     return cache_sector_address(selected_entry);
 }
 
+void cache_sector_release(void *buffer)
+{
+    for (uint32_t i = 0; i < cache_num_sectors; i++)
+    {
+        if (cache_sector_address(i) == buffer)
+        {
+            cache_entries[i].busy = 0;
+            return;
+        }
+    }
+}
+
 void cache_sector_invalidate(uint8_t pdrv, uint32_t sector_from, uint32_t sector_to)
 {
     for (uint32_t i = 0; i < cache_num_sectors; i++)
@@ -14,9 +14,12 @@ void cache_deinit(void);
 int cache_init(int32_t num_sectors);
 void *cache_sector_get(uint8_t pdrv, uint32_t sector);
 void *cache_sector_add(uint8_t pdrv, uint32_t sector);
+void cache_sector_release(void *buffer);
 void cache_sector_invalidate(uint8_t pdrv, uint32_t sector_from, uint32_t sector_to);
 
-// "Borrow" an unused cache entry to use as a write buffer.
+// "Borrow" an unused cache entry to use as a write buffer. Buffers returned by
+// cache_sector_add() and cache_sector_borrow() must be released with
+// cache_sector_release() when the driver is done with them.
 LIBNDS_ALWAYS_INLINE
 static inline void *cache_sector_borrow(void)
 {
@@ -37,20 +37,25 @@
 #include <nds/arm9/dldi.h>
 #include <nds/arm9/sassert.h>
 #include <nds/arm9/sdmmc.h>
+#include <nds/cothread.h>
 #include <nds/interrupts.h>
 #include <nds/memory.h>
 #include <nds/system.h>
 
+#include "../fat_freemap.h"
 #include "../fatfs_helpers.h"
+#include "../fs_stats.h"
 
 #include "ff.h"     // Obtains integer types
 #include "diskio.h" // Declarations of disk functions
 #include "cache.h"
+#include "diskio_internal.h"
 
 // Definitions of physical drive number for each drive
 #define DEV_DLDI    0x00 // DLDI driver (flashcard)
 #define DEV_SD      0x01 // SD slot of the DSi
 #define DEV_NAND    0x02 // NAND of the DSi
+#define DEV_COUNT   3
 
 // Debugging defines.
 // #define DISABLE_DIRECT_READS
@@ -64,6 +69,16 @@
 static bool fs_initialized[FF_VOLUMES];
 static const DISC_INTERFACE *fs_io[FF_VOLUMES];
 
+// Driver set by the application to replace the DLDI driver, or NULL
+static const DISC_INTERFACE *fs_custom_io;
+
+// FatFs only locks volumes, but "nand:" and "nand2:" are in the same physical
+// drive. Also, the DSi SD and NAND drivers (and DLDI in ARM7 mode) yield while
+// they wait for the ARM7, so a thread can use a drive while another thread is
+// waiting for a different one. Only one request is sent to each drive at a
+// time.
+static comutex_t disk_mutex[DEV_COUNT];
+
 #if FF_MAX_SS != FF_MIN_SS
 #error "This file assumes that the sector size is always the same".
 #endif
@@ -80,12 +95,33 @@ static const DISC_INTERFACE *get_disk_interface(BYTE pdrv)
             io = get_io_dsisd();
             break;
         case DEV_DLDI:
-            io = dldiGetInternal();
+            io = fs_custom_io ? fs_custom_io : dldiGetInternal();
             break;
     }
     return io;
 }
 
+void disk_set_custom_io(const DISC_INTERFACE *io)
+{
+    comutex_acquire(&disk_mutex[DEV_DLDI]);
+
+    // Shut down the previous driver so that disk_initialize() starts the new
+    // one the next time that the volume is mounted.
+    if (fs_initialized[DEV_DLDI])
+    {
+        fs_io[DEV_DLDI]->shutdown();
+        fs_io[DEV_DLDI] = NULL;
+        fs_initialized[DEV_DLDI] = false;
+    }
+
+    // Sectors read with the previous driver don't belong to the new one
+    cache_sector_invalidate(DEV_DLDI, 0, UINT32_MAX);
+
+    fs_custom_io = io;
+
+    comutex_release(&disk_mutex[DEV_DLDI]);
+}
+
 //-----------------------------------------------------------------------
 // Get Drive Status
 //-----------------------------------------------------------------------
@@ -151,15 +187,41 @@ DSTATUS disk_initialize(BYTE pdrv)
 
 #define IS_WORD_ALIGNED(buff) (!(((uintptr_t) (buff)) & 0x03))
 
+// Wrappers of the driver functions that record statistics if they're enabled
+
+static bool disk_io_read(BYTE pdrv, LBA_t sector, UINT count, void *buff)
+{
+    const DISC_INTERFACE *io = fs_io[pdrv];
+
+    if (!fs_stats_enabled)
+        return io->readSectors(sector, count, buff);
+
+    uint64_t start = fs_stats_start();
+    bool ok = io->readSectors(sector, count, buff);
+    fs_stats_drive_cmd(pdrv, false, count, ok, start);
+
+    return ok;
+}
+
+static bool disk_io_write(BYTE pdrv, LBA_t sector, UINT count, const void *buff)
+{
+    const DISC_INTERFACE *io = fs_io[pdrv];
+
+    if (!fs_stats_enabled)
+        return io->writeSectors(sector, count, buff);
+
+    uint64_t start = fs_stats_start();
+    bool ok = io->writeSectors(sector, count, buff);
+    fs_stats_drive_cmd(pdrv, true, count, ok, start);
+
+    return ok;
+}
+
 //-----------------------------------------------------------------------
 // Read Sector(s)
 //-----------------------------------------------------------------------
 
-// pdrv:   Physical drive nmuber to identify the drive
-// buff:   Data buffer to store read data
-// sector: Start sector in LBA
-// count:  Number of sectors to read
-DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+static DRESULT disk_read_internal(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
 {
 #if defined(FORCE_CACHE_NONE)
     bool cacheable = false;
@@ -179,15 +241,13 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
         case DEV_SD:
         case DEV_NAND:
         {
-            const DISC_INTERFACE *io = fs_io[pdrv];
-
 #ifndef DISABLE_DIRECT_READS
             // The DSi SD driver supports unaligned buffers; we cannot make
             // the same guarantee for DLDI in practice.
             if (!cacheable && memBufferIsInMainRam(buff, count << 9)
                 && (pdrv == DEV_SD || IS_WORD_ALIGNED(buff)))
             {
-                if (!io->readSectors(sector, count, buff))
+                if (!disk_io_read(pdrv, sector, count, buff))
                     return RES_ERROR;
 
                 return RES_OK;
@@ -197,11 +257,14 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
             if (!cacheable)
             {
                 void *cache = cache_sector_borrow();
+                if (cache == NULL)
+                    return RES_ERROR;
 
                 while (count > 0)
                 {
-                    if (!io->readSectors(sector, 1, cache))
+                    if (!disk_io_read(pdrv, sector, 1, cache))
                     {
+                        cache_sector_release(cache);
                         return RES_ERROR;
                     }
 
@@ -211,6 +274,8 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
                     sector++;
                     buff += FF_MAX_SS;
                 }
+
+                cache_sector_release(cache);
             }
             else
             {
@@ -221,12 +286,17 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
                     if (cache == NULL)
                     {
                         cache = cache_sector_add(pdrv, sector);
+                        if (cache == NULL)
+                            return RES_ERROR;
 
-                        if (!io->readSectors(sector, 1, cache))
+                        if (!disk_io_read(pdrv, sector, 1, cache))
                         {
                             cache_sector_invalidate(pdrv, sector, sector);
+                            cache_sector_release(cache);
                             return RES_ERROR;
                         }
+
+                        cache_sector_release(cache);
                     }
 
                     __aeabi_memcpy(buff, cache, FF_MAX_SS);
@@ -244,17 +314,31 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
     return RES_PARERR;
 }
 
+// pdrv:   Physical drive nmuber to identify the drive
+// buff:   Data buffer to store read data
+// sector: Start sector in LBA
+// count:  Number of sectors to read
+DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+    BYTE drv = pdrv & 0x7F;
+
+    if (drv >= DEV_COUNT)
+        return RES_PARERR;
+
+    comutex_acquire(&disk_mutex[drv]);
+    DRESULT result = disk_read_internal(pdrv, buff, sector, count);
+    comutex_release(&disk_mutex[drv]);
+
+    return result;
+}
+
 //-----------------------------------------------------------------------
 // Write Sector(s)
 //-----------------------------------------------------------------------
 
 #if FF_FS_READONLY == 0
 
-// pdrv:   Physical drive nmuber to identify the drive
-// buff:   Data to be written
-// sector: Start sector in LBA
-// count:  Number of sectors to write
-DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+static DRESULT disk_write_internal(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
 {
     if (fs_initialized[pdrv] == 0)
         return RES_NOTRDY;
@@ -267,7 +351,10 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
         {
             cache_sector_invalidate(pdrv, sector, sector + count - 1);
 
-            const DISC_INTERFACE *io = fs_io[pdrv];
+            // Keep the maps of free clusters up to date with the FAT
+            if (fat_freemap_active)
+                fat_freemap_write_hook(pdrv, sector, count, buff);
+
             // The DSi SD driver supports unaligned buffers; we cannot make
             // the same guarantee for DLDI in practice.
 #ifndef DISABLE_DIRECT_WRITES
@@ -277,13 +364,16 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
             {
                 // DLDI drivers expect a 4-byte aligned buffer.
                 uint8_t *align_buffer = cache_sector_borrow();
+                if (align_buffer == NULL)
+                    return RES_ERROR;
 
                 while (count > 0)
                 {
                     __aeabi_memcpy(align_buffer, buff, FF_MAX_SS);
-                    if (!io->writeSectors(sector, 1, align_buffer))
+                    // The buffer belongs to the sector cache, don't free it
+                    if (!disk_io_write(pdrv, sector, 1, align_buffer))
                     {
-                        free(align_buffer);
+                        cache_sector_release(align_buffer);
                         return RES_ERROR;
                     }
 
@@ -291,11 +381,13 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
                     sector++;
                     buff += FF_MAX_SS;
                 }
+
+                cache_sector_release(align_buffer);
             }
 #ifndef DISABLE_DIRECT_WRITES
             else
             {
-                if (!io->writeSectors(sector, count, buff))
+                if (!disk_io_write(pdrv, sector, count, buff))
                     return RES_ERROR;
             }
 #endif
@@ -307,6 +399,24 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
     return RES_PARERR;
 }
 
+// pdrv:   Physical drive nmuber to identify the drive
+// buff:   Data to be written
+// sector: Start sector in LBA
+// count:  Number of sectors to write
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    BYTE drv = pdrv & 0x7F;
+
+    if (drv >= DEV_COUNT)
+        return RES_PARERR;
+
+    comutex_acquire(&disk_mutex[drv]);
+    DRESULT result = disk_write_internal(drv, buff, sector, count);
+    comutex_release(&disk_mutex[drv]);
+
+    return result;
+}
+
 #endif
 
 //-----------------------------------------------------------------------
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef FATFS_DISKIO_INTERNAL_H__
+#define FATFS_DISKIO_INTERNAL_H__
+
+#include <nds/disc_io.h>
+
+// Sets the driver used by "fat:" instead of DLDI (NULL to use DLDI). The
+// previous driver is shut down. The volume must be unmounted.
+void disk_set_custom_io(const DISC_INTERFACE *io);
+
+#endif // FATFS_DISKIO_INTERNAL_H__
@@ -54,7 +54,7 @@
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
@@ -247,7 +247,7 @@
 /  buffer in the filesystem object (FATFS) is used for the file data transfer. */
 
 
-#define FF_FS_EXFAT		0
+#define FF_FS_EXFAT		1
 /* This option switches support for exFAT filesystem. (0:Disable or 1:Enable)
 /  To enable exFAT, also LFN needs to be enabled. (FF_USE_LFN >= 1)
 /  Note that enabling exFAT discards ANSI C (C89) compatibility. */
@@ -373,7 +373,9 @@
 /* FF_WF_FILINFO_LOCATION controls whether or not the FILINFO structure
 /  contains fpdrv (physical drive ID) and fclust (file cluster #) values.
 /
-/  FIXME: This is not currently supported when FF_FS_EXFAT == 1.
+/  FIXME: This is not currently supported when FF_FS_EXFAT == 1. The values
+/  are left untouched for entries of exFAT volumes, so libnds always clears
+/  FILINFO structures before passing them to FatFs.
 */
 
 
@@ -71,6 +71,8 @@ int ff_mutex_take (	/* Returns 1:Succeeded or 0:Timeout */
 )
 {
 	// TODO: Implement timeout.
+	// This yields until the mutex is released, so other threads can keep using
+	// other volumes in the meantime.
 	comutex_acquire(&Mutex[vol]);
 	return 1;
 }
@@ -14,8 +14,13 @@
 
 #include <fat.h>
 
+#include "fat_device.h"
+#include "fat_dircache.h"
+#include "fat_freemap.h"
+#include "fat_linkmap.h"
 #include "filesystem_includes.h"
 #include "fatfs/cache.h"
+#include "fatfs/diskio_internal.h"
 
 #define DEFAULT_SECTORS_PER_PAGE    8 // Each sector is 512 bytes
 
@@ -47,6 +52,27 @@ static const char *nand2_drive = "nand2:/";
 
 static bool fat_initialized = false;
 static bool nand_mounted = false;
+static bool freemap_enabled = false;
+
+// Starts building the maps of free clusters of all mounted volumes
+static int fat_freemap_start_mounted(void)
+{
+    // The FATFS structs of the DSi volumes are in DSi-only RAM
+    int volumes = isDSiMode() ? FF_VOLUMES : FF_NTR_VOLUMES;
+
+    for (int i = 0; i < volumes; i++)
+    {
+        FATFS *fs = get_fs_info(i);
+
+        if (fs->fs_type == 0) // Not mounted
+            continue;
+
+        if (fat_freemap_start(fs) != 0)
+            return -1;
+    }
+
+    return 0;
+}
 
 // It takes a full path to a NDS ROM and it creates a new string with the path
 // to the directory that contains it. It must be freed by the caller of
@@ -221,6 +247,10 @@ bool nandInit(bool read_only)
         errno = fatfs_error_to_posix(result);
         nand_mounted = false;
     }
+
+    if (freemap_enabled && fat_initialized)
+        fat_freemap_start_mounted();
+
     return nand_mounted;
 }
 
@@ -359,6 +389,11 @@ bool fatInit(int32_t cache_size_pages, bool set_as_default_device)
 
     free(default_cwd);
     fat_initialized = true;
+
+    // This isn't critical, don't fail if it doesn't work
+    if (freemap_enabled)
+        fat_freemap_start_mounted();
+
     return true;
 
 cleanup:
@@ -378,7 +413,14 @@ int fatInitLookupCache(int fd, uint32_t max_buffer_size)
 
     FIL *f = FD_FAT_UNPACK(fd);
     if (f->cltbl != NULL)
+    {
+        // If the file got a cache automatically when it was opened, keep it
+        // and make sure that it is never freed to make space for other caches.
+        if (fat_linkmap_detach(fat_file_from_fd(fd)))
+            return 0;
+
         return FAT_INIT_LOOKUP_CACHE_ALREADY_ALLOCATED;
+    }
 
     // Allocate initial look-up cache area
     // -----------------------------------
@@ -393,7 +435,13 @@ int fatInitLookupCache(int fd, uint32_t max_buffer_size)
 
     FRESULT ret = f_lseek(f, CREATE_LINKMAP);
     if (ret == FR_NOT_ENOUGH_CORE)
-        return f->cltbl[0];
+    {
+        // The table is incomplete, FatFs can't be allowed to use it
+        int required_entries = f->cltbl[0];
+        free(f->cltbl);
+        f->cltbl = NULL;
+        return required_entries;
+    }
 
     // Reduce allocation to match actual cache area size
     // -------------------------------------------------
@@ -405,3 +453,73 @@ int fatInitLookupCache(int fd, uint32_t max_buffer_size)
     return 0;
 }
 
+void fatSetAutoLookupCache(uint32_t min_file_size, size_t memory_budget)
+{
+    fat_linkmap_configure(min_file_size, memory_budget);
+}
+
+int fatSetFreeClusterMap(bool enable)
+{
+    freemap_enabled = enable;
+
+    if (!enable)
+    {
+        fat_freemap_stop_all();
+        return 0;
+    }
+
+    if (!fat_initialized)
+        return 0; // fatInit() will start building the maps
+
+    return fat_freemap_start_mounted();
+}
+
+int fatSetDiscInterface(const DISC_INTERFACE *io)
+{
+    FATFS *fs = get_fs_info(0);
+
+    // Before fatInit() there is nothing to unmount, and fatInit() will mount
+    // the volume with the new driver.
+    if (!fat_initialized)
+    {
+        disk_set_custom_io(io);
+        return 0;
+    }
+
+    // FatFs rejects files and directories opened before the volume is mounted
+    // again, so they can't be used with the new driver by accident.
+    fat_freemap_stop(fs);
+    fat_dircache_invalidate();
+    f_mount(NULL, fat_drive, 0);
+
+    disk_set_custom_io(io);
+
+    FRESULT result = f_mount(fs, fat_drive, 1);
+    if (result != FR_OK)
+    {
+        errno = fatfs_error_to_posix(result);
+        return -1;
+    }
+
+    // This isn't critical, don't fail if it doesn't work
+    if (freemap_enabled)
+        fat_freemap_start(fs);
+
+    return 0;
+}
+
+int fatPreallocate(int fd, off_t size)
+{
+    if (!FD_IS_FAT(fd))
+    {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    return fat_preallocate(FD_DESC(fd), size);
+}
+
+int fatSetDirCacheSize(size_t entries)
+{
+    return fat_dircache_set_size(entries);
+}
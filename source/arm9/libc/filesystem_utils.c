@@ -116,3 +116,30 @@ bool FAT_getShortNameFor(const char *path, char *buf)
 
     return fn(path, buf);
 }
+
+struct dirent *fatReadDirStat(DIR *dirp, struct stat *st)
+{
+    if ((dirp == NULL) || (st == NULL))
+    {
+        errno = EBADF;
+        return NULL;
+    }
+
+    struct dirent *ent = &(dirp->dirent);
+    memset(ent, 0, sizeof(struct dirent));
+    ent->d_reclen = sizeof(struct dirent);
+
+    struct dirent *(*fn)(DIR *, struct stat *);
+
+    if (dirp->dptype == FD_TYPE_NITRO)
+        fn = nitrofs_readdir_stat;
+    else if (dirp->dptype == FD_TYPE_FAT)
+        fn = fat_readdir_stat;
+    else
+        fn = DEVIO_GETFN(dirp->dptype, readdir_stat);
+
+    if (fn == NULL)
+        return NULL;
+
+    return fn(dirp, st);
+}
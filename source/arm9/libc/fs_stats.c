@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+// Filesystem I/O statistics.
+//
+// The system call wrappers in syscalls_filesystem.c record operations on files
+// and devices, diskio.c records the commands sent to the storage drivers, and
+// cache.c records hits and misses of the sector cache. All of them check
+// fs_stats_enabled before measuring anything.
+//
+// The statistics of open files are stored in a small table indexed by file
+// descriptor. An entry is taken when a file is opened and released when it is
+// closed, even if statistics have been disabled in between. If the table is
+// full, the file is only recorded in the statistics of its device.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "device_io_internal.h"
+#include "filesystem_includes.h"
+#include "fs_stats.h"
+
+typedef struct
+{
+    int fd; // 0 if the entry is unused
+    FsIoStats stats;
+} fs_stats_file_t;
+
+bool fs_stats_enabled;
+
+static fs_stats_file_t *fs_stats_files; // FS_STATS_MAX_FILES entries
+static FsIoStats fs_stats_devices[FD_TYPE_USER_MAX + 1];
+static FsDriveStats fs_stats_drives[FS_STATS_DRIVE_COUNT];
+
+static FsTraceCallback fs_trace_callback;
+static void *fs_trace_arg;
+
+int fsStatsEnable(bool enable)
+{
+    if (enable && (fs_stats_files == NULL))
+    {
+        fs_stats_files = calloc(FS_STATS_MAX_FILES, sizeof(fs_stats_file_t));
+        if (fs_stats_files == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    fs_stats_enabled = enable;
+
+    return 0;
+}
+
+void fsStatsReset(void)
+{
+    if (fs_stats_files != NULL)
+    {
+        // Keep recording the files that are currently open
+        for (int i = 0; i < FS_STATS_MAX_FILES; i++)
+            memset(&fs_stats_files[i].stats, 0, sizeof(FsIoStats));
+    }
+
+    memset(fs_stats_devices, 0, sizeof(fs_stats_devices));
+    memset(fs_stats_drives, 0, sizeof(fs_stats_drives));
+}
+
+static fs_stats_file_t *fs_stats_file_find(int fd)
+{
+    if (fs_stats_files == NULL)
+        return NULL;
+
+    for (int i = 0; i < FS_STATS_MAX_FILES; i++)
+    {
+        if (fs_stats_files[i].fd == fd)
+            return &fs_stats_files[i];
+    }
+
+    return NULL;
+}
+
+static void fs_stats_add(FsIoStats *stats, FsStatsOp op, int64_t result,
+                         uint32_t ticks)
+{
+    stats->calls[op]++;
+    stats->ticks[op] += ticks;
+
+    if (result < 0)
+    {
+        stats->errors++;
+        return;
+    }
+
+    if (op == FS_STATS_OP_READ)
+        stats->bytesRead += result;
+    else if (op == FS_STATS_OP_WRITE)
+        stats->bytesWritten += result;
+}
+
+void fs_stats_file_op(int fd, FsStatsOp op, const char *path, size_t size,
+                      int64_t result, uint64_t start)
+{
+    uint32_t ticks = systemCounterGetTicks() - start;
+
+    // Failed calls to open() don't have a file descriptor, they are only sent
+    // to the trace callback.
+    if (fd != -1)
+    {
+        // Sockets and the standard streams aren't files
+        if (FD_IS_SOCKET(fd))
+            return;
+
+        fs_stats_add(&fs_stats_devices[FD_TYPE(fd)], op, result, ticks);
+
+        fs_stats_file_t *file = NULL;
+
+        if (op == FS_STATS_OP_OPEN)
+        {
+            file = fs_stats_file_find(0);
+            if (file != NULL)
+            {
+                memset(file, 0, sizeof(fs_stats_file_t));
+                file->fd = fd;
+            }
+        }
+        else
+        {
+            file = fs_stats_file_find(fd);
+        }
+
+        if (file != NULL)
+        {
+            fs_stats_add(&file->stats, op, result, ticks);
+
+            if ((op == FS_STATS_OP_CLOSE) && (result == 0))
+                file->fd = 0;
+        }
+    }
+
+    if (fs_trace_callback != NULL)
+    {
+        FsTraceEvent event = {
+            .op = op,
+            .fd = fd,
+            .path = path,
+            .size = size,
+            .result = result,
+            .ticks = ticks,
+        };
+
+        fs_trace_callback(&event, fs_trace_arg);
+    }
+}
+
+void fs_stats_file_release(int fd)
+{
+    fs_stats_file_t *file = fs_stats_file_find(fd);
+
+    if (file != NULL)
+        file->fd = 0;
+}
+
+void fs_stats_drive_cmd(uint8_t pdrv, bool write, uint32_t sectors, bool ok,
+                        uint64_t start)
+{
+    uint32_t ticks = systemCounterGetTicks() - start;
+
+    if (pdrv >= FS_STATS_DRIVE_COUNT)
+        return;
+
+    FsDriveStats *stats = &fs_stats_drives[pdrv];
+
+    if (write)
+    {
+        stats->writeCommands++;
+        stats->sectorsWritten += sectors;
+        stats->writeTicks += ticks;
+    }
+    else
+    {
+        stats->readCommands++;
+        stats->sectorsRead += sectors;
+        stats->readTicks += ticks;
+    }
+
+    if (!ok)
+        stats->errors++;
+}
+
+void fs_stats_drive_cache(uint8_t pdrv, bool hit)
+{
+    if (pdrv >= FS_STATS_DRIVE_COUNT)
+        return;
+
+    if (hit)
+        fs_stats_drives[pdrv].cacheHits++;
+    else
+        fs_stats_drives[pdrv].cacheMisses++;
+}
+
+int fsStatsGetFile(int fd, FsIoStats *stats)
+{
+    if ((stats == NULL) || (fd == 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fs_stats_file_t *file = fs_stats_file_find(fd);
+    if (file == NULL)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    *stats = file->stats;
+
+    return 0;
+}
+
+int fsStatsGetDevice(const char *path, FsIoStats *stats)
+{
+    if ((path == NULL) || (stats == NULL))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int index = deviceIoGetIndexFromPath(path);
+    if ((index < FD_TYPE_FAT) || (index > FD_TYPE_USER_MAX))
+    {
+        errno = ENODEV;
+        return -1;
+    }
+
+    *stats = fs_stats_devices[index];
+
+    return 0;
+}
+
+int fsStatsGetDrive(FsStatsDrive drive, FsDriveStats *stats)
+{
+    if (((unsigned int)drive >= FS_STATS_DRIVE_COUNT) || (stats == NULL))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    *stats = fs_stats_drives[drive];
+
+    return 0;
+}
+
+void fsStatsSetTraceCallback(FsTraceCallback callback, void *arg)
+{
+    fs_trace_callback = callback;
+    fs_trace_arg = arg;
+}
+
+static void fs_stats_dump_io(FILE *f, const FsIoStats *stats)
+{
+    static const char *op_names[FS_STATS_OP_COUNT] = {
+        "open", "read", "write", "lseek", "close"
+    };
+
+    for (int op = 0; op < FS_STATS_OP_COUNT; op++)
+    {
+        if (stats->calls[op] == 0)
+            continue;
+
+        u64 usec = systemCounterTicksToUsec64(stats->ticks[op]);
+
+        fprintf(f, "  %-6s %8lu calls %10llu us\n", op_names[op],
+                (unsigned long)stats->calls[op], (unsigned long long)usec);
+    }
+
+    fprintf(f, "  read: %llu bytes, written: %llu bytes, errors: %lu\n",
+            (unsigned long long)stats->bytesRead,
+            (unsigned long long)stats->bytesWritten,
+            (unsigned long)stats->errors);
+}
+
+int fsStatsDump(const char *path)
+{
+    static const char *drive_names[FS_STATS_DRIVE_COUNT] = {
+        "DLDI", "DSi SD", "DSi NAND"
+    };
+
+    // Don't record the operations done to write the report
+    bool enabled = fs_stats_enabled;
+    fs_stats_enabled = false;
+
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        fs_stats_enabled = enabled;
+        return -1;
+    }
+
+    fprintf(f, "Drives\n");
+    fprintf(f, "======\n\n");
+
+    for (int i = 0; i < FS_STATS_DRIVE_COUNT; i++)
+    {
+        const FsDriveStats *d = &fs_stats_drives[i];
+
+        if ((d->readCommands == 0) && (d->writeCommands == 0)
+            && (d->cacheHits == 0) && (d->cacheMisses == 0))
+            continue;
+
+        fprintf(f, "%s\n", drive_names[i]);
+        fprintf(f, "  read:  %8lu cmds %10llu sectors %10llu us\n",
+                (unsigned long)d->readCommands,
+                (unsigned long long)d->sectorsRead,
+                (unsigned long long)systemCounterTicksToUsec64(d->readTicks));
+        fprintf(f, "  write: %8lu cmds %10llu sectors %10llu us\n",
+                (unsigned long)d->writeCommands,
+                (unsigned long long)d->sectorsWritten,
+                (unsigned long long)systemCounterTicksToUsec64(d->writeTicks));
+        fprintf(f, "  cache: %lu hits, %lu misses, errors: %lu\n",
+                (unsigned long)d->cacheHits, (unsigned long)d->cacheMisses,
+                (unsigned long)d->errors);
+    }
+
+    fprintf(f, "\nDevices\n");
+    fprintf(f, "=======\n\n");
+
+    for (int i = FD_TYPE_FAT; i <= FD_TYPE_USER_MAX; i++)
+    {
+        const FsIoStats *s = &fs_stats_devices[i];
+
+        uint32_t calls = 0;
+        for (int op = 0; op < FS_STATS_OP_COUNT; op++)
+            calls += s->calls[op];
+        if (calls == 0)
+            continue;
+
+        if (i == FD_TYPE_FAT)
+            fprintf(f, "FAT\n");
+        else if (i == FD_TYPE_NITRO)
+            fprintf(f, "NitroFS\n");
+        else
+            fprintf(f, "User device %d\n", i);
+
+        fs_stats_dump_io(f, s);
+    }
+
+    fprintf(f, "\nOpen files\n");
+    fprintf(f, "==========\n\n");
+
+    for (int i = 0; (fs_stats_files != NULL) && (i < FS_STATS_MAX_FILES); i++)
+    {
+        fs_stats_file_t file = fs_stats_files[i];
+
+        if (file.fd == 0)
+            continue;
+
+        fprintf(f, "fd 0x%08X\n", (unsigned int)file.fd);
+        fs_stats_dump_io(f, &file.stats);
+    }
+
+    int ret = fclose(f);
+
+    fs_stats_enabled = enabled;
+
+    return ret == 0 ? 0 : -1;
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef FS_STATS_H__
+#define FS_STATS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nds/arm9/fsStats.h>
+#include <nds/system_counter.h>
+
+// This is checked before calling any of the functions below so that there is
+// almost no overhead when statistics are disabled.
+extern bool fs_stats_enabled;
+
+static inline uint64_t fs_stats_start(void)
+{
+    return systemCounterGetTicks();
+}
+
+void fs_stats_file_op(int fd, FsStatsOp op, const char *path, size_t size,
+                      int64_t result, uint64_t start);
+// Frees the per-file entry of a file. It must be called when a file is closed
+// while statistics are disabled.
+void fs_stats_file_release(int fd);
+void fs_stats_drive_cmd(uint8_t pdrv, bool write, uint32_t sectors, bool ok,
+                        uint64_t start);
+void fs_stats_drive_cache(uint8_t pdrv, bool hit);
+
+#endif // FS_STATS_H__
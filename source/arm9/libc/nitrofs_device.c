@@ -51,6 +51,9 @@ const uintptr_t DTCM_END   = DTCM_START + (16 * 1024) - 1;
 // Read from NitroFS when it is being read from a file
 static ssize_t nitrofs_read_internal_file(void *ptr, size_t offset, size_t len)
 {
+    // This isn't done with pread() because it would have to seek back to the
+    // previous position after the read, and FatFs follows the FAT chain of the
+    // file from the start when the file pointer moves backwards.
     lseek(nitrofs_local.fd, offset, SEEK_SET);
     return read(nitrofs_local.fd, ptr, len);
 }
@@ -73,25 +76,33 @@ static ssize_t nitrofs_read_internal_cart(void *ptr, size_t offset, size_t len)
             // The destination is in DTCM
 
             void *cache = cache_sector_borrow();
+            if (cache == NULL)
+            {
+                errno = EIO;
+                return -1;
+            }
 
 #if FF_MAX_SS != FF_MIN_SS
 #error "This code expects a fixed sector size"
 #endif
             uint8_t *buff = ptr;
+            size_t remaining = len;
 
-            while (len > 0)
+            while (remaining > 0)
             {
-                size_t read_size = len > FF_MAX_SS ? FF_MAX_SS : len;
+                size_t read_size = remaining > FF_MAX_SS ? FF_MAX_SS : remaining;
 
                 cardReadArm7(cache, offset, read_size, __NDSHeader->cardControl13);
 
                 __aeabi_memcpy(buff, cache, read_size);
 
-                len -= read_size;
+                remaining -= read_size;
                 offset += read_size;
                 buff += read_size;
             }
 
+            cache_sector_release(cache);
+
             return len;
         }
         else
@@ -266,18 +277,21 @@ void *nitrofs_opendir(const char *name, DIR *dirp)
         return NULL;
     }
 
-    nitrofs_dir_state_t *state = calloc(1, sizeof(nitrofs_dir_state_t));
-    if (state == NULL)
+    nitrofs_dir_t *dp = calloc(1, sizeof(nitrofs_dir_t));
+    if (dp == NULL)
     {
         errno = ENOMEM;
         return NULL;
     }
 
-    nitrofs_dir_state_init(state, res);
+    nitrofs_dir_state_init(&dp->state, res);
+
+    for (int i = 0; i < NITROFS_DIR_POSITIONS; i++)
+        dp->positions[i].index = INDEX_NO_ENTRY;
 
     dirp->index = INDEX_NO_ENTRY;
 
-    return state;
+    return dp;
 }
 
 int nitrofs_closedir(DIR *dirp)
@@ -288,8 +302,8 @@ int nitrofs_closedir(DIR *dirp)
 
 void nitrofs_rewinddir(DIR *dirp)
 {
-    nitrofs_dir_state_t *state = dirp->dp;
-    nitrofs_dir_state_init(state, state->dir_opened);
+    nitrofs_dir_t *dp = dirp->dp;
+    nitrofs_dir_state_init(&dp->state, dp->state.dir_opened);
 
     dirp->index = INDEX_NO_ENTRY;
 }
@@ -348,8 +362,8 @@ struct dirent *nitrofs_readdir(DIR *dirp)
 
     struct dirent *ent = &(dirp->dirent);
 
-    nitrofs_dir_state_t *dp = dirp->dp;
-    if (nitrofs_readdir_internal(dp, ent))
+    nitrofs_dir_t *dp = dirp->dp;
+    if (nitrofs_readdir_internal(&dp->state, ent))
     {
         dirp->index = INDEX_END_OF_DIRECTORY;
         return NULL;
@@ -364,6 +378,48 @@ struct dirent *nitrofs_readdir(DIR *dirp)
 
 void nitrofs_seekdir(DIR *dirp, long loc)
 {
+    nitrofs_dir_t *dp = dirp->dp;
+
+    if (loc == dirp->index)
+        return;
+
+    if (loc == INDEX_NO_ENTRY)
+    {
+        nitrofs_rewinddir(dirp);
+        return;
+    }
+
+    // If the position has been saved by telldir(), reload the entries from
+    // that point of the FNT.
+    if (loc >= 0)
+    {
+        nitrofs_dir_position_t *pos = &dp->positions[loc % NITROFS_DIR_POSITIONS];
+        if (pos->index == loc)
+        {
+            nitrofs_dir_state_t *state = &dp->state;
+            uint32_t offset = pos->entry_offset;
+
+            state->position = 0;
+            if (nitrofs_local.fd == -1)
+            {
+                // Card reads benefit from word-aligning table accesses.
+                state->position = offset & 3;
+                offset -= state->position;
+            }
+
+            state->offset = offset;
+            state->sector_offset = 0;
+            state->file_index = pos->file_index;
+            state->dotdot_offset = pos->dotdot_offset;
+            nitrofs_read_internal(state->buffer, state->offset, 512);
+
+            dirp->index = loc;
+            return;
+        }
+    }
+
+    // The position is unknown. Read the directory until the entry is found.
+
     if (dirp->index <= INDEX_END_OF_DIRECTORY) // If we're at the end
         nitrofs_rewinddir(dirp);
     else if (loc < dirp->index) // If we have already passed this entry
@@ -393,6 +449,19 @@ void nitrofs_seekdir(DIR *dirp, long loc)
 
 long nitrofs_telldir(DIR *dirp)
 {
+    if (dirp->index < 0)
+        return dirp->index;
+
+    nitrofs_dir_t *dp = dirp->dp;
+    nitrofs_dir_state_t *state = &dp->state;
+
+    // The buffer contains data read from "offset - sector_offset" onwards
+    nitrofs_dir_position_t *pos = &dp->positions[dirp->index % NITROFS_DIR_POSITIONS];
+    pos->index = dirp->index;
+    pos->entry_offset = state->offset - state->sector_offset + state->position;
+    pos->file_index = state->file_index;
+    pos->dotdot_offset = state->dotdot_offset;
+
     return dirp->index;
 }
 
@@ -582,6 +651,61 @@ ssize_t nitrofs_read(int fd, void *ptr, size_t len)
     return result;
 }
 
+// Reads into several buffers from a position relative to the start of the ROM
+static ssize_t nitrofs_read_buffers(nitrofs_file_t *f, const struct iovec *iov,
+                                    int iovcnt, uint32_t position)
+{
+    ssize_t total = 0;
+
+    for (int i = 0; (i < iovcnt) && (position < f->endofs); i++)
+    {
+        size_t len = iov[i].iov_len;
+        size_t remaining = f->endofs - position;
+        if (len > remaining)
+            len = remaining;
+        if (len == 0)
+            continue;
+
+        ssize_t result = nitrofs_read_internal(iov[i].iov_base, position, len);
+        if (result <= 0)
+            return total > 0 ? total : result;
+
+        total += result;
+        position += result;
+
+        if ((size_t)result < len)
+            break;
+    }
+
+    return total;
+}
+
+ssize_t nitrofs_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    nitrofs_file_t *f = (nitrofs_file_t *) FD_DESC(fd);
+    ssize_t result = nitrofs_read_buffers(f, iov, iovcnt, f->position);
+    if (result <= 0)
+        return result;
+    f->position += result;
+    return result;
+}
+
+ssize_t nitrofs_preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    nitrofs_file_t *f = (nitrofs_file_t *) FD_DESC(fd);
+
+    if (offset < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((uint64_t)offset >= (f->endofs - f->offset))
+        return 0;
+
+    return nitrofs_read_buffers(f, iov, iovcnt, f->offset + offset);
+}
+
 off_t nitrofs_lseek(int fd, off_t offset, int whence)
 {
     nitrofs_file_t *f = (nitrofs_file_t *) FD_DESC(fd);
@@ -792,6 +916,37 @@ int nitrofs_fstat(int fd, struct stat *st)
     return nitrofs_stat_file_internal(f, st);
 }
 
+struct dirent *nitrofs_readdir_stat(DIR *dirp, struct stat *st)
+{
+    struct dirent *ent = nitrofs_readdir(dirp);
+    if (ent == NULL)
+        return NULL;
+
+    // The index of the entry is enough to get its information without
+    // resolving the path again.
+    if (ent->d_type == DT_DIR)
+    {
+        st->st_ino = ent->d_ino;
+        st->st_size = 0;
+        st->st_mode = S_IFDIR;
+        st->st_atim.tv_sec = 0; // Time of last access
+        st->st_mtim.tv_sec = 0; // Time of last modification
+        st->st_ctim.tv_sec = 0; // Time of last status change
+        return ent;
+    }
+
+    nitrofs_file_t f;
+    if (nitrofs_open_by_id(&f, ent->d_ino) < 0)
+    {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    nitrofs_stat_file_internal(&f, st);
+
+    return ent;
+}
+
 /// Initialization
 
 bool nitroFSExit(void)
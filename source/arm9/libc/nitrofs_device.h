@@ -51,6 +51,25 @@ typedef struct
     int16_t dotdot_offset;
 } nitrofs_dir_state_t;
 
+// Position in a directory saved by telldir()
+typedef struct
+{
+    long index;
+    // ROM offset of the next entry
+    uint32_t entry_offset;
+    uint16_t file_index;
+    int16_t dotdot_offset;
+} nitrofs_dir_position_t;
+
+// Number of positions saved by telldir() that can be restored by seekdir()
+#define NITROFS_DIR_POSITIONS 8
+
+typedef struct
+{
+    nitrofs_dir_state_t state;
+    nitrofs_dir_position_t positions[NITROFS_DIR_POSITIONS];
+} nitrofs_dir_t;
+
 // Forward declarations
 
 bool nitrofs_use_for_path(const char *path);
@@ -58,6 +77,7 @@ int32_t nitrofs_path_resolve(const char *path);
 void *nitrofs_opendir(const char *name, DIR *dirp);
 int nitrofs_closedir(DIR *dirp);
 struct dirent *nitrofs_readdir(DIR *dirp);
+struct dirent *nitrofs_readdir_stat(DIR *dirp, struct stat *st);
 void nitrofs_rewinddir(DIR *dirp);
 void nitrofs_seekdir(DIR *dirp, long loc);
 long nitrofs_telldir(DIR *dirp);
@@ -68,6 +88,8 @@ int nitrofs_access(const char *path, int amode);
 int nitrofs_isatty(int fd);
 int nitrofs_open(const char *path, int flags, mode_t mode);
 ssize_t nitrofs_read(int fd, void *ptr, size_t len);
+ssize_t nitrofs_readv(int fd, const struct iovec *iov, int iovcnt);
+ssize_t nitrofs_preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset);
 off_t nitrofs_lseek(int fd, off_t offset, int whence);
 int nitrofs_close(int fd);
 int nitrofs_stat(const char *name, struct stat *st);
@@ -28,6 +28,7 @@ int scandir(const char *path, struct dirent ***names,
 {
     bool error = false;
     int count = 0;
+    int capacity = 0;
     struct dirent *ent;
     int errno_prev;
 
@@ -52,24 +53,31 @@ int scandir(const char *path, struct dirent ***names,
 
         if (filter_f == NULL || (filter_f(ent) != 0))
         {
-            struct dirent **new_names = realloc(*names, (count + 1) * sizeof(struct dirent *));
-            if (new_names == NULL)
+            // grow the list geometrically so that big directories don't need
+            // one reallocation per entry
+            if (count == capacity)
             {
-                error = true;
-                break;
+                int new_capacity = capacity == 0 ? 16 : capacity * 2;
+                struct dirent **new_names = realloc(*names, new_capacity * sizeof(struct dirent *));
+                if (new_names == NULL)
+                {
+                    error = true;
+                    break;
+                }
+
+                *names = new_names;
+                capacity = new_capacity;
             }
 
             struct dirent *ent_copy = malloc(sizeof(struct dirent));
             if (ent_copy == NULL)
             {
-                free(new_names);
                 error = true;
                 break;
             }
             memcpy(ent_copy, ent, sizeof(struct dirent));
 
-            new_names[count++] = ent_copy;
-            *names = new_names;
+            (*names)[count++] = ent_copy;
         }
     }
 
@@ -77,8 +85,7 @@ int scandir(const char *path, struct dirent ***names,
     {
         // deallocate name list
         for (int i = 0; i < count; i++)
-            if (*names[i] != NULL)
-                free(*names[i]);
+            free((*names)[i]);
         free(*names);
         *names = NULL;
     }
@@ -13,6 +13,7 @@
 #include "filesystem_includes.h"
 
 #include "fat_device.h"
+#include "fs_stats.h"
 #include "nitrofs_device.h"
 
 ssize_t (*socket_fn_write)(int, const void *, size_t) = NULL;
@@ -53,15 +54,22 @@ int open(const char *path, int flags, ...)
     if (fn == NULL)
         return -1;
 
+    uint64_t start = fs_stats_enabled ? fs_stats_start() : 0;
+
     int fd = fn(path, flags, 0);
-    if (fd == -1)
-        return -1;
+    if (fd != -1)
+    {
+        // Ensure that all reserved bits are unused
+        if ((fd & 0xF0000003) != 0)
+            libndsCrash("Bad device file descriptor");
+
+        fd |= index << 28;
+    }
 
-    // Ensure that all reserved bits are unused
-    if ((fd & 0xF0000003) != 0)
-        libndsCrash("Bad device file descriptor");
+    if (fs_stats_enabled)
+        fs_stats_file_op(fd, FS_STATS_OP_OPEN, path, 0, fd, start);
 
-    return fd | (index << 28);
+    return fd;
 }
 
 ssize_t read(int fd, void *ptr, size_t len)
@@ -88,7 +96,14 @@ ssize_t read(int fd, void *ptr, size_t len)
     if (fn == NULL)
         return -1;
 
-    return fn(FD_DESC(fd), ptr, len);
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), ptr, len);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), ptr, len);
+    fs_stats_file_op(fd, FS_STATS_OP_READ, NULL, len, ret, start);
+
+    return ret;
 }
 
 ssize_t write(int fd, const void *ptr, size_t len)
@@ -127,7 +142,14 @@ ssize_t write(int fd, const void *ptr, size_t len)
     if (fn == NULL)
         return -1;
 
-    return fn(FD_DESC(fd), ptr, len);
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), ptr, len);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), ptr, len);
+    fs_stats_file_op(fd, FS_STATS_OP_WRITE, NULL, len, ret, start);
+
+    return ret;
 }
 
 int fsync(int fd)
@@ -213,7 +235,22 @@ int close(int fd)
     if (fn == NULL)
         return -1;
 
-    return fn(FD_DESC(fd));
+    if (!fs_stats_enabled)
+    {
+        int ret = fn(FD_DESC(fd));
+
+        // The file may have been opened while statistics were enabled
+        if (ret == 0)
+            fs_stats_file_release(fd);
+
+        return ret;
+    }
+
+    uint64_t start = fs_stats_start();
+    int ret = fn(FD_DESC(fd));
+    fs_stats_file_op(fd, FS_STATS_OP_CLOSE, NULL, 0, ret, start);
+
+    return ret;
 }
 
 off_t lseek(int fd, off_t offset, int whence)
@@ -237,7 +274,253 @@ off_t lseek(int fd, off_t offset, int whence)
     if (fn == NULL)
         return -1;
 
-    return fn(FD_DESC(fd), offset, whence);
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), offset, whence);
+
+    uint64_t start = fs_stats_start();
+    off_t ret = fn(FD_DESC(fd), offset, whence);
+    fs_stats_file_op(fd, FS_STATS_OP_SEEK, NULL, 0, ret, start);
+
+    return ret;
+}
+
+// Returns the total size of the buffers, or -1 if the array isn't valid
+static ssize_t iov_get_size(const struct iovec *iov, int iovcnt)
+{
+    if ((iov == NULL) || (iovcnt <= 0) || (iovcnt > IOV_MAX))
+        return -1;
+
+    size_t total = 0;
+
+    for (int i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].iov_len > (SSIZE_MAX - total))
+            return -1;
+
+        total += iov[i].iov_len;
+    }
+
+    return total;
+}
+
+// Implementations of readv() and writev() for devices that don't have them
+
+static ssize_t readv_fallback(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+
+    for (int i = 0; i < iovcnt; i++)
+    {
+        ssize_t ret = read(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret == -1)
+            return total > 0 ? total : -1;
+
+        total += ret;
+
+        if ((size_t)ret < iov[i].iov_len)
+            break;
+    }
+
+    return total;
+}
+
+static ssize_t writev_fallback(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t total = 0;
+
+    for (int i = 0; i < iovcnt; i++)
+    {
+        ssize_t ret = write(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret == -1)
+            return total > 0 ? total : -1;
+
+        total += ret;
+
+        if ((size_t)ret < iov[i].iov_len)
+            break;
+    }
+
+    return total;
+}
+
+// Implementation of preadv() and pwritev() for devices that don't have them
+static ssize_t pv_fallback(int fd, const struct iovec *iov, int iovcnt,
+                           off_t offset, bool write)
+{
+    off_t prev_offset = lseek(fd, 0, SEEK_CUR);
+    if (prev_offset == -1)
+        return -1;
+
+    if (lseek(fd, offset, SEEK_SET) == -1)
+        return -1;
+
+    ssize_t ret = write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+    int ret_errno = errno;
+
+    // The file pointer must not be modified
+    if (lseek(fd, prev_offset, SEEK_SET) == -1)
+        return -1;
+
+    errno = ret_errno;
+    return ret;
+}
+
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t size = iov_get_size(iov, iovcnt);
+    if (size == -1)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ssize_t (*fn)(int, const struct iovec *, int) = NULL;
+
+    if (FD_IS_NITRO(fd))
+        fn = nitrofs_readv;
+    else if (FD_IS_FAT(fd))
+        fn = fat_readv;
+    else if (FD_TYPE(fd) >= FD_TYPE_USER_MIN)
+        fn = DEVIO_GETFN(FD_TYPE(fd), readv);
+
+    // Sockets, stdin and devices that don't support readv()
+    if (fn == NULL)
+        return readv_fallback(fd, iov, iovcnt);
+
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), iov, iovcnt);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), iov, iovcnt);
+    fs_stats_file_op(fd, FS_STATS_OP_READ, NULL, size, ret, start);
+
+    return ret;
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t size = iov_get_size(iov, iovcnt);
+    if (size == -1)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ssize_t (*fn)(int, const struct iovec *, int) = NULL;
+
+    if (FD_IS_FAT(fd))
+        fn = fat_writev;
+    else if (FD_TYPE(fd) >= FD_TYPE_USER_MIN)
+        fn = DEVIO_GETFN(FD_TYPE(fd), writev);
+
+    // Sockets, stdout, stderr, NitroFS (which fails in write()) and devices
+    // that don't support writev()
+    if (fn == NULL)
+        return writev_fallback(fd, iov, iovcnt);
+
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), iov, iovcnt);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), iov, iovcnt);
+    fs_stats_file_op(fd, FS_STATS_OP_WRITE, NULL, size, ret, start);
+
+    return ret;
+}
+
+ssize_t preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    ssize_t size = iov_get_size(iov, iovcnt);
+    if ((size == -1) || (offset < 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // It isn't possible to seek in sockets or the stdio streams
+    if (FD_IS_SOCKET(fd))
+    {
+        errno = ESPIPE;
+        return -1;
+    }
+
+    ssize_t (*fn)(int, const struct iovec *, int, off_t) = NULL;
+
+    if (FD_IS_NITRO(fd))
+        fn = nitrofs_preadv;
+    else if (FD_IS_FAT(fd))
+        fn = fat_preadv;
+    else
+        fn = DEVIO_GETFN(FD_TYPE(fd), preadv);
+
+    if (fn == NULL)
+        return pv_fallback(fd, iov, iovcnt, offset, false);
+
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), iov, iovcnt, offset);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), iov, iovcnt, offset);
+    fs_stats_file_op(fd, FS_STATS_OP_READ, NULL, size, ret, start);
+
+    return ret;
+}
+
+ssize_t pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    ssize_t size = iov_get_size(iov, iovcnt);
+    if ((size == -1) || (offset < 0))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // It isn't possible to seek in sockets or the stdio streams
+    if (FD_IS_SOCKET(fd))
+    {
+        errno = ESPIPE;
+        return -1;
+    }
+
+    ssize_t (*fn)(int, const struct iovec *, int, off_t) = NULL;
+
+    if (FD_IS_NITRO(fd))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    else if (FD_IS_FAT(fd))
+    {
+        fn = fat_pwritev;
+    }
+    else
+    {
+        fn = DEVIO_GETFN(FD_TYPE(fd), pwritev);
+    }
+
+    if (fn == NULL)
+        return pv_fallback(fd, iov, iovcnt, offset, true);
+
+    if (!fs_stats_enabled)
+        return fn(FD_DESC(fd), iov, iovcnt, offset);
+
+    uint64_t start = fs_stats_start();
+    ssize_t ret = fn(FD_DESC(fd), iov, iovcnt, offset);
+    fs_stats_file_op(fd, FS_STATS_OP_WRITE, NULL, size, ret, start);
+
+    return ret;
+}
+
+ssize_t pread(int fd, void *ptr, size_t len, off_t offset)
+{
+    struct iovec iov = { ptr, len };
+    return preadv(fd, &iov, 1, offset);
+}
+
+ssize_t pwrite(int fd, const void *ptr, size_t len, off_t offset)
+{
+    struct iovec iov = { (void *)ptr, len };
+    return pwritev(fd, &iov, 1, offset);
 }
 
 int unlink(const char *name)
@@ -28,4 +28,16 @@ extern int (*stdin_fn_fcntl)(int, int, va_list);
 
 void libnds_setup_default_stdin_hooks(void);
 
+// In glProfiler.c
+
+extern bool libnds_gl_profiler_active;
+
+void libnds_gl_profiler_list(const u32 *list, u32 count, u32 stall_ticks);
+
+// In videoGL.c
+
+void *libnds_gl_texture_alloc_aligned(int name, int sizeX, int sizeY);
+bool libnds_gl_texture_vram_in_use(const void *start, const void *end);
+u32 libnds_gl_texture_format(int name);
+
 #endif // ARM9_LIBNDS_INTERNAL_H__
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <nds/arm9/math.h>
+#include <nds/arm9/matrix.h>
+#include <nds/ndstypes.h>
+
+// All the products are calculated as 64-bit values and shifted at the end of
+// each dot product so that the compiler can use SMULL and SMLAL, which is more
+// accurate than shifting each product individually.
+
+void matrixIdentity4x3(m4x3 *m)
+{
+    *m = (m4x3) {{
+        inttof32(1), 0, 0,
+        0, inttof32(1), 0,
+        0, 0, inttof32(1),
+        0, 0, 0
+    }};
+}
+
+void matrixIdentity4x4(m4x4 *m)
+{
+    *m = (m4x4) {{
+        inttof32(1), 0, 0, 0,
+        0, inttof32(1), 0, 0,
+        0, 0, inttof32(1), 0,
+        0, 0, 0, inttof32(1)
+    }};
+}
+
+ARM_CODE void matrixMult4x3(m4x3 *result, const m4x3 *a, const m4x3 *b)
+{
+    const int32_t *ma = a->m;
+    const int32_t *mb = b->m;
+    m4x3 tmp;
+
+    for (int row = 0; row < 4; row++)
+    {
+        int32_t r0 = ma[row * 3 + 0];
+        int32_t r1 = ma[row * 3 + 1];
+        int32_t r2 = ma[row * 3 + 2];
+
+        for (int col = 0; col < 3; col++)
+        {
+            int64_t sum = (int64_t)r0 * mb[0 + col]
+                        + (int64_t)r1 * mb[3 + col]
+                        + (int64_t)r2 * mb[6 + col];
+
+            // The translation row of "a" has an implicit 1.0 in the 4th
+            // column, which adds the translation row of "b".
+            if (row == 3)
+                sum += (int64_t)mb[9 + col] << 12;
+
+            tmp.m[row * 3 + col] = sum >> 12;
+        }
+    }
+
+    *result = tmp;
+}
+
+ARM_CODE void matrixMult4x4(m4x4 *result, const m4x4 *a, const m4x4 *b)
+{
+    const int32_t *ma = a->m;
+    const int32_t *mb = b->m;
+    m4x4 tmp;
+
+    for (int row = 0; row < 4; row++)
+    {
+        int32_t r0 = ma[row * 4 + 0];
+        int32_t r1 = ma[row * 4 + 1];
+        int32_t r2 = ma[row * 4 + 2];
+        int32_t r3 = ma[row * 4 + 3];
+
+        for (int col = 0; col < 4; col++)
+        {
+            int64_t sum = (int64_t)r0 * mb[0 + col]
+                        + (int64_t)r1 * mb[4 + col]
+                        + (int64_t)r2 * mb[8 + col]
+                        + (int64_t)r3 * mb[12 + col];
+
+            tmp.m[row * 4 + col] = sum >> 12;
+        }
+    }
+
+    *result = tmp;
+}
+
+// It returns the reciprocal of a 20.12 determinant as a 12.20 value so that the
+// inverse matrix keeps as much precision as possible. It returns false if the
+// reciprocal doesn't fit in 32 bits.
+static bool matrix_reciprocal(int32_t det, int32_t *recip)
+{
+    if ((det >= -2) && (det <= 2))
+        return false;
+
+    *recip = div64((int64_t)1 << 32, det);
+    return true;
+}
+
+static inline int32_t matrix_scale(int64_t value, int32_t recip)
+{
+    return (value * recip) >> 20;
+}
+
+ARM_CODE bool matrixInverse4x3(m4x3 *result, const m4x3 *m)
+{
+    const int32_t *s = m->m;
+
+    // Cofactors of the 3x3 part, in 20.12 format
+    int32_t c00 = ((int64_t)s[4] * s[8] - (int64_t)s[5] * s[7]) >> 12;
+    int32_t c01 = ((int64_t)s[5] * s[6] - (int64_t)s[3] * s[8]) >> 12;
+    int32_t c02 = ((int64_t)s[3] * s[7] - (int64_t)s[4] * s[6]) >> 12;
+
+    int32_t det = ((int64_t)s[0] * c00 + (int64_t)s[1] * c01
+                   + (int64_t)s[2] * c02) >> 12;
+
+    int32_t recip;
+    if (!matrix_reciprocal(det, &recip))
+        return false;
+
+    int32_t c10 = ((int64_t)s[2] * s[7] - (int64_t)s[1] * s[8]) >> 12;
+    int32_t c11 = ((int64_t)s[0] * s[8] - (int64_t)s[2] * s[6]) >> 12;
+    int32_t c12 = ((int64_t)s[1] * s[6] - (int64_t)s[0] * s[7]) >> 12;
+
+    int32_t c20 = ((int64_t)s[1] * s[5] - (int64_t)s[2] * s[4]) >> 12;
+    int32_t c21 = ((int64_t)s[2] * s[3] - (int64_t)s[0] * s[5]) >> 12;
+    int32_t c22 = ((int64_t)s[0] * s[4] - (int64_t)s[1] * s[3]) >> 12;
+
+    m4x3 tmp;
+
+    // The inverse of the 3x3 part is the transposed matrix of cofactors
+    // divided by the determinant.
+    tmp.m[0] = matrix_scale(c00, recip);
+    tmp.m[1] = matrix_scale(c10, recip);
+    tmp.m[2] = matrix_scale(c20, recip);
+    tmp.m[3] = matrix_scale(c01, recip);
+    tmp.m[4] = matrix_scale(c11, recip);
+    tmp.m[5] = matrix_scale(c21, recip);
+    tmp.m[6] = matrix_scale(c02, recip);
+    tmp.m[7] = matrix_scale(c12, recip);
+    tmp.m[8] = matrix_scale(c22, recip);
+
+    // The new translation is the old translation transformed by the inverse of
+    // the 3x3 part, and negated.
+    int32_t tx = s[9];
+    int32_t ty = s[10];
+    int32_t tz = s[11];
+
+    for (int col = 0; col < 3; col++)
+    {
+        int64_t sum = (int64_t)tx * tmp.m[0 + col]
+                    + (int64_t)ty * tmp.m[3 + col]
+                    + (int64_t)tz * tmp.m[6 + col];
+
+        tmp.m[9 + col] = -(int32_t)(sum >> 12);
+    }
+
+    *result = tmp;
+    return true;
+}
+
+ARM_CODE bool matrixInverse4x4(m4x4 *result, const m4x4 *m)
+{
+    const int32_t *s = m->m;
+
+    // 2x2 determinants of the two top rows and the two bottom rows, in 20.12
+    // format.
+    int32_t s0 = ((int64_t)s[0] * s[5] - (int64_t)s[4] * s[1]) >> 12;
+    int32_t s1 = ((int64_t)s[0] * s[6] - (int64_t)s[4] * s[2]) >> 12;
+    int32_t s2 = ((int64_t)s[0] * s[7] - (int64_t)s[4] * s[3]) >> 12;
+    int32_t s3 = ((int64_t)s[1] * s[6] - (int64_t)s[5] * s[2]) >> 12;
+    int32_t s4 = ((int64_t)s[1] * s[7] - (int64_t)s[5] * s[3]) >> 12;
+    int32_t s5 = ((int64_t)s[2] * s[7] - (int64_t)s[6] * s[3]) >> 12;
+
+    int32_t c5 = ((int64_t)s[10] * s[15] - (int64_t)s[14] * s[11]) >> 12;
+    int32_t c4 = ((int64_t)s[9] * s[15] - (int64_t)s[13] * s[11]) >> 12;
+    int32_t c3 = ((int64_t)s[9] * s[14] - (int64_t)s[13] * s[10]) >> 12;
+    int32_t c2 = ((int64_t)s[8] * s[15] - (int64_t)s[12] * s[11]) >> 12;
+    int32_t c1 = ((int64_t)s[8] * s[14] - (int64_t)s[12] * s[10]) >> 12;
+    int32_t c0 = ((int64_t)s[8] * s[13] - (int64_t)s[12] * s[9]) >> 12;
+
+    int32_t det = ((int64_t)s0 * c5 - (int64_t)s1 * c4 + (int64_t)s2 * c3
+                   + (int64_t)s3 * c2 - (int64_t)s4 * c1
+                   + (int64_t)s5 * c0) >> 12;
+
+    int32_t recip;
+    if (!matrix_reciprocal(det, &recip))
+        return false;
+
+    int64_t adj[16];
+
+    adj[0] = ((int64_t)s[5] * c5 - (int64_t)s[6] * c4 + (int64_t)s[7] * c3) >> 12;
+    adj[1] = ((int64_t)-s[1] * c5 + (int64_t)s[2] * c4 - (int64_t)s[3] * c3) >> 12;
+    adj[2] = ((int64_t)s[13] * s5 - (int64_t)s[14] * s4 + (int64_t)s[15] * s3) >> 12;
+    adj[3] = ((int64_t)-s[9] * s5 + (int64_t)s[10] * s4 - (int64_t)s[11] * s3) >> 12;
+
+    adj[4] = ((int64_t)-s[4] * c5 + (int64_t)s[6] * c2 - (int64_t)s[7] * c1) >> 12;
+    adj[5] = ((int64_t)s[0] * c5 - (int64_t)s[2] * c2 + (int64_t)s[3] * c1) >> 12;
+    adj[6] = ((int64_t)-s[12] * s5 + (int64_t)s[14] * s2 - (int64_t)s[15] * s1) >> 12;
+    adj[7] = ((int64_t)s[8] * s5 - (int64_t)s[10] * s2 + (int64_t)s[11] * s1) >> 12;
+
+    adj[8] = ((int64_t)s[4] * c4 - (int64_t)s[5] * c2 + (int64_t)s[7] * c0) >> 12;
+    adj[9] = ((int64_t)-s[0] * c4 + (int64_t)s[1] * c2 - (int64_t)s[3] * c0) >> 12;
+    adj[10] = ((int64_t)s[12] * s4 - (int64_t)s[13] * s2 + (int64_t)s[15] * s0) >> 12;
+    adj[11] = ((int64_t)-s[8] * s4 + (int64_t)s[9] * s2 - (int64_t)s[11] * s0) >> 12;
+
+    adj[12] = ((int64_t)-s[4] * c3 + (int64_t)s[5] * c1 - (int64_t)s[6] * c0) >> 12;
+    adj[13] = ((int64_t)s[0] * c3 - (int64_t)s[1] * c1 + (int64_t)s[2] * c0) >> 12;
+    adj[14] = ((int64_t)-s[12] * s3 + (int64_t)s[13] * s1 - (int64_t)s[14] * s0) >> 12;
+    adj[15] = ((int64_t)s[8] * s3 - (int64_t)s[9] * s1 + (int64_t)s[10] * s0) >> 12;
+
+    for (int i = 0; i < 16; i++)
+        result->m[i] = matrix_scale(adj[i], recip);
+
+    return true;
+}
+
+ARM_CODE ITCM_CODE
+void matrixTransform4x3(const m4x3 *m, const v16 *in, v16 *out, size_t count)
+{
+    const int32_t *s = m->m;
+
+    while (count--)
+    {
+        int32_t x = in[0];
+        int32_t y = in[1];
+        int32_t z = in[2];
+        in += 3;
+
+        int64_t rx = (int64_t)x * s[0] + (int64_t)y * s[3] + (int64_t)z * s[6]
+                   + ((int64_t)s[9] << 12);
+        int64_t ry = (int64_t)x * s[1] + (int64_t)y * s[4] + (int64_t)z * s[7]
+                   + ((int64_t)s[10] << 12);
+        int64_t rz = (int64_t)x * s[2] + (int64_t)y * s[5] + (int64_t)z * s[8]
+                   + ((int64_t)s[11] << 12);
+
+        out[0] = rx >> 12;
+        out[1] = ry >> 12;
+        out[2] = rz >> 12;
+        out += 3;
+    }
+}
+
+ARM_CODE ITCM_CODE
+void matrixTransform4x4(const m4x4 *m, const int32_t *in, int32_t *out,
+                        size_t count)
+{
+    const int32_t *s = m->m;
+
+    while (count--)
+    {
+        int32_t x = in[0];
+        int32_t y = in[1];
+        int32_t z = in[2];
+        in += 3;
+
+        for (int col = 0; col < 4; col++)
+        {
+            int64_t sum = (int64_t)x * s[0 + col] + (int64_t)y * s[4 + col]
+                        + (int64_t)z * s[8 + col] + ((int64_t)s[12 + col] << 12);
+
+            out[col] = sum >> 12;
+        }
+        out += 4;
+    }
+}
+
+ARM_CODE ITCM_CODE
+void matrixSkin4x3(const m4x3 *bones, const uint8_t *bone_index,
+                   const v16 *in, v16 *out, size_t count)
+{
+    while (count--)
+    {
+        const int32_t *s = bones[*bone_index++].m;
+
+        int32_t x = in[0];
+        int32_t y = in[1];
+        int32_t z = in[2];
+        in += 3;
+
+        int64_t rx = (int64_t)x * s[0] + (int64_t)y * s[3] + (int64_t)z * s[6]
+                   + ((int64_t)s[9] << 12);
+        int64_t ry = (int64_t)x * s[1] + (int64_t)y * s[4] + (int64_t)z * s[7]
+                   + ((int64_t)s[10] << 12);
+        int64_t rz = (int64_t)x * s[2] + (int64_t)y * s[5] + (int64_t)z * s[8]
+                   + ((int64_t)s[11] << 12);
+
+        out[0] = rx >> 12;
+        out[1] = ry >> 12;
+        out[2] = rz >> 12;
+        out += 3;
+    }
+}
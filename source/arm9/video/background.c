@@ -11,6 +11,8 @@
 #include <nds/arm9/background.h>
 #include <nds/arm9/trig_lut.h>
 
+#include "arm9/video/background_internal.h"
+
 // Look up tables for smoothing register access between the two displays
 vu16 *const bgControl[8] =
 {
@@ -86,8 +88,10 @@ void bgUpdate(void)
 
         if (bgIsTextLut[i])
         {
-            bgScrollTable[i]->x = bgState[i].scrollX >> 8;
-            bgScrollTable[i]->y = bgState[i].scrollY >> 8;
+            bg_scroll *scroll = bg_scroll_reg(i);
+
+            scroll->x = bgState[i].scrollX >> 8;
+            scroll->y = bgState[i].scrollY >> 8;
         }
         else
         {
@@ -106,21 +110,26 @@ void bgUpdate(void)
             pc = (angleSin * bgState[i].scaleY) >> 12;
             pd = (angleCos * bgState[i].scaleY) >> 12;
 
-            bgTransform[i]->hdx = pa;
-            bgTransform[i]->vdx = pb;
-            bgTransform[i]->hdy = pc;
-            bgTransform[i]->vdy = pd;
+            bg_transform *transform = bg_transform_reg(i);
+
+            transform->hdx = pa;
+            transform->vdx = pb;
+            transform->hdy = pc;
+            transform->vdy = pd;
 
-            bgTransform[i]->dx =
+            transform->dx =
                 bgState[i].scrollX
                 - ((pa * bgState[i].centerX + pb * bgState[i].centerY) >> 8);
-            bgTransform[i]->dy =
+            transform->dy =
                 bgState[i].scrollY
                 - ((pc * bgState[i].centerX + pd * bgState[i].centerY) >> 8);
         }
 
         bgState[i].dirty = false;
     }
+
+    if (bg_shadow_enabled)
+        bg_shadow_publish();
 }
 
 void bgSetRotate(int id, int angle)
@@ -307,8 +316,8 @@ int bgInitHidden(int layer, BgType type, BgSize size, int mapBase, int tileBase)
     }
 #endif
 
-    BGCTRL[layer] = BG_MAP_BASE(mapBase) | BG_TILE_BASE(tileBase) | size
-                    | ((type == BgType_Text8bpp) ? BG_COLOR_256 : 0);
+    *bg_control_reg(layer) = BG_MAP_BASE(mapBase) | BG_TILE_BASE(tileBase) | size
+                        | ((type == BgType_Text8bpp) ? BG_COLOR_256 : 0);
 
     memset(&bgState[layer], 0, sizeof(BgState));
 
@@ -359,8 +368,8 @@ int bgInitHiddenSub(int layer, BgType type, BgSize size, int mapBase, int tileBa
     bgInitValidate(videoMode, layer, type, size, mapBase, tileBase);
 #endif
 
-    BGCTRL_SUB[layer] = BG_MAP_BASE(mapBase) | BG_TILE_BASE(tileBase) | size
-                        | ((type == BgType_Text8bpp) ? BG_COLOR_256 : 0);
+    *bg_control_reg(layer + 4) = BG_MAP_BASE(mapBase) | BG_TILE_BASE(tileBase)
+                                 | size | ((type == BgType_Text8bpp) ? BG_COLOR_256 : 0);
 
     memset(&bgState[layer + 4], 0, sizeof(BgState));
 
@@ -393,39 +402,40 @@ vuint16 *bgSetControlBits(int id, u16 bits)
 {
     sassert(id >= 0 && id <= 7,
             "bgSetControlBits(), id must be the number returned from bgInit or bgInitSub");
-    *bgControl[id] |= bits;
-    return bgControl[id];
+    vu16 *reg = bg_control_reg(id);
+    *reg |= bits;
+    return reg;
 }
 
 void bgClearControlBits(int id, u16 bits)
 {
     sassert(id >= 0 && id <= 7,
             "bgClearControlBits(), id must be the number returned from bgInit or bgInitSub");
-    *bgControl[id] &= ~bits;
+    *bg_control_reg(id) &= ~bits;
 }
 
 void bgSetPriority(int id, unsigned int priority)
 {
     sassert(priority < 4, "Priority must be less than 4");
 
-    *bgControl[id] &= ~3;
-    *bgControl[id] |= priority;
+    vu16 *reg = bg_control_reg(id);
+    *reg = (*reg & ~3) | priority;
 }
 
 void bgSetMapBase(int id, unsigned int base)
 {
     sassert(base <= 31, "Map base cannot exceed 31");
 
-    *bgControl[id] &= ~(31 << MAP_BASE_SHIFT);
-    *bgControl[id] |= base << MAP_BASE_SHIFT;
+    vu16 *reg = bg_control_reg(id);
+    *reg = (*reg & ~(31 << MAP_BASE_SHIFT)) | (base << MAP_BASE_SHIFT);
 }
 
 void bgSetTileBase(int id, unsigned int base)
 {
     sassert(base <= 15, "Tile base cannot exceed 15");
 
-    *bgControl[id] &= ~(15 << TILE_BASE_SHIFT);
-    *bgControl[id] |= base << TILE_BASE_SHIFT;
+    vu16 *reg = bg_control_reg(id);
+    *reg = (*reg & ~(15 << TILE_BASE_SHIFT)) | (base << TILE_BASE_SHIFT);
 }
 
 void bgSetScrollf(int id, s32 x, s32 y)
@@ -501,13 +511,23 @@ void bgSetAffineMatrixScroll(int id, int hdx, int vdx, int hdy, int vdy,
 {
     sassert(!bgIsText(id), "Text Backgrounds have no affine matrix and scroll registers.");
 
-    bgTransform[id]->hdx = hdx;
-    bgTransform[id]->vdx = vdx;
-    bgTransform[id]->hdy = hdy;
-    bgTransform[id]->vdy = vdy;
+    bg_transform *transform = bg_transform_reg(id);
 
-    bgTransform[id]->dx = scrollx;
-    bgTransform[id]->dy = scrolly;
+    transform->hdx = hdx;
+    transform->vdx = vdx;
+    transform->hdy = hdy;
+    transform->vdy = vdy;
+
+    transform->dx = scrollx;
+    transform->dy = scrolly;
 
     bgState[id].dirty = false;
 }
+
+u16 bgGetControl(int id)
+{
+    sassert(id >= 0 && id <= 7,
+            "bgGetControl(), id must be the number returned from bgInit or bgInitSub");
+
+    return *bg_control_reg(id);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef ARM9_VIDEO_BACKGROUND_INTERNAL_H__
+#define ARM9_VIDEO_BACKGROUND_INTERNAL_H__
+
+#include <stdbool.h>
+
+#include <nds/arm9/background.h>
+#include <nds/ndstypes.h>
+
+// Copy of the background registers of one engine, from BG0CNT to BG3Y. The
+// layout is the same as in the hardware, so it can be copied in one transfer.
+typedef struct
+{
+    u16 control[4] ALIGN(4);
+    bg_scroll scroll[4];
+    bg_transform transform[2];
+} bg_shadow_regs;
+
+extern bool bg_shadow_enabled;
+
+// Registers written by the background functions while the shadow registers are
+// enabled. They are copied to the hardware after bgUpdate() publishes them.
+extern bg_shadow_regs bg_shadow_work[2];
+
+// All background functions write the registers through these helpers, so that
+// the lookup tables of background.h can always point to the hardware.
+
+static inline vu16 *bg_control_reg(int id)
+{
+    if (bg_shadow_enabled)
+        return &bg_shadow_work[id >> 2].control[id & 3];
+
+    return bgControl[id];
+}
+
+static inline bg_scroll *bg_scroll_reg(int id)
+{
+    if (bg_shadow_enabled)
+        return &bg_shadow_work[id >> 2].scroll[id & 3];
+
+    return bgScrollTable[id];
+}
+
+static inline bg_transform *bg_transform_reg(int id)
+{
+    if (bg_shadow_enabled && ((id & 3) >= 2))
+        return &bg_shadow_work[id >> 2].transform[(id & 3) - 2];
+
+    return bgTransform[id];
+}
+
+// Makes the current values of the shadow registers the ones that will be
+// copied to the hardware during the next VBlank.
+void bg_shadow_publish(void);
+
+#endif // ARM9_VIDEO_BACKGROUND_INTERNAL_H__
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+
+#include <nds/arm9/background.h>
+#include <nds/arm9/bgStream.h>
+#include <nds/decompress.h>
+
+// Number of columns and rows of tiles that can be visible at the same time:
+// one more than the size of the screen, for when the scroll isn't a multiple
+// of 8 pixels.
+#define STREAM_COLS     (SCREEN_WIDTH / 8 + 1)
+#define STREAM_ROWS     (SCREEN_HEIGHT / 8 + 1)
+
+typedef struct
+{
+    u16 *map;           // Virtual map
+    bool owned;         // The map has been allocated by this module
+    bool loaded;        // Some area of the map has been copied to VRAM
+    int width;          // Size of the virtual map in tiles
+    int height;
+    int hw_height;      // Height of the hardware map in tiles (32 or 64)
+    int x0;             // First column and row of the loaded area
+    int y0;
+} bg_stream;
+
+static bg_stream streams[8];
+
+// Returns the address in VRAM of a tile of the virtual map. Text maps bigger
+// than 256x256 pixels are made of 32x32 blocks stored one after the other.
+static u16 *stream_vram_entry(int id, int x, int y)
+{
+    x &= 63;
+    y &= streams[id].hw_height - 1;
+
+    int block = ((y >> 5) << 1) | (x >> 5);
+
+    return bgGetMapPtr(id) + (block << 10) + ((y & 31) << 5) + (x & 31);
+}
+
+static u16 stream_map_entry(const bg_stream *s, int x, int y)
+{
+    if ((x < 0) || (y < 0) || (x >= s->width) || (y >= s->height))
+        return 0;
+
+    return s->map[y * s->width + x];
+}
+
+static void stream_copy_column(int id, int x, int y0, int rows)
+{
+    const bg_stream *s = &streams[id];
+
+    for (int y = y0; y < y0 + rows; y++)
+        *stream_vram_entry(id, x, y) = stream_map_entry(s, x, y);
+}
+
+static void stream_copy_row(int id, int y, int x0, int cols)
+{
+    const bg_stream *s = &streams[id];
+
+    for (int x = x0; x < x0 + cols; x++)
+        *stream_vram_entry(id, x, y) = stream_map_entry(s, x, y);
+}
+
+static void stream_update(int id)
+{
+    bg_stream *s = &streams[id];
+
+    // Coordinates of the top left tile that is visible. The shifts round
+    // towards minus infinity, so negative coordinates work too.
+    int x0 = (bgState[id].scrollX >> 8) >> 3;
+    int y0 = (bgState[id].scrollY >> 8) >> 3;
+
+    int dx = x0 - s->x0;
+    int dy = y0 - s->y0;
+
+    // If the new area doesn't overlap the old one, copy all of it
+    if (!s->loaded || (dx >= STREAM_COLS) || (dx <= -STREAM_COLS)
+        || (dy >= STREAM_ROWS) || (dy <= -STREAM_ROWS))
+    {
+        for (int y = y0; y < y0 + STREAM_ROWS; y++)
+            stream_copy_row(id, y, x0, STREAM_COLS);
+
+        s->x0 = x0;
+        s->y0 = y0;
+        s->loaded = true;
+        return;
+    }
+
+    // Copy the new columns in the rows of the old area, and then the new rows
+    // with the columns of the new area. This fills the corner too.
+    if (dx > 0)
+    {
+        for (int x = s->x0 + STREAM_COLS; x < x0 + STREAM_COLS; x++)
+            stream_copy_column(id, x, s->y0, STREAM_ROWS);
+    }
+    else if (dx < 0)
+    {
+        for (int x = x0; x < s->x0; x++)
+            stream_copy_column(id, x, s->y0, STREAM_ROWS);
+    }
+
+    if (dy > 0)
+    {
+        for (int y = s->y0 + STREAM_ROWS; y < y0 + STREAM_ROWS; y++)
+            stream_copy_row(id, y, x0, STREAM_COLS);
+    }
+    else if (dy < 0)
+    {
+        for (int y = y0; y < s->y0; y++)
+            stream_copy_row(id, y, x0, STREAM_COLS);
+    }
+
+    s->x0 = x0;
+    s->y0 = y0;
+}
+
+static int stream_check(int id, int width, int height)
+{
+    if ((id < 0) || (id > 7) || (width <= 0) || (height <= 0))
+        return -1;
+
+    if ((bgState[id].type != BgType_Text8bpp)
+        && (bgState[id].type != BgType_Text4bpp))
+        return -1;
+
+    // Only 512x256 and 512x512 maps have enough columns outside of the screen
+    switch (bgState[id].size)
+    {
+        case BgSize_T_512x256:
+            return 32;
+        case BgSize_T_512x512:
+            return 64;
+        default:
+            return -1;
+    }
+}
+
+int bgStreamInit(int id, const u16 *map, int width, int height)
+{
+    if (map == NULL)
+        return -1;
+
+    int hw_height = stream_check(id, width, height);
+    if (hw_height < 0)
+        return -1;
+
+    bgStreamDeinit(id);
+
+    bg_stream *s = &streams[id];
+
+    s->map = (u16 *)map;
+    s->owned = false;
+    s->loaded = false;
+    s->width = width;
+    s->height = height;
+    s->hw_height = hw_height;
+
+    return 0;
+}
+
+int bgStreamInitFile(int id, FILE *file, int width, int height)
+{
+    if (file == NULL)
+        return -1;
+
+    if (stream_check(id, width, height) < 0)
+        return -1;
+
+    u32 header;
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        return -1;
+
+    size_t size = header >> 8;
+    if (size < (size_t)width * height * sizeof(u16))
+        return -1;
+
+    u16 *map = malloc(size);
+    if (map == NULL)
+        return -1;
+
+    if ((header & 0xF0) == 0x00)
+    {
+        // No compression
+        if (fread(map, 1, size, file) != size)
+            goto error;
+    }
+    else
+    {
+        // The size of the compressed data isn't stored in the header, so read
+        // the rest of the file.
+        long start = ftell(file);
+        if ((start < 0) || (fseek(file, 0, SEEK_END) != 0))
+            goto error;
+
+        long end = ftell(file);
+        if ((end <= start) || (fseek(file, start, SEEK_SET) != 0))
+            goto error;
+
+        size_t compressed_size = end - start;
+
+        u32 *tmp = malloc(compressed_size + sizeof(header));
+        if (tmp == NULL)
+            goto error;
+
+        *tmp = header;
+        if (fread(tmp + 1, 1, compressed_size, file) != compressed_size)
+        {
+            free(tmp);
+            goto error;
+        }
+
+        switch (header & 0xF0)
+        {
+            case 0x10: // LZ77
+                decompress(tmp, map, LZ77Vram);
+                break;
+            case 0x20: // Huffman
+                decompress(tmp, map, HUFF);
+                break;
+            case 0x30: // RLE
+                decompress(tmp, map, RLEVram);
+                break;
+            default:
+                free(tmp);
+                goto error;
+        }
+
+        free(tmp);
+    }
+
+    if (bgStreamInit(id, map, width, height) != 0)
+        goto error;
+
+    streams[id].owned = true;
+
+    return 0;
+
+error:
+    free(map);
+    return -1;
+}
+
+void bgStreamDeinit(int id)
+{
+    if ((id < 0) || (id > 7))
+        return;
+
+    bg_stream *s = &streams[id];
+
+    if (s->owned)
+        free(s->map);
+
+    s->map = NULL;
+    s->owned = false;
+    s->loaded = false;
+}
+
+void bgStreamUpdate(void)
+{
+    for (int id = 0; id < 8; id++)
+    {
+        if (streams[id].map != NULL)
+            stream_update(id);
+    }
+}
+
+void bgStreamRefresh(int id)
+{
+    if ((id < 0) || (id > 7))
+        return;
+
+    streams[id].loaded = false;
+}
+
+void bgStreamSetTile(int id, int x, int y, u16 entry)
+{
+    if ((id < 0) || (id > 7))
+        return;
+
+    bg_stream *s = &streams[id];
+
+    if ((s->map == NULL) || (x < 0) || (y < 0) || (x >= s->width)
+        || (y >= s->height))
+        return;
+
+    s->map[y * s->width + x] = entry;
+
+    if (!s->loaded)
+        return;
+
+    if ((x >= s->x0) && (x < s->x0 + STREAM_COLS)
+        && (y >= s->y0) && (y < s->y0 + STREAM_ROWS))
+        *stream_vram_entry(id, x, y) = entry;
+}
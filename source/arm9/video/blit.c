@@ -0,0 +1,687 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <ndsabi.h>
+
+#include <nds/arm9/background.h>
+#include <nds/arm9/blit.h>
+#include <nds/arm9/video.h>
+
+// Maximum number of pixels processed at once by the functions that need a
+// temporary buffer for a row of pixels.
+#define BLIT_CHUNK  256
+
+// Helpers for single pixels
+// =========================
+
+// VRAM ignores 8-bit writes, so bytes are written with a read-modify-write of
+// the halfword that contains them.
+static inline void blit_put8(u8 *p, u8 v)
+{
+    vu16 *h = (vu16 *)((uintptr_t)p & ~1);
+
+    if ((uintptr_t)p & 1)
+        *h = (*h & 0x00FF) | (v << 8);
+    else
+        *h = (*h & 0xFF00) | v;
+}
+
+// Blends two RGB15 colors. The factor goes from 0 (only dst) to 32 (only src).
+// The components are spread in a 32-bit word so that they can be multiplied at
+// the same time.
+static inline u16 blit_blend(u16 src, u16 dst, u32 factor)
+{
+    u32 s = (src | ((u32)src << 16)) & 0x03E07C1F;
+    u32 d = (dst | ((u32)dst << 16)) & 0x03E07C1F;
+
+    u32 r = ((s * factor + d * (32 - factor)) >> 5) & 0x03E07C1F;
+
+    return (r | (r >> 16)) | BIT(15);
+}
+
+static inline void *blit_pixel_ptr(const BlitSurface *s, int x, int y)
+{
+    if (s->format == BlitFormat_16bpp)
+        return (u16 *)s->pixels + y * s->stride + x;
+    else
+        return (u8 *)s->pixels + y * s->stride + x;
+}
+
+// Row kernels
+// ===========
+
+ARM_CODE ITCM_CODE
+static void blit_fill16_row(u16 *d, int n, u16 color)
+{
+    if (((uintptr_t)d & 2) && (n > 0))
+    {
+        *d++ = color;
+        n--;
+    }
+
+    size_t bytes = (n * 2) & ~3;
+    if (bytes > 0)
+    {
+        __ndsabi_wordset4(d, bytes, color | ((u32)color << 16));
+        d += bytes / 2;
+        n -= bytes / 2;
+    }
+
+    if (n > 0)
+        *d = color;
+}
+
+ARM_CODE ITCM_CODE
+static void blit_fill8_row(u8 *d, int n, u8 color)
+{
+    if (n <= 0)
+        return;
+
+    if ((uintptr_t)d & 1)
+    {
+        blit_put8(d++, color);
+        n--;
+    }
+
+    u16 color16 = color | (color << 8);
+
+    if (((uintptr_t)d & 2) && (n >= 2))
+    {
+        *(u16 *)d = color16;
+        d += 2;
+        n -= 2;
+    }
+
+    size_t bytes = n & ~3;
+    if (bytes > 0)
+    {
+        __ndsabi_wordset4(d, bytes, color16 | ((u32)color16 << 16));
+        d += bytes;
+        n -= bytes;
+    }
+
+    if (n >= 2)
+    {
+        *(u16 *)d = color16;
+        d += 2;
+        n -= 2;
+    }
+
+    if (n > 0)
+        blit_put8(d, color);
+}
+
+ARM_CODE ITCM_CODE
+static void blit_copy16_row(u16 *d, const u16 *s, int n)
+{
+    size_t bytes = n * 2;
+
+    // If both pointers have the same alignment, the biggest part of the row
+    // can be copied with the FIQ copy routine, which moves 16 bytes at a time.
+    if (((((uintptr_t)d ^ (uintptr_t)s) & 2) == 0) && (bytes >= 32))
+    {
+        if ((uintptr_t)d & 2)
+        {
+            *d++ = *s++;
+            bytes -= 2;
+        }
+
+        size_t fast = bytes & ~15;
+        __ndsabi_fiq_memcpy4x4(d, s, fast);
+        d += fast / 2;
+        s += fast / 2;
+        bytes -= fast;
+    }
+
+    if (bytes > 0)
+        __ndsabi_memcpy2(d, s, bytes);
+}
+
+ARM_CODE ITCM_CODE
+static void blit_copy8_row(u8 *d, const u8 *s, int n)
+{
+    if (n <= 0)
+        return;
+
+    if ((uintptr_t)d & 1)
+    {
+        blit_put8(d++, *s++);
+        n--;
+    }
+
+    if (((uintptr_t)s & 1) == 0)
+    {
+        size_t bytes = n & ~1;
+        if (bytes > 0)
+            __ndsabi_memcpy2(d, s, bytes);
+        d += bytes;
+        s += bytes;
+        n -= bytes;
+    }
+    else
+    {
+        // Reading bytes is allowed in VRAM, only writes need to be 16-bit
+        u16 *d16 = (u16 *)d;
+        for ( ; n >= 2; n -= 2, s += 2)
+            *d16++ = s[0] | (s[1] << 8);
+        d = (u8 *)d16;
+    }
+
+    if (n > 0)
+        blit_put8(d, *s);
+}
+
+ARM_CODE ITCM_CODE
+static void blit_row_16_16(u16 *d, const u16 *s, int n, BlitMode mode,
+                           u16 param)
+{
+    switch (mode)
+    {
+        case BlitMode_Opaque:
+            blit_copy16_row(d, s, n);
+            break;
+
+        case BlitMode_Transparent:
+            for (int i = 0; i < n; i++)
+            {
+                u16 c = s[i];
+                if (c & BIT(15))
+                    d[i] = c;
+            }
+            break;
+
+        case BlitMode_ColorKey:
+            for (int i = 0; i < n; i++)
+            {
+                u16 c = s[i];
+                if (c != param)
+                    d[i] = c;
+            }
+            break;
+
+        case BlitMode_Alpha:
+        {
+            u32 factor = param + (param >> 4); // 0..31 to 0..32
+            for (int i = 0; i < n; i++)
+            {
+                u16 c = s[i];
+                if (c & BIT(15))
+                    d[i] = blit_blend(c, d[i], factor);
+            }
+            break;
+        }
+    }
+}
+
+ARM_CODE ITCM_CODE
+static void blit_row_8_16(u16 *d, const u8 *s, int n, BlitMode mode,
+                          u16 param, const u16 *pal)
+{
+    switch (mode)
+    {
+        case BlitMode_Opaque:
+            for (int i = 0; i < n; i++)
+                d[i] = pal[s[i]] | BIT(15);
+            break;
+
+        case BlitMode_Transparent:
+            for (int i = 0; i < n; i++)
+            {
+                u8 c = s[i];
+                if (c != 0)
+                    d[i] = pal[c] | BIT(15);
+            }
+            break;
+
+        case BlitMode_ColorKey:
+            for (int i = 0; i < n; i++)
+            {
+                u8 c = s[i];
+                if (c != param)
+                    d[i] = pal[c] | BIT(15);
+            }
+            break;
+
+        case BlitMode_Alpha:
+        {
+            u32 factor = param + (param >> 4);
+            for (int i = 0; i < n; i++)
+            {
+                u8 c = s[i];
+                if (c != 0)
+                    d[i] = blit_blend(pal[c], d[i], factor);
+            }
+            break;
+        }
+    }
+}
+
+ARM_CODE ITCM_CODE
+static void blit_row_8_8(u8 *d, const u8 *s, int n, BlitMode mode, u16 param)
+{
+    if (mode == BlitMode_Opaque)
+    {
+        blit_copy8_row(d, s, n);
+        return;
+    }
+
+    // In transparent mode the color key is 0
+    u8 key = (mode == BlitMode_Transparent) ? 0 : param;
+
+    for (int i = 0; i < n; i++)
+    {
+        u8 c = s[i];
+        if (c != key)
+            blit_put8(d + i, c);
+    }
+}
+
+// Returns true if a combination of formats and mode is supported
+static bool blit_supported(const BlitSurface *dst, const BlitSurface *src,
+                           BlitMode mode)
+{
+    if (dst->format == BlitFormat_8bpp)
+    {
+        if (src->format != BlitFormat_8bpp)
+            return false;
+
+        if (mode == BlitMode_Alpha)
+            return false;
+    }
+    else if (src->format == BlitFormat_8bpp)
+    {
+        if (src->palette == NULL)
+            return false;
+    }
+
+    return true;
+}
+
+static void blit_row(const BlitSurface *dst, void *d, const BlitSurface *src,
+                     const void *s, int n, BlitMode mode, u16 param)
+{
+    if (dst->format == BlitFormat_8bpp)
+        blit_row_8_8(d, s, n, mode, param);
+    else if (src->format == BlitFormat_8bpp)
+        blit_row_8_16(d, s, n, mode, param, src->palette);
+    else
+        blit_row_16_16(d, s, n, mode, param);
+}
+
+// Public functions
+// ================
+
+void blitSurfaceInit(BlitSurface *surface, void *pixels, int width, int height,
+                     int stride, BlitFormat format, const u16 *palette)
+{
+    surface->pixels = pixels;
+    surface->width = width;
+    surface->height = height;
+    surface->stride = stride;
+    surface->format = format;
+    surface->palette = palette;
+}
+
+int blitSurfaceInitBg(BlitSurface *surface, int id)
+{
+    if ((id < 0) || (id > 7))
+        return -1;
+
+    int width, height;
+    BlitFormat format;
+
+    switch (bgState[id].size)
+    {
+        case BgSize_B8_128x128:
+            width = 128; height = 128; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B8_256x256:
+            width = 256; height = 256; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B8_512x256:
+            width = 512; height = 256; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B8_512x512:
+            width = 512; height = 512; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B8_1024x512:
+            width = 1024; height = 512; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B8_512x1024:
+            width = 512; height = 1024; format = BlitFormat_8bpp;
+            break;
+        case BgSize_B16_128x128:
+            width = 128; height = 128; format = BlitFormat_16bpp;
+            break;
+        case BgSize_B16_256x256:
+            width = 256; height = 256; format = BlitFormat_16bpp;
+            break;
+        case BgSize_B16_512x256:
+            width = 512; height = 256; format = BlitFormat_16bpp;
+            break;
+        case BgSize_B16_512x512:
+            width = 512; height = 512; format = BlitFormat_16bpp;
+            break;
+        default:
+            return -1;
+    }
+
+    const u16 *palette = (id < 4) ? BG_PALETTE : BG_PALETTE_SUB;
+
+    blitSurfaceInit(surface, bgGetGfxPtr(id), width, height, width, format,
+                    palette);
+
+    return 0;
+}
+
+void blitPutPixel(const BlitSurface *dst, int x, int y, u16 color)
+{
+    if ((x < 0) || (y < 0) || (x >= dst->width) || (y >= dst->height))
+        return;
+
+    if (dst->format == BlitFormat_16bpp)
+        *(u16 *)blit_pixel_ptr(dst, x, y) = color;
+    else
+        blit_put8(blit_pixel_ptr(dst, x, y), color);
+}
+
+void blitFillRect(const BlitSurface *dst, int x, int y, int w, int h, u16 color)
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > dst->width)
+        w = dst->width - x;
+    if (y + h > dst->height)
+        h = dst->height - y;
+
+    if ((w <= 0) || (h <= 0))
+        return;
+
+    if (dst->format == BlitFormat_16bpp)
+    {
+        // If the rectangle covers full rows it can be filled at once
+        if ((x == 0) && (w == dst->stride))
+        {
+            blit_fill16_row(blit_pixel_ptr(dst, 0, y), w * h, color);
+            return;
+        }
+
+        for (int j = y; j < y + h; j++)
+            blit_fill16_row(blit_pixel_ptr(dst, x, j), w, color);
+    }
+    else
+    {
+        if ((x == 0) && (w == dst->stride))
+        {
+            blit_fill8_row(blit_pixel_ptr(dst, 0, y), w * h, color);
+            return;
+        }
+
+        for (int j = y; j < y + h; j++)
+            blit_fill8_row(blit_pixel_ptr(dst, x, j), w, color);
+    }
+}
+
+void blitSpan(const BlitSurface *dst, int x0, int x1, int y, u16 color)
+{
+    if (x0 > x1)
+    {
+        int tmp = x0;
+        x0 = x1;
+        x1 = tmp;
+    }
+
+    blitFillRect(dst, x0, y, x1 - x0 + 1, 1, color);
+}
+
+void blitLine(const BlitSurface *dst, int x0, int y0, int x1, int y1, u16 color)
+{
+    if (y0 == y1)
+    {
+        blitSpan(dst, x0, x1, y0, color);
+        return;
+    }
+
+    if (x0 == x1)
+    {
+        if (y0 > y1)
+        {
+            int tmp = y0;
+            y0 = y1;
+            y1 = tmp;
+        }
+
+        blitFillRect(dst, x0, y0, 1, y1 - y0 + 1, color);
+        return;
+    }
+
+    // Bresenham's algorithm. Pixels outside of the surface are skipped by
+    // blitPutPixel().
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int step_x = (x0 < x1) ? 1 : -1;
+    int step_y = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+
+    while (1)
+    {
+        blitPutPixel(dst, x0, y0, color);
+
+        if ((x0 == x1) && (y0 == y1))
+            break;
+
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += step_x;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += step_y;
+        }
+    }
+}
+
+int blitCopy(const BlitSurface *dst, int dx, int dy,
+             const BlitSurface *src, int sx, int sy, int w, int h,
+             BlitMode mode, u16 param)
+{
+    if (!blit_supported(dst, src, mode))
+        return -1;
+
+    // Clip against the source and the destination
+    if (sx < 0)
+    {
+        w += sx;
+        dx -= sx;
+        sx = 0;
+    }
+    if (sy < 0)
+    {
+        h += sy;
+        dy -= sy;
+        sy = 0;
+    }
+    if (dx < 0)
+    {
+        w += dx;
+        sx -= dx;
+        dx = 0;
+    }
+    if (dy < 0)
+    {
+        h += dy;
+        sy -= dy;
+        dy = 0;
+    }
+    if (sx + w > src->width)
+        w = src->width - sx;
+    if (sy + h > src->height)
+        h = src->height - sy;
+    if (dx + w > dst->width)
+        w = dst->width - dx;
+    if (dy + h > dst->height)
+        h = dst->height - dy;
+
+    if ((w <= 0) || (h <= 0))
+        return 0;
+
+    bool overlap = (src->pixels == dst->pixels)
+                   && (dx < sx + w) && (sx < dx + w)
+                   && (dy < sy + h) && (sy < dy + h);
+
+    if (!overlap)
+    {
+        for (int j = 0; j < h; j++)
+        {
+            blit_row(dst, blit_pixel_ptr(dst, dx, dy + j),
+                     src, blit_pixel_ptr(src, sx, sy + j), w, mode, param);
+        }
+
+        return 0;
+    }
+
+    // The source and destination are the same surface (with the same format),
+    // and the rectangles overlap. Copy the rows in an order that doesn't
+    // overwrite rows that haven't been read yet, using a temporary buffer for
+    // each row.
+    u16 buffer[BLIT_CHUNK];
+    int bpp_shift = (src->format == BlitFormat_16bpp) ? 1 : 0;
+
+    for (int n = 0; n < h; n++)
+    {
+        int j = (dy > sy) ? (h - 1 - n) : n;
+
+        for (int i = 0; i < w; i += BLIT_CHUNK)
+        {
+            // Go backwards if the destination is to the right in the same row
+            int start = (dx > sx) ? (w - i - BLIT_CHUNK) : i;
+            int count = BLIT_CHUNK;
+            if (start < 0)
+            {
+                count += start;
+                start = 0;
+            }
+            if (start + count > w)
+                count = w - start;
+
+            const void *s = blit_pixel_ptr(src, sx + start, sy + j);
+            if (bpp_shift)
+                blit_copy16_row(buffer, s, count);
+            else
+                blit_copy8_row((u8 *)buffer, s, count);
+
+            blit_row(dst, blit_pixel_ptr(dst, dx + start, dy + j),
+                     src, buffer, count, mode, param);
+        }
+    }
+
+    return 0;
+}
+
+int blitScaled(const BlitSurface *dst, int dx, int dy, int dw, int dh,
+               const BlitSurface *src, int sx, int sy, int sw, int sh,
+               BlitMode mode, u16 param)
+{
+    if (!blit_supported(dst, src, mode))
+        return -1;
+
+    if ((dw <= 0) || (dh <= 0) || (sw <= 0) || (sh <= 0))
+        return 0;
+
+    if ((sx < 0) || (sy < 0) || (sx + sw > src->width)
+        || (sy + sh > src->height))
+        return -1;
+
+    // 16.16 fixed point steps in the source for each destination pixel
+    u64 step_x = ((u64)sw << 16) / dw;
+    u64 step_y = ((u64)sh << 16) / dh;
+
+    // Clip against the destination
+    int x_start = (dx < 0) ? -dx : 0;
+    int y_start = (dy < 0) ? -dy : 0;
+    int x_end = (dx + dw > dst->width) ? dst->width - dx : dw;
+    int y_end = (dy + dh > dst->height) ? dst->height - dy : dh;
+
+    if ((x_start >= x_end) || (y_start >= y_end))
+        return 0;
+
+    // The source coordinates are accumulated as an integer and a 16-bit
+    // fractional part, so they never overflow regardless of the size of the
+    // surfaces and the steps.
+    u32 step_x_int = step_x >> 16;
+    u32 step_x_frac = step_x & 0xFFFF;
+    u32 step_y_int = step_y >> 16;
+    u32 step_y_frac = step_y & 0xFFFF;
+
+    u64 start_x = (u64)x_start * step_x;
+    u64 start_y = (u64)y_start * step_y;
+
+    int src_y = sy + (start_y >> 16);
+    u32 frac_y = start_y & 0xFFFF;
+
+    u16 buffer[BLIT_CHUNK];
+
+    for (int j = y_start; j < y_end; j++)
+    {
+        int src_x = sx + (start_x >> 16);
+        u32 frac_x = start_x & 0xFFFF;
+
+        for (int i = x_start; i < x_end; i += BLIT_CHUNK)
+        {
+            int count = x_end - i;
+            if (count > BLIT_CHUNK)
+                count = BLIT_CHUNK;
+
+            // Gather the source pixels of this part of the row
+            if (src->format == BlitFormat_16bpp)
+            {
+                const u16 *s = blit_pixel_ptr(src, 0, src_y);
+                for (int k = 0; k < count; k++)
+                {
+                    buffer[k] = s[src_x];
+
+                    frac_x += step_x_frac;
+                    src_x += step_x_int + (frac_x >> 16);
+                    frac_x &= 0xFFFF;
+                }
+            }
+            else
+            {
+                const u8 *s = blit_pixel_ptr(src, 0, src_y);
+                u8 *b = (u8 *)buffer;
+                for (int k = 0; k < count; k++)
+                {
+                    b[k] = s[src_x];
+
+                    frac_x += step_x_frac;
+                    src_x += step_x_int + (frac_x >> 16);
+                    frac_x &= 0xFFFF;
+                }
+            }
+
+            blit_row(dst, blit_pixel_ptr(dst, dx + i, dy + j),
+                     src, buffer, count, mode, param);
+        }
+
+        frac_y += step_y_frac;
+        src_y += step_y_int + (frac_y >> 16);
+        frac_y &= 0xFFFF;
+    }
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+// This file doesn't access any hardware register so that it can be built for
+// the host as well as for the DS.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nds/arm9/glMesh.h>
+
+#include "arm9/video/gl_commands.h"
+
+// Helper to build packed display lists. Each command word holds up to 4 command
+// IDs, and it's followed by the parameters of all of them in the same order.
+typedef struct
+{
+    uint32_t *out;      // Destination buffer (or NULL to only count words)
+    size_t max;         // Size of the destination buffer in words
+    size_t pos;         // Next free word
+    size_t cmd_pos;     // Position of the current command word
+    int slot;           // Number of commands in the current command word
+    bool overflow;      // Set if the destination buffer is too small
+} mesh_writer;
+
+static void mesh_write_word(mesh_writer *w, uint32_t value)
+{
+    if (w->out != NULL)
+    {
+        if (w->pos >= w->max)
+            w->overflow = true;
+        else
+            w->out[w->pos] = value;
+    }
+
+    w->pos++;
+}
+
+static void mesh_write_command(mesh_writer *w, uint32_t id)
+{
+    if (w->slot == 4)
+        w->slot = 0;
+
+    if (w->slot == 0)
+    {
+        w->cmd_pos = w->pos;
+        mesh_write_word(w, 0);
+    }
+
+    if ((w->out != NULL) && (w->cmd_pos < w->max))
+        w->out[w->cmd_pos] |= id << (w->slot * 8);
+
+    w->slot++;
+}
+
+static inline bool mesh_fits_s10(int32_t value)
+{
+    return (value >= -512) && (value <= 511);
+}
+
+static inline uint32_t mesh_pack_s10(int32_t x, int32_t y, int32_t z)
+{
+    return ((uint32_t)x & 0x3FF) | (((uint32_t)y & 0x3FF) << 10)
+           | (((uint32_t)z & 0x3FF) << 20);
+}
+
+static inline uint32_t mesh_pack_s16(int32_t a, int32_t b)
+{
+    return ((uint32_t)a & 0xFFFF) | ((uint32_t)b << 16);
+}
+
+// Rounds a 4.12 coordinate to the nearest 4.6 coordinate
+static inline int32_t mesh_round_v10(int32_t v)
+{
+    int32_t r = (v + (1 << 5)) >> 6;
+    if (r > 511)
+        r = 511;
+    return r;
+}
+
+// Encodes one vertex. "prev" is the current vertex of the geometry engine, and
+// it's updated with the coordinates that the GPU will use.
+static void mesh_encode_vertex(mesh_writer *w, const int16_t *v, int16_t *prev,
+                               bool has_prev, unsigned int flags,
+                               glMeshStats *stats)
+{
+    int32_t x = v[0];
+    int32_t y = v[1];
+    int32_t z = v[2];
+
+    if (has_prev)
+    {
+        if (z == prev[2])
+        {
+            mesh_write_command(w, GL_CMD_VTX_XY);
+            mesh_write_word(w, mesh_pack_s16(x, y));
+            stats->vtx_xy_xz_yz++;
+            goto done;
+        }
+        if (y == prev[1])
+        {
+            mesh_write_command(w, GL_CMD_VTX_XZ);
+            mesh_write_word(w, mesh_pack_s16(x, z));
+            stats->vtx_xy_xz_yz++;
+            goto done;
+        }
+        if (x == prev[0])
+        {
+            mesh_write_command(w, GL_CMD_VTX_YZ);
+            mesh_write_word(w, mesh_pack_s16(y, z));
+            stats->vtx_xy_xz_yz++;
+            goto done;
+        }
+
+        int32_t dx = x - prev[0];
+        int32_t dy = y - prev[1];
+        int32_t dz = z - prev[2];
+
+        // The differences are stored in 1.0.9 format, so the GPU adds them to
+        // the previous coordinates multiplied by 8.
+        if ((((dx | dy | dz) & 7) == 0) && mesh_fits_s10(dx >> 3)
+            && mesh_fits_s10(dy >> 3) && mesh_fits_s10(dz >> 3))
+        {
+            mesh_write_command(w, GL_CMD_VTX_DIFF);
+            mesh_write_word(w, mesh_pack_s10(dx >> 3, dy >> 3, dz >> 3));
+            stats->vtx_diff++;
+            goto done;
+        }
+    }
+
+    if (((x | y | z) & 0x3F) == 0)
+    {
+        mesh_write_command(w, GL_CMD_VTX_10);
+        mesh_write_word(w, mesh_pack_s10(x >> 6, y >> 6, z >> 6));
+        stats->vtx10++;
+        goto done;
+    }
+
+    if (flags & GL_MESH_ROUND_VTX10)
+    {
+        int32_t rx = mesh_round_v10(x);
+        int32_t ry = mesh_round_v10(y);
+        int32_t rz = mesh_round_v10(z);
+
+        mesh_write_command(w, GL_CMD_VTX_10);
+        mesh_write_word(w, mesh_pack_s10(rx, ry, rz));
+        stats->vtx10++;
+        stats->rounded++;
+
+        prev[0] = rx << 6;
+        prev[1] = ry << 6;
+        prev[2] = rz << 6;
+        return;
+    }
+
+    mesh_write_command(w, GL_CMD_VTX_16);
+    mesh_write_word(w, mesh_pack_s16(x, y));
+    mesh_write_word(w, (uint32_t)z & 0xFFFF);
+    stats->vtx16++;
+
+done:
+    prev[0] = x;
+    prev[1] = y;
+    prev[2] = z;
+}
+
+size_t glMeshEncode(const glMeshStream *stream, uint32_t *out, size_t out_words,
+                    unsigned int flags, glMeshStats *stats)
+{
+    if ((stream == NULL) || (stream->positions == NULL))
+        return 0;
+
+    glMeshStats local_stats;
+    if (stats == NULL)
+        stats = &local_stats;
+    memset(stats, 0, sizeof(glMeshStats));
+
+    mesh_writer w = { 0 };
+    w.out = out;
+    w.max = out_words;
+
+    // Reserve space for the size of the list
+    mesh_write_word(&w, 0);
+
+    if (!(flags & GL_MESH_NO_BEGIN_END))
+    {
+        mesh_write_command(&w, GL_CMD_BEGIN_VTXS);
+        mesh_write_word(&w, stream->primitive & 3);
+    }
+
+    // The state of the geometry engine before the list is executed is unknown,
+    // so the first vertex and the first attributes are always sent.
+    int16_t prev[3] = { 0 };
+    bool has_prev = false;
+
+    uint32_t prev_color = 0, prev_normal = 0, prev_texcoord = 0;
+    bool has_color = false, has_normal = false, has_texcoord = false;
+
+    for (size_t i = 0; i < stream->count; i++)
+    {
+        if (stream->colors != NULL)
+        {
+            uint32_t color = stream->colors[i];
+            if (has_color && (color == prev_color))
+            {
+                stats->skipped_attrs++;
+            }
+            else
+            {
+                mesh_write_command(&w, GL_CMD_COLOR);
+                mesh_write_word(&w, color);
+                prev_color = color;
+                has_color = true;
+            }
+        }
+
+        if (stream->texcoords != NULL)
+        {
+            uint32_t texcoord = stream->texcoords[i];
+            if (has_texcoord && (texcoord == prev_texcoord))
+            {
+                stats->skipped_attrs++;
+            }
+            else
+            {
+                mesh_write_command(&w, GL_CMD_TEXCOORD);
+                mesh_write_word(&w, texcoord);
+                prev_texcoord = texcoord;
+                has_texcoord = true;
+            }
+        }
+
+        // The NORMAL command calculates the vertex color from the lights and
+        // the material, so it can't be skipped if a color has been set after
+        // the previous normal.
+        if (stream->normals != NULL)
+        {
+            uint32_t normal = stream->normals[i];
+            if (has_normal && (normal == prev_normal) && (stream->colors == NULL))
+            {
+                stats->skipped_attrs++;
+            }
+            else
+            {
+                mesh_write_command(&w, GL_CMD_NORMAL);
+                mesh_write_word(&w, normal);
+                prev_normal = normal;
+                has_normal = true;
+            }
+        }
+
+        mesh_encode_vertex(&w, &stream->positions[i * 3], prev, has_prev, flags,
+                           stats);
+        has_prev = true;
+    }
+
+    if (!(flags & GL_MESH_NO_BEGIN_END))
+        mesh_write_command(&w, GL_CMD_END_VTXS);
+
+    if (w.overflow)
+        return 0;
+
+    if (out != NULL)
+        out[0] = w.pos - 1;
+
+    stats->words = w.pos;
+
+    return w.pos;
+}
+
+int glMeshDecodePositions(const uint32_t *list, int16_t *positions,
+                          size_t max_vertices)
+{
+    if ((list == NULL) || (positions == NULL))
+        return -1;
+
+    uint32_t count = *list++;
+    const uint32_t *end = list + count;
+
+    int32_t x = 0, y = 0, z = 0;
+    size_t vertices = 0;
+
+    while (list < end)
+    {
+        uint32_t packed = *list++;
+
+        for (int i = 0; i < 4; i++)
+        {
+            uint32_t id = (packed >> (i * 8)) & 0xFF;
+
+            int params = gl_command_params(id);
+            if ((params < 0) || (list + params > end))
+                return -1;
+
+            if (gl_command_is_vertex(id))
+            {
+                uint32_t p = list[0];
+
+                switch (id)
+                {
+                    case GL_CMD_VTX_16:
+                        x = (int16_t)(p & 0xFFFF);
+                        y = (int16_t)(p >> 16);
+                        z = (int16_t)(list[1] & 0xFFFF);
+                        break;
+                    case GL_CMD_VTX_10:
+                        x = (int16_t)((p & 0x3FF) << 6);
+                        y = (int16_t)(((p >> 10) & 0x3FF) << 6);
+                        z = (int16_t)(((p >> 20) & 0x3FF) << 6);
+                        break;
+                    case GL_CMD_VTX_XY:
+                        x = (int16_t)(p & 0xFFFF);
+                        y = (int16_t)(p >> 16);
+                        break;
+                    case GL_CMD_VTX_XZ:
+                        x = (int16_t)(p & 0xFFFF);
+                        z = (int16_t)(p >> 16);
+                        break;
+                    case GL_CMD_VTX_YZ:
+                        y = (int16_t)(p & 0xFFFF);
+                        z = (int16_t)(p >> 16);
+                        break;
+                    case GL_CMD_VTX_DIFF:
+                        // Sign-extend the 10-bit values (in 1.0.9 format)
+                        x += (((int32_t)(p << 22)) >> 22) * 8;
+                        y += (((int32_t)(p << 12)) >> 22) * 8;
+                        z += (((int32_t)(p << 2)) >> 22) * 8;
+                        x = (int16_t)x;
+                        y = (int16_t)y;
+                        z = (int16_t)z;
+                        break;
+                }
+
+                if (vertices >= max_vertices)
+                    return -1;
+
+                positions[vertices * 3 + 0] = x;
+                positions[vertices * 3 + 1] = y;
+                positions[vertices * 3 + 2] = z;
+                vertices++;
+            }
+
+            list += params;
+        }
+    }
+
+    return vertices;
+}
@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/glProfiler.h>
+#include <nds/arm9/video.h>
+#include <nds/arm9/videoGL.h>
+#include <nds/interrupts.h>
+#include <nds/system_counter.h>
+
+#include "arm9/libnds_internal.h"
+#include "arm9/video/gl_commands.h"
+
+bool libnds_gl_profiler_active;
+
+static glProfilerSample *samples;
+static size_t samples_max;
+static size_t samples_count;
+static size_t samples_next;
+
+// Statistics of the frame that is being drawn
+static glProfilerSample current;
+
+// Returns the number of polygons formed by a number of vertices in a
+// glBegin() group.
+static uint32_t gl_polygons_in_group(uint32_t type, uint32_t vertices)
+{
+    switch (type)
+    {
+        case GL_TRIANGLES:
+            return vertices / 3;
+        case GL_QUADS:
+            return vertices / 4;
+        case GL_TRIANGLE_STRIP:
+            return vertices >= 3 ? vertices - 2 : 0;
+        case GL_QUAD_STRIP:
+            return vertices >= 4 ? (vertices - 2) / 2 : 0;
+        default:
+            return 0;
+    }
+}
+
+void libnds_gl_profiler_list(const u32 *list, u32 count, u32 stall_ticks)
+{
+    const u32 *end = list + count;
+
+    uint32_t commands = 0;
+    uint32_t vertices = 0;
+    uint32_t polygons = 0;
+
+    // Vertices of the current glBegin() group
+    uint32_t group_type = GL_TRIANGLES;
+    uint32_t group_vertices = 0;
+
+    while (list < end)
+    {
+        u32 packed = *list++;
+
+        for (int i = 0; i < 4; i++)
+        {
+            u32 id = (packed >> (i * 8)) & 0xFF;
+
+            int params = gl_command_params(id);
+            if (params < 0)
+                goto invalid; // Stop counting if the list looks corrupted
+
+            if (id != GL_CMD_NOP)
+                commands++;
+
+            if (gl_command_is_vertex(id))
+            {
+                vertices++;
+                group_vertices++;
+            }
+            else if (id == GL_CMD_BEGIN_VTXS)
+            {
+                polygons += gl_polygons_in_group(group_type, group_vertices);
+                group_type = (list < end) ? (*list & 3) : GL_TRIANGLES;
+                group_vertices = 0;
+            }
+
+            list += params;
+        }
+    }
+
+invalid:
+    polygons += gl_polygons_in_group(group_type, group_vertices);
+
+    current.dlist_calls++;
+    current.dlist_words += count;
+    current.dlist_commands += commands;
+    current.dlist_vertices += vertices;
+    current.dlist_polygons += polygons;
+    current.fifo_stall_ticks += stall_ticks;
+}
+
+int glProfilerInit(size_t num_samples)
+{
+    if (num_samples == 0)
+        return 0;
+
+    glProfilerSample *buffer = calloc(num_samples, sizeof(glProfilerSample));
+    if (buffer == NULL)
+        return 0;
+
+    free(samples);
+
+    samples = buffer;
+    samples_max = num_samples;
+
+    glProfilerReset();
+
+    libnds_gl_profiler_active = true;
+
+    return 1;
+}
+
+void glProfilerDeinit(void)
+{
+    libnds_gl_profiler_active = false;
+
+    free(samples);
+    samples = NULL;
+    samples_max = 0;
+    samples_count = 0;
+    samples_next = 0;
+}
+
+void glProfilerReset(void)
+{
+    samples_count = 0;
+    samples_next = 0;
+
+    memset(&current, 0, sizeof(current));
+}
+
+void glProfilerFlush(u32 mode)
+{
+    if (!libnds_gl_profiler_active)
+    {
+        glFlush(mode);
+        swiWaitForVBlank();
+        return;
+    }
+
+    uint64_t start = systemCounterGetTicks();
+
+    // Wait until all commands have been executed. The counters are only
+    // accurate after the geometry engine has processed all vertices.
+    while (GFX_BUSY);
+
+    uint64_t idle = systemCounterGetTicks();
+
+    current.polygons = GFX_POLYGON_RAM_USAGE;
+    current.vertices = GFX_VERTEX_RAM_USAGE;
+
+    // Acknowledge the overflow flag. Bit 12 is left as 0 so that the color
+    // buffer underflow flag isn't acknowledged by accident.
+    u16 control = GFX_CONTROL;
+    if (control & GL_POLY_OVERFLOW)
+    {
+        current.overflow = true;
+        GFX_CONTROL = (control & ~GL_COLOR_UNDERFLOW) | GL_POLY_OVERFLOW;
+    }
+
+    glFlush(mode);
+    swiWaitForVBlank();
+
+    uint64_t swapped = systemCounterGetTicks();
+
+    current.fifo_stall_ticks += idle - start;
+    current.swap_wait_ticks = swapped - idle;
+
+    samples[samples_next] = current;
+    samples_next++;
+    if (samples_next == samples_max)
+        samples_next = 0;
+    if (samples_count < samples_max)
+        samples_count++;
+
+    uint32_t frame = current.frame + 1;
+    memset(&current, 0, sizeof(current));
+    current.frame = frame;
+}
+
+size_t glProfilerGetSampleCount(void)
+{
+    return samples_count;
+}
+
+const glProfilerSample *glProfilerGetSample(size_t index)
+{
+    if (index >= samples_count)
+        return NULL;
+
+    size_t i = (samples_next + samples_max - 1 - index) % samples_max;
+    return &samples[i];
+}
+
+void glProfilerPrintSummary(void)
+{
+    const glProfilerSample *last = glProfilerGetSample(0);
+    if (last == NULL)
+    {
+        printf("GL profiler: no samples\n");
+        return;
+    }
+
+    uint32_t max_poly = 0, max_vtx = 0, max_stall = 0, max_swap = 0;
+    uint32_t sum_poly = 0, sum_vtx = 0;
+    uint64_t sum_stall = 0, sum_swap = 0; // They can overflow in long captures
+    uint32_t overflows = 0;
+
+    for (size_t i = 0; i < samples_count; i++)
+    {
+        const glProfilerSample *s = &samples[i];
+
+        sum_poly += s->polygons;
+        sum_vtx += s->vertices;
+        sum_stall += s->fifo_stall_ticks;
+        sum_swap += s->swap_wait_ticks;
+
+        if (s->polygons > max_poly)
+            max_poly = s->polygons;
+        if (s->vertices > max_vtx)
+            max_vtx = s->vertices;
+        if (s->fifo_stall_ticks > max_stall)
+            max_stall = s->fifo_stall_ticks;
+        if (s->swap_wait_ticks > max_swap)
+            max_swap = s->swap_wait_ticks;
+
+        if (s->overflow)
+            overflows++;
+    }
+
+    unsigned int n = samples_count;
+
+    printf("Frame %u%s\n", (unsigned int)last->frame,
+           last->overflow ? " OVERFLOW" : "");
+    printf("Poly: %4u/%d avg %4u max %4u\n", last->polygons, GL_MAX_POLYGONS,
+           (unsigned int)(sum_poly / n), (unsigned int)max_poly);
+    printf("Vtx:  %4u/%d avg %4u max %4u\n", last->vertices, GL_MAX_VERTICES,
+           (unsigned int)(sum_vtx / n), (unsigned int)max_vtx);
+    printf("DLists: %u calls %u cmds\n", (unsigned int)last->dlist_calls,
+           (unsigned int)last->dlist_commands);
+    printf("  vtx %u poly %u\n", (unsigned int)last->dlist_vertices,
+           (unsigned int)last->dlist_polygons);
+    printf("Stall: %u us avg %u max %u\n",
+           (unsigned int)systemCounterTicksToUsec(last->fifo_stall_ticks),
+           (unsigned int)systemCounterTicksToUsec(sum_stall / n),
+           (unsigned int)systemCounterTicksToUsec(max_stall));
+    printf("Swap:  %u us avg %u max %u\n",
+           (unsigned int)systemCounterTicksToUsec(last->swap_wait_ticks),
+           (unsigned int)systemCounterTicksToUsec(sum_swap / n),
+           (unsigned int)systemCounterTicksToUsec(max_swap));
+    printf("Overflows: %u/%u frames\n", (unsigned int)overflows, n);
+}
+
+int glProfilerDump(FILE *file)
+{
+    if (file == NULL)
+        return -1;
+
+    if (fprintf(file, "frame,polygons,vertices,overflow,dlist_calls,"
+                      "dlist_words,dlist_commands,dlist_vertices,"
+                      "dlist_polygons,fifo_stall_us,swap_wait_us\n") < 0)
+        return -1;
+
+    for (size_t i = samples_count; i > 0; i--)
+    {
+        const glProfilerSample *s = glProfilerGetSample(i - 1);
+
+        if (fprintf(file, "%u,%u,%u,%d,%u,%u,%u,%u,%u,%u,%u\n",
+                    (unsigned int)s->frame, s->polygons, s->vertices,
+                    s->overflow ? 1 : 0, (unsigned int)s->dlist_calls,
+                    (unsigned int)s->dlist_words,
+                    (unsigned int)s->dlist_commands,
+                    (unsigned int)s->dlist_vertices,
+                    (unsigned int)s->dlist_polygons,
+                    (unsigned int)systemCounterTicksToUsec(s->fifo_stall_ticks),
+                    (unsigned int)systemCounterTicksToUsec(s->swap_wait_ticks)) < 0)
+            return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/glTransQueue.h>
+#include <nds/arm9/videoGL.h>
+
+typedef struct
+{
+    const void *list;
+    m4x3 modelview;
+    u32 poly_format;
+} trans_entry;
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t index;
+} trans_key;
+
+static trans_entry *entries;
+static trans_key *keys;     // Keys in the order they have been added
+static trans_key *keys_tmp; // Temporary buffer for the radix sort
+static size_t entries_max;
+static size_t entries_count;
+
+int glTransQueueInit(size_t max_entries)
+{
+    if (max_entries == 0)
+        return 0;
+
+    trans_entry *new_entries = malloc(max_entries * sizeof(trans_entry));
+    trans_key *new_keys = malloc(max_entries * sizeof(trans_key));
+    trans_key *new_keys_tmp = malloc(max_entries * sizeof(trans_key));
+
+    if ((new_entries == NULL) || (new_keys == NULL) || (new_keys_tmp == NULL))
+    {
+        free(new_entries);
+        free(new_keys);
+        free(new_keys_tmp);
+        return 0;
+    }
+
+    glTransQueueDeinit();
+
+    entries = new_entries;
+    keys = new_keys;
+    keys_tmp = new_keys_tmp;
+    entries_max = max_entries;
+
+    return 1;
+}
+
+void glTransQueueDeinit(void)
+{
+    free(entries);
+    free(keys);
+    free(keys_tmp);
+
+    entries = NULL;
+    keys = NULL;
+    keys_tmp = NULL;
+    entries_max = 0;
+    entries_count = 0;
+}
+
+int glTransQueueAddDepth(const void *list, const m4x3 *modelview,
+                         u32 poly_format, int32_t depth)
+{
+    if (entries_count >= entries_max)
+        return 0;
+
+    size_t i = entries_count++;
+
+    entries[i].list = list;
+    entries[i].modelview = *modelview;
+    entries[i].poly_format = poly_format;
+
+    // Flip the sign bit so that the unsigned order of the keys is the same as
+    // the signed order of the depths.
+    keys[i].key = (uint32_t)depth ^ 0x80000000;
+    keys[i].index = i;
+
+    return 1;
+}
+
+size_t glTransQueueGetCount(void)
+{
+    return entries_count;
+}
+
+void glTransQueueClear(void)
+{
+    entries_count = 0;
+}
+
+// LSD radix sort with 8-bit digits. It's stable, and passes in which all keys
+// have the same digit are skipped (this is common in the top digits, as most
+// scenes only use a small range of depths). It returns the buffer that holds
+// the sorted keys.
+static trans_key *trans_radix_sort(trans_key *src, trans_key *dst, size_t count)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t offsets[256];
+        memset(offsets, 0, sizeof(offsets));
+
+        for (size_t i = 0; i < count; i++)
+            offsets[(src[i].key >> shift) & 0xFF]++;
+
+        if (offsets[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t sum = 0;
+        for (int d = 0; d < 256; d++)
+        {
+            size_t n = offsets[d];
+            offsets[d] = sum;
+            sum += n;
+        }
+
+        for (size_t i = 0; i < count; i++)
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        trans_key *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+void glTransQueueFlush(void)
+{
+    if (entries_count == 0)
+        return;
+
+    trans_key *sorted = trans_radix_sort(keys, keys_tmp, entries_count);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+
+    // The keys are sorted in ascending order. The camera looks towards -Z, so
+    // this draws the objects that are further away first.
+    for (size_t i = 0; i < entries_count; i++)
+    {
+        const trans_entry *e = &entries[sorted[i].index];
+
+        glLoadMatrix4x3(&e->modelview);
+        glPolyFmt(e->poly_format);
+        glCallList(e->list);
+    }
+
+    glPopMatrix(1);
+
+    entries_count = 0;
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef ARM9_VIDEO_GL_COMMANDS_H__
+#define ARM9_VIDEO_GL_COMMANDS_H__
+
+// IDs of the commands of the geometry engine, as used in packed display lists.
+// They are equivalent to the FIFO_* definitions of videoGL.h, but they don't
+// depend on any hardware register definition.
+
+#include <stdint.h>
+
+#define GL_CMD_NOP              0x00
+#define GL_CMD_COLOR            0x20
+#define GL_CMD_NORMAL           0x21
+#define GL_CMD_TEXCOORD         0x22
+#define GL_CMD_VTX_16           0x23
+#define GL_CMD_VTX_10           0x24
+#define GL_CMD_VTX_XY           0x25
+#define GL_CMD_VTX_XZ           0x26
+#define GL_CMD_VTX_YZ           0x27
+#define GL_CMD_VTX_DIFF         0x28
+#define GL_CMD_BEGIN_VTXS       0x40
+#define GL_CMD_END_VTXS         0x41
+
+// Number of parameters of each geometry command, indexed by command ID. A value
+// of -1 means that the command doesn't exist.
+static const int8_t gl_command_params_table[0x80] =
+{
+    [0x00] = 0,  // NOP
+    [0x01 ... 0x0F] = -1,
+    [0x10] = 1,  // MTX_MODE
+    [0x11] = 0,  // MTX_PUSH
+    [0x12] = 1,  // MTX_POP
+    [0x13] = 1,  // MTX_STORE
+    [0x14] = 1,  // MTX_RESTORE
+    [0x15] = 0,  // MTX_IDENTITY
+    [0x16] = 16, // MTX_LOAD_4x4
+    [0x17] = 12, // MTX_LOAD_4x3
+    [0x18] = 16, // MTX_MULT_4x4
+    [0x19] = 12, // MTX_MULT_4x3
+    [0x1A] = 9,  // MTX_MULT_3x3
+    [0x1B] = 3,  // MTX_SCALE
+    [0x1C] = 3,  // MTX_TRANS
+    [0x1D ... 0x1F] = -1,
+    [0x20] = 1,  // COLOR
+    [0x21] = 1,  // NORMAL
+    [0x22] = 1,  // TEXCOORD
+    [0x23] = 2,  // VTX_16
+    [0x24] = 1,  // VTX_10
+    [0x25] = 1,  // VTX_XY
+    [0x26] = 1,  // VTX_XZ
+    [0x27] = 1,  // VTX_YZ
+    [0x28] = 1,  // VTX_DIFF
+    [0x29] = 1,  // POLYGON_ATTR
+    [0x2A] = 1,  // TEXIMAGE_PARAM
+    [0x2B] = 1,  // PLTT_BASE
+    [0x2C ... 0x2F] = -1,
+    [0x30] = 1,  // DIF_AMB
+    [0x31] = 1,  // SPE_EMI
+    [0x32] = 1,  // LIGHT_VECTOR
+    [0x33] = 1,  // LIGHT_COLOR
+    [0x34] = 32, // SHININESS
+    [0x35 ... 0x3F] = -1,
+    [0x40] = 1,  // BEGIN_VTXS
+    [0x41] = 0,  // END_VTXS
+    [0x42 ... 0x4F] = -1,
+    [0x50] = 1,  // SWAP_BUFFERS
+    [0x51 ... 0x5F] = -1,
+    [0x60] = 1,  // VIEWPORT
+    [0x61 ... 0x6F] = -1,
+    [0x70] = 3,  // BOX_TEST
+    [0x71] = 2,  // POS_TEST
+    [0x72] = 1,  // VEC_TEST
+    [0x73 ... 0x7F] = -1,
+};
+
+// Returns the number of parameters of a command, or -1 if it isn't valid.
+static inline int gl_command_params(uint32_t id)
+{
+    if (id >= 0x80)
+        return -1;
+
+    return gl_command_params_table[id];
+}
+
+// Returns true if the command sets the coordinates of a new vertex.
+static inline int gl_command_is_vertex(uint32_t id)
+{
+    return (id >= GL_CMD_VTX_16) && (id <= GL_CMD_VTX_DIFF);
+}
+
+#endif // ARM9_VIDEO_GL_COMMANDS_H__
@@ -0,0 +1,417 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/cache.h>
+#include <nds/arm9/palette.h>
+#include <nds/arm9/video.h>
+#include <nds/dma.h>
+
+typedef struct
+{
+    u16 *base;
+    u16 *shadow;
+    int count;
+    int dirty_start;    // Range of modified colors: [dirty_start, dirty_end)
+    int dirty_end;
+} pal_state;
+
+static pal_state palettes[PalId_Count];
+
+static const int pal_size[PalId_Count] =
+{
+    [PalId_BgMain] = 256,
+    [PalId_SpriteMain] = 256,
+    [PalId_BgSub] = 256,
+    [PalId_SpriteSub] = 256,
+    [PalId_BgExtMain] = 4 * 4096,
+    [PalId_SpriteExtMain] = 4096,
+    [PalId_BgExtSub] = 4 * 4096,
+    [PalId_SpriteExtSub] = 4096,
+};
+
+// VRAM bank settings in which a bank holds part of an extended palette. When
+// the bank is mapped as LCD, colors [first, first + count) of the palette can
+// be accessed at the LCD address of the bank.
+typedef struct
+{
+    PalId id;
+    vu8 *cr;
+    u8 value;
+    u16 *lcd;
+    int first;
+    int count;
+} pal_ext_mapping;
+
+static const pal_ext_mapping pal_ext_mappings[] =
+{
+    { PalId_BgExtMain, &VRAM_E_CR, VRAM_ENABLE | VRAM_E_BG_EXT_PALETTE,
+      VRAM_E, 0, 4 * 4096 },
+    { PalId_BgExtMain, &VRAM_F_CR, VRAM_ENABLE | VRAM_F_BG_EXT_PALETTE_SLOT01,
+      VRAM_F, 0, 2 * 4096 },
+    { PalId_BgExtMain, &VRAM_F_CR, VRAM_ENABLE | VRAM_F_BG_EXT_PALETTE_SLOT23,
+      VRAM_F, 2 * 4096, 2 * 4096 },
+    { PalId_BgExtMain, &VRAM_G_CR, VRAM_ENABLE | VRAM_G_BG_EXT_PALETTE_SLOT01,
+      VRAM_G, 0, 2 * 4096 },
+    { PalId_BgExtMain, &VRAM_G_CR, VRAM_ENABLE | VRAM_G_BG_EXT_PALETTE_SLOT23,
+      VRAM_G, 2 * 4096, 2 * 4096 },
+    { PalId_SpriteExtMain, &VRAM_F_CR, VRAM_ENABLE | VRAM_F_SPRITE_EXT_PALETTE,
+      VRAM_F, 0, 4096 },
+    { PalId_SpriteExtMain, &VRAM_G_CR, VRAM_ENABLE | VRAM_G_SPRITE_EXT_PALETTE,
+      VRAM_G, 0, 4096 },
+    { PalId_BgExtSub, &VRAM_H_CR, VRAM_ENABLE | VRAM_H_SUB_BG_EXT_PALETTE,
+      VRAM_H, 0, 4 * 4096 },
+    { PalId_SpriteExtSub, &VRAM_I_CR, VRAM_ENABLE | VRAM_I_SUB_SPRITE_EXT_PALETTE,
+      VRAM_I, 0, 4096 },
+};
+
+// Masks that select groups of color components of two RGB15 colors packed in
+// a 32-bit word. The components in each group are separated by at least 5
+// bits, so they can be multiplied by a factor of up to 32 at the same time
+// without overflowing into each other.
+//
+// Group 1: R0 (bits 0-4), B0 (bits 10-14), G1 (bits 21-25)
+// Group 2 (word shifted right by 5): G0 (bits 0-4), R1 (bits 11-15),
+//                                    B1 (bits 21-25)
+#define PAL_MASK_1  0x03E07C1F
+#define PAL_MASK_2  0x03E0F81F
+
+static inline u32 pal_blend_word(u32 a, u32 b, u32 factor)
+{
+    u32 inv = PAL_BLEND_MAX - factor;
+
+    u32 g1 = (((a & PAL_MASK_1) * inv + (b & PAL_MASK_1) * factor) >> 5)
+             & PAL_MASK_1;
+    u32 g2 = ((((a >> 5) & PAL_MASK_2) * inv + ((b >> 5) & PAL_MASK_2) * factor)
+              >> 5) & PAL_MASK_2;
+
+    return g1 | (g2 << 5);
+}
+
+// Blends "count" pairs of colors with a constant color. The products of the
+// constant color are calculated once, so each pair needs two multiplications.
+ARM_CODE ITCM_CODE
+static void pal_blend_color_words(u32 *dst, const u32 *src, int count,
+                                  u32 color, u32 factor)
+{
+    u32 inv = PAL_BLEND_MAX - factor;
+    u32 t1 = (color & PAL_MASK_1) * factor;
+    u32 t2 = ((color >> 5) & PAL_MASK_2) * factor;
+
+    for (int i = 0; i < count; i++)
+    {
+        u32 a = src[i];
+
+        u32 g1 = (((a & PAL_MASK_1) * inv + t1) >> 5) & PAL_MASK_1;
+        u32 g2 = ((((a >> 5) & PAL_MASK_2) * inv + t2) >> 5) & PAL_MASK_2;
+
+        dst[i] = g1 | (g2 << 5);
+    }
+}
+
+ARM_CODE ITCM_CODE
+static void pal_blend_palette_words(u32 *dst, const u32 *src, const u32 *target,
+                                    int count, u32 factor)
+{
+    for (int i = 0; i < count; i++)
+        dst[i] = pal_blend_word(src[i], target[i], factor);
+}
+
+static pal_state *pal_get(PalId id)
+{
+    if ((unsigned int)id >= PalId_Count)
+        return NULL;
+
+    if (palettes[id].base == NULL)
+        return NULL;
+
+    return &palettes[id];
+}
+
+// Clamps a range of colors to the palette. Returns false if it's empty.
+static bool pal_clamp(const pal_state *p, int *start, int *count)
+{
+    if (*start < 0)
+    {
+        *count += *start;
+        *start = 0;
+    }
+
+    if (*start + *count > p->count)
+        *count = p->count - *start;
+
+    return *count > 0;
+}
+
+static void pal_mark_dirty(pal_state *p, int start, int count)
+{
+    if (p->dirty_start >= p->dirty_end)
+    {
+        p->dirty_start = start;
+        p->dirty_end = start + count;
+        return;
+    }
+
+    if (start < p->dirty_start)
+        p->dirty_start = start;
+    if (start + count > p->dirty_end)
+        p->dirty_end = start + count;
+}
+
+int palInit(PalId id, int count)
+{
+    if ((unsigned int)id >= PalId_Count)
+        return -1;
+
+    if (count == 0)
+        count = pal_size[id];
+
+    if ((count < 0) || (count > pal_size[id]))
+        return -1;
+
+    // Round up to an even number of colors so that both buffers are aligned to
+    // 4 bytes and they can be processed in pairs of colors.
+    int alloc_count = (count + 1) & ~1;
+
+    u16 *base = calloc(alloc_count * 2, sizeof(u16));
+    if (base == NULL)
+        return -1;
+
+    palDeinit(id);
+
+    pal_state *p = &palettes[id];
+
+    p->base = base;
+    p->shadow = base + alloc_count;
+    p->count = count;
+    p->dirty_start = 0;
+    p->dirty_end = count;
+
+    return 0;
+}
+
+void palDeinit(PalId id)
+{
+    if ((unsigned int)id >= PalId_Count)
+        return;
+
+    pal_state *p = &palettes[id];
+
+    free(p->base);
+    p->base = NULL;
+    p->shadow = NULL;
+    p->count = 0;
+}
+
+void palSet(PalId id, int start, const u16 *colors, int count)
+{
+    pal_state *p = pal_get(id);
+
+    if ((p == NULL) || (colors == NULL))
+        return;
+
+    if (start < 0)
+    {
+        colors -= start;
+        count += start;
+        start = 0;
+    }
+
+    if (!pal_clamp(p, &start, &count))
+        return;
+
+    memcpy(p->base + start, colors, count * sizeof(u16));
+    memcpy(p->shadow + start, colors, count * sizeof(u16));
+
+    pal_mark_dirty(p, start, count);
+}
+
+u16 *palGetBase(PalId id)
+{
+    pal_state *p = pal_get(id);
+
+    if (p == NULL)
+        return NULL;
+
+    return p->base;
+}
+
+void palRestore(PalId id, int start, int count)
+{
+    pal_state *p = pal_get(id);
+
+    if ((p == NULL) || !pal_clamp(p, &start, &count))
+        return;
+
+    memcpy(p->shadow + start, p->base + start, count * sizeof(u16));
+
+    pal_mark_dirty(p, start, count);
+}
+
+void palBlend(PalId id, int start, int count, u16 color, int factor)
+{
+    pal_state *p = pal_get(id);
+
+    if ((p == NULL) || !pal_clamp(p, &start, &count))
+        return;
+
+    if (factor < 0)
+        factor = 0;
+    else if (factor > PAL_BLEND_MAX)
+        factor = PAL_BLEND_MAX;
+
+    pal_mark_dirty(p, start, count);
+
+    u32 color2 = color | ((u32)color << 16);
+
+    int i = start;
+    int end = start + count;
+
+    // Process a color on its own if the range doesn't start at a word boundary
+    if (i & 1)
+    {
+        p->shadow[i] = pal_blend_word(p->base[i], color, factor);
+        i++;
+    }
+
+    int pairs = (end - i) >> 1;
+    pal_blend_color_words((u32 *)(p->shadow + i), (const u32 *)(p->base + i),
+                          pairs, color2, factor);
+    i += pairs * 2;
+
+    if (i < end)
+        p->shadow[i] = pal_blend_word(p->base[i], color, factor);
+}
+
+void palBlendPalette(PalId id, int start, int count, const u16 *target,
+                     int factor)
+{
+    pal_state *p = pal_get(id);
+
+    if ((p == NULL) || (target == NULL))
+        return;
+
+    if (start < 0)
+    {
+        target -= start;
+        count += start;
+        start = 0;
+    }
+
+    if (!pal_clamp(p, &start, &count))
+        return;
+
+    if (factor < 0)
+        factor = 0;
+    else if (factor > PAL_BLEND_MAX)
+        factor = PAL_BLEND_MAX;
+
+    pal_mark_dirty(p, start, count);
+
+    int i = start;
+    int end = start + count;
+
+    if (i & 1)
+    {
+        p->shadow[i] = pal_blend_word(p->base[i], *target, factor);
+        i++;
+        target++;
+    }
+
+    int pairs = (end - i) >> 1;
+    pal_blend_palette_words((u32 *)(p->shadow + i), (const u32 *)(p->base + i),
+                            (const u32 *)target, pairs, factor);
+    i += pairs * 2;
+    target += pairs * 2;
+
+    if (i < end)
+        p->shadow[i] = pal_blend_word(p->base[i], *target, factor);
+}
+
+void palCycle(PalId id, int start, int count, int offset)
+{
+    pal_state *p = pal_get(id);
+
+    if ((p == NULL) || !pal_clamp(p, &start, &count))
+        return;
+
+    offset %= count;
+    if (offset < 0)
+        offset += count;
+
+    // The range is split in two blocks that are copied to swapped positions
+    u16 *dst = p->shadow + start;
+    const u16 *src = p->base + start;
+
+    memcpy(dst, src + offset, (count - offset) * sizeof(u16));
+    memcpy(dst + count - offset, src, offset * sizeof(u16));
+
+    pal_mark_dirty(p, start, count);
+}
+
+static void pal_commit_ext(PalId id, pal_state *p)
+{
+    for (size_t m = 0; m < sizeof(pal_ext_mappings) / sizeof(pal_ext_mappings[0]); m++)
+    {
+        const pal_ext_mapping *map = &pal_ext_mappings[m];
+
+        if (map->id != id)
+            continue;
+
+        int start = p->dirty_start;
+        int end = p->dirty_end;
+
+        if (start < map->first)
+            start = map->first;
+        if (end > map->first + map->count)
+            end = map->first + map->count;
+        if (start >= end)
+            continue;
+
+        u8 cr = *(map->cr);
+        if (cr != map->value)
+            continue;
+
+        // Extended palettes can only be accessed by the CPU and DMA when the
+        // bank is mapped as LCD.
+        *(map->cr) = VRAM_ENABLE | 0;
+        dmaCopy(p->shadow + start, map->lcd + (start - map->first),
+                (end - start) * sizeof(u16));
+        *(map->cr) = cr;
+    }
+}
+
+void palCommit(void)
+{
+    static u16 *const pal_hw[] =
+    {
+        [PalId_BgMain] = BG_PALETTE,
+        [PalId_SpriteMain] = SPRITE_PALETTE,
+        [PalId_BgSub] = BG_PALETTE_SUB,
+        [PalId_SpriteSub] = SPRITE_PALETTE_SUB,
+    };
+
+    for (int id = 0; id < PalId_Count; id++)
+    {
+        pal_state *p = &palettes[id];
+
+        if ((p->base == NULL) || (p->dirty_start >= p->dirty_end))
+            continue;
+
+        int start = p->dirty_start;
+        size_t size = (p->dirty_end - start) * sizeof(u16);
+
+        DC_FlushRange(p->shadow + start, size);
+
+        if (id <= PalId_SpriteSub)
+            dmaCopy(p->shadow + start, pal_hw[id] + start, size);
+        else
+            pal_commit_ext(id, p);
+
+        p->dirty_start = 0;
+        p->dirty_end = 0;
+    }
+}
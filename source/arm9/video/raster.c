@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/background.h>
+#include <nds/arm9/cache.h>
+#include <nds/arm9/raster.h>
+#include <nds/arm9/video.h>
+#include <nds/dma.h>
+
+// Each table has one entry more than the number of scanlines. The HBlank of
+// scanline N copies entry N + 1, so the last transfer of the frame reads it.
+#define RASTER_ENTRIES  (SCREEN_HEIGHT + 1)
+
+typedef struct
+{
+    u8 *tables;         // Both tables, one after the other
+    volatile void *reg;
+    size_t entry_bytes;
+    size_t table_bytes;
+    int front;          // Table being displayed (0 or 1)
+    bool swap_pending;
+    bool started;       // A table has been swapped at least once
+} raster_effect;
+
+static raster_effect effects[4];
+
+int rasterInit(int channel, volatile void *reg, size_t entryBytes)
+{
+    if ((channel < 0) || (channel > 3) || (reg == NULL))
+        return -1;
+
+    if ((entryBytes == 0) || (entryBytes & 1))
+        return -1;
+
+    // Align the tables to cache lines so that they can be flushed without
+    // affecting other data.
+    size_t table_bytes = (RASTER_ENTRIES * entryBytes + 31) & ~31;
+
+    u8 *tables = memalign(32, table_bytes * 2);
+    if (tables == NULL)
+        return -1;
+
+    rasterDeinit(channel);
+
+    memset(tables, 0, table_bytes * 2);
+
+    raster_effect *e = &effects[channel];
+
+    e->tables = tables;
+    e->reg = reg;
+    e->entry_bytes = entryBytes;
+    e->table_bytes = table_bytes;
+    e->front = 0;
+    e->swap_pending = false;
+    e->started = false;
+
+    return 0;
+}
+
+int rasterInitScroll(int channel, int id)
+{
+    if ((id < 0) || (id > 7))
+        return -1;
+
+    return rasterInit(channel, bgScrollTable[id], sizeof(bg_scroll));
+}
+
+int rasterInitAffine(int channel, int id)
+{
+    if ((id < 0) || (id > 7) || (bgTransform[id] == NULL))
+        return -1;
+
+    return rasterInit(channel, bgTransform[id], sizeof(bg_transform));
+}
+
+int rasterInitWindow(int channel, WINDOW window, bool sub)
+{
+    vu16 *reg;
+
+    if (window == WINDOW_0)
+        reg = sub ? &REG_WIN0H_SUB : &REG_WIN0H;
+    else if (window == WINDOW_1)
+        reg = sub ? &REG_WIN1H_SUB : &REG_WIN1H;
+    else
+        return -1;
+
+    return rasterInit(channel, reg, sizeof(u16));
+}
+
+int rasterInitPalette(int channel, u16 *palette, int count)
+{
+    if (count <= 0)
+        return -1;
+
+    return rasterInit(channel, palette, count * sizeof(u16));
+}
+
+void rasterDeinit(int channel)
+{
+    if ((channel < 0) || (channel > 3))
+        return;
+
+    raster_effect *e = &effects[channel];
+
+    if (e->tables == NULL)
+        return;
+
+    dmaStopSafe(channel);
+
+    free(e->tables);
+    e->tables = NULL;
+}
+
+void *rasterGetTable(int channel)
+{
+    if ((channel < 0) || (channel > 3))
+        return NULL;
+
+    raster_effect *e = &effects[channel];
+
+    if (e->tables == NULL)
+        return NULL;
+
+    return e->tables + (e->front ^ 1) * e->table_bytes;
+}
+
+void rasterSwap(int channel)
+{
+    u8 *table = rasterGetTable(channel);
+
+    if (table == NULL)
+        return;
+
+    raster_effect *e = &effects[channel];
+
+    // The extra entry is written to the registers at the end of the frame.
+    // Make it the same as the first one so that the registers have the values
+    // of the start of the frame during VBlank.
+    memcpy(table + SCREEN_HEIGHT * e->entry_bytes, table, e->entry_bytes);
+
+    // The DMA reads the table from main RAM, not from the data cache
+    DC_FlushRange(table, e->table_bytes);
+
+    e->swap_pending = true;
+}
+
+// Copies an entry of a table to the registers with the CPU
+static void raster_write_entry(raster_effect *e, const u8 *entry)
+{
+    if ((e->entry_bytes & 3) == 0)
+    {
+        const u32 *src = (const u32 *)entry;
+        vu32 *dst = e->reg;
+
+        for (size_t i = 0; i < e->entry_bytes / 4; i++)
+            dst[i] = src[i];
+    }
+    else
+    {
+        const u16 *src = (const u16 *)entry;
+        vu16 *dst = e->reg;
+
+        for (size_t i = 0; i < e->entry_bytes / 2; i++)
+            dst[i] = src[i];
+    }
+}
+
+void rasterVBlank(void)
+{
+    for (int channel = 0; channel < 4; channel++)
+    {
+        raster_effect *e = &effects[channel];
+
+        if (e->tables == NULL)
+            continue;
+
+        if (e->swap_pending)
+        {
+            e->front ^= 1;
+            e->swap_pending = false;
+            e->started = true;
+        }
+
+        if (!e->started)
+            continue;
+
+        // Stop the transfer of the previous frame. The DMA is idle during
+        // VBlank because HBlank DMA is only started in visible scanlines.
+        dmaStopSafe(channel);
+
+        const u8 *table = e->tables + e->front * e->table_bytes;
+
+        raster_write_entry(e, table);
+
+        u32 ctrl = DMA_ENABLE | DMA_REPEAT | DMA_START_HBL | DMA_SRC_INC
+                 | DMA_DST_RESET;
+
+        if ((e->entry_bytes & 3) == 0)
+            ctrl |= DMA_32_BIT | (e->entry_bytes >> 2);
+        else
+            ctrl |= DMA_16_BIT | (e->entry_bytes >> 1);
+
+        dmaSetParams(channel, table + e->entry_bytes, (void *)e->reg, ctrl);
+    }
+}
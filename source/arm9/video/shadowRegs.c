@@ -5,7 +5,92 @@
 
 // Shadow variables for write only registers
 
+#include <string.h>
+
+#include <nds/arm9/background.h>
+#include <nds/interrupts.h>
 #include <nds/ndstypes.h>
 
+#include "arm9/video/background_internal.h"
+
 u16 mosaicShadow = 0;
 u16 mosaicShadowSub = 0;
+
+// Registers modified by the background functions, and the last values published
+// by bgUpdate(), which are the ones copied to the hardware during VBlank.
+bg_shadow_regs bg_shadow_work[2];
+static bg_shadow_regs bg_shadow_published[2];
+
+bool bg_shadow_enabled;
+static volatile bool bg_shadow_pending;
+
+// Offset of BG0CNT from the start of the I/O registers of each engine
+#define BG_REGS_OFFSET  0x8
+
+void bg_shadow_publish(void)
+{
+    // The VBlank handler can't run in the middle of the copy, so it never sees
+    // half of the values of a frame.
+    int oldIME = enterCriticalSection();
+
+    memcpy(bg_shadow_published, bg_shadow_work, sizeof(bg_shadow_published));
+    bg_shadow_pending = true;
+
+    leaveCriticalSection(oldIME);
+}
+
+void bgShadowEnable(void)
+{
+    if (bg_shadow_enabled)
+        return;
+
+    // The control registers can be read, but the other ones are write-only.
+    // They are generated again from the state of the backgrounds.
+    for (int i = 0; i < 4; i++)
+    {
+        bg_shadow_work[0].control[i] = BGCTRL[i];
+        bg_shadow_work[1].control[i] = BGCTRL_SUB[i];
+    }
+
+    bg_shadow_enabled = true;
+
+    // Layers 0 and 1 don't have affine registers
+    for (int i = 0; i < 8; i++)
+    {
+        if (bgIsText(i) || ((i & 3) >= 2))
+            bgState[i].dirty = true;
+    }
+
+    bgUpdate();
+}
+
+void bgShadowDisable(void)
+{
+    if (!bg_shadow_enabled)
+        return;
+
+    bg_shadow_publish();
+    bgShadowCommit();
+
+    bg_shadow_enabled = false;
+}
+
+void bgShadowCommit(void)
+{
+    if (!bg_shadow_enabled || !bg_shadow_pending)
+        return;
+
+    // The copy is done with the CPU instead of DMA. 14 words per engine are
+    // copied faster than setting up a DMA transfer, and it's safe to do it
+    // from an interrupt handler that interrupts a DMA copy in channel 3.
+    for (int engine = 0; engine < 2; engine++)
+    {
+        const u32 *src = (const u32 *)&bg_shadow_published[engine];
+        vu32 *dst = (vu32 *)(0x04000000 + (engine << 12) + BG_REGS_OFFSET);
+
+        for (size_t i = 0; i < sizeof(bg_shadow_regs) / 4; i++)
+            dst[i] = src[i];
+    }
+
+    bg_shadow_pending = false;
+}
@@ -10,6 +10,8 @@
 #include <nds/dma.h>
 #include <nds/interrupts.h>
 
+#include "arm9/video/sprite_internal.h"
+
 SpriteEntry OamMemorySub[128];
 SpriteEntry OamMemory[128];
 
@@ -20,7 +22,10 @@ OamState oamMain =
     .allocBufferSize = 32,
     .allocBuffer = NULL,
     .oamMemory = OamMemory,
-    .spriteMapping = SpriteMapping_1D_128
+    .spriteMapping = SpriteMapping_1D_128,
+    .updateMode = OamUpdateMode_Full,
+    .updateDmaChannel = 0,
+    .buddyState = NULL
 };
 
 OamState oamSub =
@@ -30,7 +35,10 @@ OamState oamSub =
     .allocBufferSize = 32,
     .allocBuffer = NULL,
     .oamMemory = OamMemorySub,
-    .spriteMapping = SpriteMapping_1D_128
+    .spriteMapping = SpriteMapping_1D_128,
+    .updateMode = OamUpdateMode_Full,
+    .updateDmaChannel = 0,
+    .buddyState = NULL
 };
 
 void oamInit(OamState *oam, SpriteMapping mapping, bool extPalette)
@@ -41,6 +49,9 @@ void oamInit(OamState *oam, SpriteMapping mapping, bool extPalette)
 
     oam->spriteMapping = mapping;
 
+    // Make sure that there isn't any transfer in progress
+    oamUpdateWait(oam);
+
     dmaFillWords(0, oam->oamMemory, sizeof(OamMemory));
 
     for (int i = 0; i < 128; i++)
@@ -71,6 +82,9 @@ void oamInit(OamState *oam, SpriteMapping mapping, bool extPalette)
         REG_DISPCNT_SUB |= DISPLAY_SPR_ACTIVE | (mapping & 0xffffff0) | extPaletteFlag;
     }
 
+    for (int i = 0; i < SPRITE_COUNT / 32; i++)
+        oam->dirtyMask[i] = 0;
+
     oamAllocReset(oam);
 }
 
@@ -113,6 +127,8 @@ void oamClear(OamState *oam, int start, int count)
 
     for (i = start; i < count + start; i++)
         oam->oamMemory[i].attribute[0] = ATTR0_DISABLED;
+
+    oamMarkDirty(oam, start, count);
 }
 
 unsigned int oamGfxPtrToOffset(OamState *oam, const void *offset)
@@ -186,51 +202,66 @@ SpriteSize oamDimensionsToSize(int width, int height)
     return SpriteSize_Invalid;
 }
 
-void oamSet(OamState *oam, int id, int x, int y, int priority, int palette_alpha,
-            SpriteSize size, SpriteColorFormat format, const void *gfxOffset,
-            int affineIndex, bool sizeDouble, bool hide, bool hflip, bool vflip,
-            bool mosaic)
+void oam_set_entry(OamState *oam, SpriteEntry *entry, int x, int y, int priority,
+                   int palette_alpha, SpriteSize size, SpriteColorFormat format,
+                   const void *gfxOffset, int affineIndex, bool sizeDouble,
+                   bool hide, bool hflip, bool vflip, bool mosaic)
 {
-    oam->oamMemory[id].shape = SPRITE_SIZE_SHAPE(size);
-    oam->oamMemory[id].size = SPRITE_SIZE_SIZE(size);
-    oam->oamMemory[id].x = x;
-    oam->oamMemory[id].y = y;
-    oam->oamMemory[id].priority = priority;
-    oam->oamMemory[id].hFlip = hflip;
-    oam->oamMemory[id].vFlip = vflip;
-    oam->oamMemory[id].isMosaic = mosaic;
-    oam->oamMemory[id].gfxIndex = oamGfxPtrToOffset(oam, gfxOffset);
+    entry->shape = SPRITE_SIZE_SHAPE(size);
+    entry->size = SPRITE_SIZE_SIZE(size);
+    entry->x = x;
+    entry->y = y;
+    entry->priority = priority;
+    entry->hFlip = hflip;
+    entry->vFlip = vflip;
+    entry->isMosaic = mosaic;
+    entry->gfxIndex = oamGfxPtrToOffset(oam, gfxOffset);
 
     if (affineIndex >= 0 && affineIndex < 32)
     {
-        oam->oamMemory[id].rotationIndex = affineIndex;
-        oam->oamMemory[id].isSizeDouble = sizeDouble;
-        oam->oamMemory[id].isRotateScale = true;
+        entry->rotationIndex = affineIndex;
+        entry->isSizeDouble = sizeDouble;
+        entry->isRotateScale = true;
         sassert(!hide, "oamSet() cannot set hide on a RotateScale sprite");
     }
     else
     {
-        oam->oamMemory[id].isSizeDouble = false;
-        oam->oamMemory[id].isRotateScale = false;
-        oam->oamMemory[id].isHidden = hide ? true : false;
+        entry->isSizeDouble = false;
+        entry->isRotateScale = false;
+        entry->isHidden = hide ? true : false;
     }
 
     if (format == SpriteColorFormat_Bmp)
     {
-        oam->oamMemory[id].blendMode = OBJMODE_BITMAP;
-        oam->oamMemory[id].colorMode = 0;
-        oam->oamMemory[id].alpha = palette_alpha;
+        entry->blendMode = OBJMODE_BITMAP;
+        entry->colorMode = 0;
+        entry->alpha = palette_alpha;
     }
     else
     {
-        oam->oamMemory[id].blendMode = OBJMODE_NORMAL;
+        entry->blendMode = OBJMODE_NORMAL;
         // SpriteColorFormat is identical to ObjColMode except for
         // SpriteColorFormat_Bmp, checked for above
-        oam->oamMemory[id].colorMode = (ObjColMode)format;
-        oam->oamMemory[id].palette = palette_alpha;
+        entry->colorMode = (ObjColMode)format;
+        entry->palette = palette_alpha;
     }
 }
 
+void oamSet(OamState *oam, int id, int x, int y, int priority, int palette_alpha,
+            SpriteSize size, SpriteColorFormat format, const void *gfxOffset,
+            int affineIndex, bool sizeDouble, bool hide, bool hflip, bool vflip,
+            bool mosaic)
+{
+    sassert(id >= 0 && id < SPRITE_COUNT,
+            "oamSet() index is out of bounds, must be 0-127");
+
+    oam_set_entry(oam, &oam->oamMemory[id], x, y, priority, palette_alpha, size,
+                  format, gfxOffset, affineIndex, sizeDouble, hide, hflip,
+                  vflip, mosaic);
+
+    oamMarkEntryDirty(oam, id);
+}
+
 void oamSetGfx(OamState *oam, int id, SpriteSize size, SpriteColorFormat format,
                const void *gfxOffset)
 {
@@ -255,16 +286,114 @@ void oamSetGfx(OamState *oam, int id, SpriteSize size, SpriteColorFormat format,
         // SpriteColorFormat_Bmp, checked for above
         oam->oamMemory[id].colorMode = (ObjColMode)format;
     }
+
+    oamMarkEntryDirty(oam, id);
+}
+
+int oamSetUpdateMode(OamState *oam, OamUpdateMode mode, int dmaChannel)
+{
+    sassert(dmaChannel >= 0 && dmaChannel < 4,
+            "oamSetUpdateMode() dmaChannel is out of bounds, must be 0-3");
+
+    if ((dmaChannel < 0) || (dmaChannel > 3))
+        return -1;
+
+    // Channel 3 is used by dmaCopy() and similar functions, which would stop
+    // the transfer if they were called before it ends.
+    sassert(mode != OamUpdateMode_DirtyAsync || dmaChannel != 3,
+            "oamSetUpdateMode() can't use DMA channel 3 in async mode");
+
+    if ((mode == OamUpdateMode_DirtyAsync) && (dmaChannel == 3))
+        return -1;
+
+    oamUpdateWait(oam);
+
+    oam->updateMode = mode;
+    oam->updateDmaChannel = dmaChannel;
+
+    return 0;
+}
+
+void oamMarkDirty(OamState *oam, int start, int count)
+{
+    if (count == 0)
+    {
+        count = SPRITE_COUNT;
+        start = 0;
+    }
+
+    for (int i = start; i < count + start; i++)
+        oamMarkEntryDirty(oam, i);
+}
+
+void oamUpdateWait(OamState *oam)
+{
+    if (oam->updateMode == OamUpdateMode_DirtyAsync)
+    {
+        while (dmaBusy(oam->updateDmaChannel));
+    }
 }
 
 void oamUpdate(OamState *oam)
 {
-    DC_FlushRange(oam->oamMemory, sizeof(OamMemory));
+    u16 *hw = (oam == &oamMain) ? OAM : OAM_SUB;
 
-    if (oam == &oamMain)
-        dmaCopy(oam->oamMemory, OAM, sizeof(OamMemory));
+    if (oam->updateMode == OamUpdateMode_Full)
+    {
+        DC_FlushRange(oam->oamMemory, sizeof(OamMemory));
+        dmaCopy(oam->oamMemory, hw, sizeof(OamMemory));
+    }
     else
-        dmaCopy(oam->oamMemory, OAM_SUB, sizeof(OamMemory));
+    {
+        // Wait for the previous asynchronous transfer, if any
+        oamUpdateWait(oam);
+
+        int first = -1;
+        int last = -1;
+        int i = 0;
+
+        while (i < SPRITE_COUNT)
+        {
+            u32 mask = oam->dirtyMask[i >> 5] >> (i & 31);
+            if (mask == 0)
+            {
+                // Skip the rest of the word
+                i = (i | 31) + 1;
+                continue;
+            }
+
+            i += __builtin_ctz(mask);
+
+            // Look for the end of this range of modified entries
+            int start = i;
+            while ((i < SPRITE_COUNT) && (oam->dirtyMask[i >> 5] & BIT(i & 31)))
+                i++;
+
+            if (first < 0)
+                first = start;
+            last = i;
+
+            if (oam->updateMode == OamUpdateMode_Dirty)
+            {
+                size_t size = (i - start) * sizeof(SpriteEntry);
+                DC_FlushRange(&oam->oamMemory[start], size);
+                dmaCopy(&oam->oamMemory[start], &hw[start * 4], size);
+            }
+        }
+
+        if ((oam->updateMode == OamUpdateMode_DirtyAsync) && (first >= 0))
+        {
+            // Copy all entries between the first and last modified entries
+            // with only one transfer.
+            size_t size = (last - first) * sizeof(SpriteEntry);
+            DC_FlushRange(&oam->oamMemory[first], size);
+            dmaSetParams(oam->updateDmaChannel, &oam->oamMemory[first],
+                         &hw[first * 4], DMA_COPY_WORDS | (size >> 2));
+        }
+    }
+
+    for (int i = 0; i < SPRITE_COUNT / 32; i++)
+        oam->dirtyMask[i] = 0;
 }
 
 void oamRotateScale(OamState *oam, int rotId, int angle, int sx, int sy)
@@ -279,4 +408,6 @@ void oamRotateScale(OamState *oam, int rotId, int angle, int sx, int sy)
     oam->oamRotationMemory[rotId].vdx = (-ss * sx) >> 12;
     oam->oamRotationMemory[rotId].hdy = (ss * sy) >> 12;
     oam->oamRotationMemory[rotId].vdy = (cc * sy) >> 12;
+
+    oamMarkAffineDirty(oam, rotId);
 }
@@ -4,7 +4,9 @@
 // Copyright (C) 2008-2010 Jason Rogers (dovoto)
 // Copyright (C) 2008-2009 Dave Murphy (WinterMute)
 
+#include <malloc.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <nds/arm9/cache.h>
 #include <nds/arm9/console.h>
@@ -53,6 +55,8 @@ static void oamAllocPrepare(OamState *oam)
     }
 }
 
+static void buddyReset(struct OamBuddyState *bs);
+
 void oamAllocReset(OamState *oam)
 {
     // free the buffer if not null & reset size
@@ -63,6 +67,9 @@ void oamAllocReset(OamState *oam)
         oam->allocBufferSize = 32;
         oam->firstFree = 0;
     }
+
+    if (oam->buddyState != NULL)
+        buddyReset(oam->buddyState);
 }
 
 static int simpleAlloc(OamState *oam, int size)
@@ -228,6 +235,337 @@ static void simpleFree(OamState *oam, int index)
     }
 }
 
+// Buddy allocator
+// ===============
+//
+// The 1024 allocation units are split in blocks of 2^order units, aligned to
+// their size. Each order has a doubly linked list of free blocks, and a bitmap
+// tells which lists aren't empty, so finding a free block is a single count of
+// trailing zeroes. Blocks are split and merged at most BUDDY_MAX_ORDER times.
+
+#define BUDDY_UNITS         1024
+#define BUDDY_MAX_ORDER     10
+#define BUDDY_NONE          0xFFFF
+
+// Information stored for the first unit of each block. It's zero for all other
+// units, so the buddy of a block can only be merged if it starts a block.
+#define BUDDY_FREE          BIT(6)
+#define BUDDY_USED          BIT(7)
+#define BUDDY_ORDER_MASK    0x0F
+
+struct OamBuddyState
+{
+    u16 next[BUDDY_UNITS];          // Links of the lists of free blocks
+    u16 prev[BUDDY_UNITS];
+    u16 head[BUDDY_MAX_ORDER + 1];  // First free block of each order
+    u16 nonEmpty;                   // Bitmap of orders with free blocks
+    u8 info[BUDDY_UNITS];           // Order and state of each block
+};
+
+static void buddyPush(struct OamBuddyState *bs, int index, int order)
+{
+    int first = bs->head[order];
+
+    bs->info[index] = BUDDY_FREE | order;
+    bs->prev[index] = BUDDY_NONE;
+    bs->next[index] = first;
+    if (first != BUDDY_NONE)
+        bs->prev[first] = index;
+
+    bs->head[order] = index;
+    bs->nonEmpty |= BIT(order);
+}
+
+static void buddyRemove(struct OamBuddyState *bs, int index, int order)
+{
+    int prev = bs->prev[index];
+    int next = bs->next[index];
+
+    if (prev != BUDDY_NONE)
+        bs->next[prev] = next;
+    else
+        bs->head[order] = next;
+
+    if (next != BUDDY_NONE)
+        bs->prev[next] = prev;
+
+    if (bs->head[order] == BUDDY_NONE)
+        bs->nonEmpty &= ~BIT(order);
+
+    bs->info[index] = 0;
+}
+
+// Adds the range [start, BUDDY_UNITS) to the free lists as the biggest blocks
+// that are aligned to their size.
+static void buddyFreeTail(struct OamBuddyState *bs, int start)
+{
+    while (start < BUDDY_UNITS)
+    {
+        int order = start ? __builtin_ctz(start) : BUDDY_MAX_ORDER;
+        while (start + (1 << order) > BUDDY_UNITS)
+            order--;
+
+        buddyPush(bs, start, order);
+        start += 1 << order;
+    }
+}
+
+static void buddyReset(struct OamBuddyState *bs)
+{
+    memset(bs->info, 0, sizeof(bs->info));
+    for (int i = 0; i <= BUDDY_MAX_ORDER; i++)
+        bs->head[i] = BUDDY_NONE;
+    bs->nonEmpty = 0;
+
+    buddyFreeTail(bs, 0);
+}
+
+static int buddyAlloc(struct OamBuddyState *bs, int size)
+{
+    int order = (size <= 1) ? 0 : 32 - __builtin_clz(size - 1);
+
+    u32 candidates = bs->nonEmpty & ~(BIT(order) - 1);
+    if (candidates == 0)
+        return -1;
+
+    int found = __builtin_ctz(candidates);
+    int index = bs->head[found];
+
+    buddyRemove(bs, index, found);
+
+    // Split the block until it has the right size. The second half of each
+    // split goes back to the free lists.
+    while (found > order)
+    {
+        found--;
+        buddyPush(bs, index + (1 << found), found);
+    }
+
+    bs->info[index] = BUDDY_USED | order;
+
+    return index;
+}
+
+static void buddyFree(struct OamBuddyState *bs, int index)
+{
+    if ((index < 0) || (index >= BUDDY_UNITS))
+        return;
+
+    if (!(bs->info[index] & BUDDY_USED))
+        return;
+
+    int order = bs->info[index] & BUDDY_ORDER_MASK;
+    bs->info[index] = 0;
+
+    while (order < BUDDY_MAX_ORDER)
+    {
+        int buddy = index ^ (1 << order);
+
+        if (bs->info[buddy] != (BUDDY_FREE | order))
+            break;
+
+        buddyRemove(bs, buddy, order);
+
+        index &= ~(1 << order);
+        order++;
+    }
+
+    buddyPush(bs, index, order);
+}
+
+static int buddyCountFragments(struct OamBuddyState *bs)
+{
+    int frags = 0;
+
+    for (int i = 0; i < BUDDY_UNITS; i += 1 << (bs->info[i] & BUDDY_ORDER_MASK))
+    {
+        if (bs->info[i] & BUDDY_FREE)
+            frags++;
+    }
+
+    return frags;
+}
+
+int oamSetAllocator(OamState *oam, OamAllocator allocator)
+{
+    if (allocator == OamAllocator_Buddy)
+    {
+        if (oam->buddyState == NULL)
+        {
+            oam->buddyState = malloc(sizeof(struct OamBuddyState));
+            if (oam->buddyState == NULL)
+                return -1;
+        }
+
+        buddyReset(oam->buddyState);
+    }
+    else
+    {
+        free(oam->buddyState);
+        oam->buddyState = NULL;
+    }
+
+    // Discard the state of the first fit allocator
+    oamAllocReset(oam);
+
+    return 0;
+}
+
+int oamAllocCompact(OamState *oam, OamRelocateFn callback, void *userdata)
+{
+    struct OamBuddyState *bs = oam->buddyState;
+
+    if (bs == NULL)
+        return -1;
+
+    // The tile index of a sprite is only proportional to the offset of its
+    // graphics in 1D mode.
+    if (!(oam->spriteMapping & DISPLAY_SPR_1D))
+        return -1;
+
+    // Sort the used blocks by decreasing size with a counting sort, keeping
+    // the original order of blocks of the same size. Packing them in this
+    // order keeps all of them aligned to their size.
+    u16 count[BUDDY_MAX_ORDER + 1] = { 0 };
+
+    for (int i = 0; i < BUDDY_UNITS; i += 1 << (bs->info[i] & BUDDY_ORDER_MASK))
+    {
+        if (bs->info[i] & BUDDY_USED)
+            count[bs->info[i] & BUDDY_ORDER_MASK]++;
+    }
+
+    // Unit where the blocks of each order start in the new layout
+    u16 dest[BUDDY_MAX_ORDER + 1];
+    int end = 0;
+    for (int order = BUDDY_MAX_ORDER; order >= 0; order--)
+    {
+        dest[order] = end;
+        end += count[order] << order;
+    }
+
+    // Destination of each unit that has to be moved, and size of the data
+    // that has to be moved.
+    u16 *remap = malloc(sizeof(u16) * BUDDY_UNITS);
+    if (remap == NULL)
+        return -1;
+
+    size_t unit_bytes = 1 << oam->gfxOffsetStep;
+    size_t move_bytes = 0;
+
+    for (int i = 0; i < BUDDY_UNITS; i++)
+        remap[i] = BUDDY_NONE;
+
+    for (int i = 0; i < BUDDY_UNITS; i += 1 << (bs->info[i] & BUDDY_ORDER_MASK))
+    {
+        if (!(bs->info[i] & BUDDY_USED))
+            continue;
+
+        int order = bs->info[i] & BUDDY_ORDER_MASK;
+        int to = dest[order];
+        dest[order] += 1 << order;
+
+        if (to == i)
+            continue;
+
+        for (int u = 0; u < (1 << order); u++)
+            remap[i + u] = to + u;
+
+        move_bytes += unit_bytes << order;
+    }
+
+    if (move_bytes == 0)
+    {
+        free(remap);
+        return 0;
+    }
+
+    // Blocks can be moved to locations that are still used by other blocks, so
+    // all of them are copied to main RAM before writing them back. The buffer
+    // is aligned to cache lines so that invalidating it doesn't affect other
+    // variables.
+    u8 *buffer = memalign(32, (move_bytes + 31) & ~31);
+    if (buffer == NULL)
+    {
+        free(remap);
+        return -1;
+    }
+
+    DC_InvalidateRange(buffer, (move_bytes + 31) & ~31);
+
+    u8 *ptr = buffer;
+    for (int i = 0; i < BUDDY_UNITS; i += 1 << (bs->info[i] & BUDDY_ORDER_MASK))
+    {
+        if (remap[i] == BUDDY_NONE)
+            continue;
+
+        size_t bytes = unit_bytes << (bs->info[i] & BUDDY_ORDER_MASK);
+        dmaCopyWords(3, oamGetGfxPtr(oam, i), ptr, bytes);
+        ptr += bytes;
+    }
+
+    int moved = 0;
+
+    ptr = buffer;
+    for (int i = 0; i < BUDDY_UNITS; i += 1 << (bs->info[i] & BUDDY_ORDER_MASK))
+    {
+        if (remap[i] == BUDDY_NONE)
+            continue;
+
+        size_t bytes = unit_bytes << (bs->info[i] & BUDDY_ORDER_MASK);
+        u16 *gfx = oamGetGfxPtr(oam, remap[i]);
+        dmaCopyWords(3, ptr, gfx, bytes);
+        ptr += bytes;
+
+        if (callback != NULL)
+            callback(oamGetGfxPtr(oam, i), gfx, userdata);
+
+        moved++;
+    }
+
+    free(buffer);
+
+    // Update the tile index of all sprites, including the hidden ones, as they
+    // may be displayed again later.
+    for (int i = 0; i < SPRITE_COUNT; i++)
+    {
+        int index = oam->oamMemory[i].gfxIndex;
+
+        // The tile index only uses 10 bits, so it's always a valid unit
+        if (remap[index] == BUDDY_NONE)
+            continue;
+
+        oam->oamMemory[i].gfxIndex = remap[index];
+        oamMarkEntryDirty(oam, i);
+    }
+
+    // Rebuild the allocator state with the new layout
+    u8 orders[BUDDY_UNITS];
+    int used = 0;
+    for (int order = BUDDY_MAX_ORDER; order >= 0; order--)
+    {
+        for (int n = 0; n < count[order]; n++)
+            orders[used++] = order;
+    }
+
+    memset(bs->info, 0, sizeof(bs->info));
+    for (int i = 0; i <= BUDDY_MAX_ORDER; i++)
+        bs->head[i] = BUDDY_NONE;
+    bs->nonEmpty = 0;
+
+    int unit = 0;
+    for (int n = 0; n < used; n++)
+    {
+        bs->info[unit] = BUDDY_USED | orders[n];
+        unit += 1 << orders[n];
+    }
+
+    buddyFreeTail(bs, end);
+
+    free(remap);
+
+    return moved;
+}
+
 u16 *oamAllocateGfx(OamState *oam, SpriteSize size, SpriteColorFormat colorFormat)
 {
     int bytes = SPRITE_SIZE_PIXELS(size);
@@ -239,14 +577,22 @@ u16 *oamAllocateGfx(OamState *oam, SpriteSize size, SpriteColorFormat colorForma
 
     bytes = bytes >> oam->gfxOffsetStep;
 
-    int offset = simpleAlloc(oam, bytes ? bytes : 1);
+    int offset;
+
+    if (oam->buddyState != NULL)
+        offset = buddyAlloc(oam->buddyState, bytes ? bytes : 1);
+    else
+        offset = simpleAlloc(oam, bytes ? bytes : 1);
 
     return oamGetGfxPtr(oam, offset);
 }
 
 void oamFreeGfx(OamState *oam, const void *gfxOffset)
 {
-    simpleFree(oam, oamGfxPtrToOffset(oam, gfxOffset));
+    if (oam->buddyState != NULL)
+        buddyFree(oam->buddyState, oamGfxPtrToOffset(oam, gfxOffset));
+    else
+        simpleFree(oam, oamGfxPtrToOffset(oam, gfxOffset));
 }
 
 int oamCountFragments(OamState *oam)
@@ -255,6 +601,9 @@ int oamCountFragments(OamState *oam)
 
     int curOffset;
 
+    if (oam->buddyState != NULL)
+        return buddyCountFragments(oam->buddyState);
+
     if (oam->allocBuffer == NULL)
         return 0;
 
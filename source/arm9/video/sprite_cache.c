@@ -0,0 +1,502 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/cache.h>
+#include <nds/arm9/sprite.h>
+#include <nds/arm9/spriteCache.h>
+#include <nds/dma.h>
+
+typedef enum
+{
+    FRAME_EMPTY,    // Not registered
+    FRAME_EVICTED,  // Registered, not in VRAM
+    FRAME_PENDING,  // VRAM allocated, waiting to be copied
+    FRAME_READY,    // In VRAM
+} frame_state;
+
+#define FRAME_NONE  0xFFFF
+
+typedef struct
+{
+    const void *data;   // Source in main RAM, or NULL
+    FILE *file;         // Source in a file, or NULL
+    long offset;
+    u8 *staging;        // Contents read from the file until they're copied
+    u16 *gfx;           // Address in VRAM, or NULL
+    u32 bytes;
+    u16 size;           // SpriteSize
+    u8 format;          // SpriteColorFormat
+    u8 state;           // frame_state
+    u16 alias;          // Frame that holds the graphics, or FRAME_NONE
+    u16 aliases;        // Number of frames that use this one as alias
+    u16 refcount;
+    u16 lru_prev;       // Links in the list of unused frames in VRAM
+    u16 lru_next;
+    bool queued;        // It's in the upload queue
+} cache_frame;
+
+typedef struct
+{
+    cache_frame *frames;
+    u16 *queue;         // Ring buffer of frames to be copied
+    int num_frames;
+    int queue_head;
+    int queue_count;
+    u16 lru_first;      // Least recently used frame
+    u16 lru_last;
+    size_t budget;
+    OamCacheStats stats;
+} frame_cache;
+
+static frame_cache caches[2];
+
+static frame_cache *cache_get(OamState *oam)
+{
+    if (oam == &oamMain)
+        return &caches[0];
+    if (oam == &oamSub)
+        return &caches[1];
+    return NULL;
+}
+
+static cache_frame *cache_get_frame(frame_cache *fc, int frame)
+{
+    if ((fc == NULL) || (fc->frames == NULL))
+        return NULL;
+
+    if ((frame < 0) || (frame >= fc->num_frames))
+        return NULL;
+
+    cache_frame *f = &fc->frames[frame];
+
+    if (f->alias != FRAME_NONE)
+        f = &fc->frames[f->alias];
+
+    if (f->state == FRAME_EMPTY)
+        return NULL;
+
+    return f;
+}
+
+static void lru_remove(frame_cache *fc, int index)
+{
+    cache_frame *f = &fc->frames[index];
+
+    if (f->lru_prev != FRAME_NONE)
+        fc->frames[f->lru_prev].lru_next = f->lru_next;
+    else
+        fc->lru_first = f->lru_next;
+
+    if (f->lru_next != FRAME_NONE)
+        fc->frames[f->lru_next].lru_prev = f->lru_prev;
+    else
+        fc->lru_last = f->lru_prev;
+
+    f->lru_prev = FRAME_NONE;
+    f->lru_next = FRAME_NONE;
+}
+
+static void lru_append(frame_cache *fc, int index)
+{
+    cache_frame *f = &fc->frames[index];
+
+    f->lru_prev = fc->lru_last;
+    f->lru_next = FRAME_NONE;
+
+    if (fc->lru_last != FRAME_NONE)
+        fc->frames[fc->lru_last].lru_next = index;
+    else
+        fc->lru_first = index;
+
+    fc->lru_last = index;
+}
+
+// Frees the VRAM of a frame. It's left in the upload queue if it's there, but
+// the entry is skipped by oamCacheUpdate() because the state isn't pending.
+static void frame_evict(OamState *oam, frame_cache *fc, int index)
+{
+    cache_frame *f = &fc->frames[index];
+
+    oamFreeGfx(oam, f->gfx);
+    f->gfx = NULL;
+
+    if (f->state == FRAME_PENDING)
+        fc->stats.pending--;
+    fc->stats.resident--;
+
+    free(f->staging);
+    f->staging = NULL;
+
+    f->state = FRAME_EVICTED;
+}
+
+// Evicts the least recently used frame. Returns false if there are no frames
+// that can be evicted.
+static bool cache_evict_lru(OamState *oam, frame_cache *fc)
+{
+    int index = fc->lru_first;
+
+    if (index == FRAME_NONE)
+        return false;
+
+    lru_remove(fc, index);
+    frame_evict(oam, fc, index);
+    fc->stats.evictions++;
+
+    return true;
+}
+
+// Removes the source of a frame. It fails if the frame is being used.
+static int frame_unregister(OamState *oam, frame_cache *fc, int frame)
+{
+    cache_frame *f = &fc->frames[frame];
+
+    if (f->aliases > 0)
+        return -1;
+
+    if (f->alias != FRAME_NONE)
+    {
+        // References are counted in the frame that holds the graphics
+        if (fc->frames[f->alias].refcount > 0)
+            return -1;
+
+        fc->frames[f->alias].aliases--;
+        f->alias = FRAME_NONE;
+        f->state = FRAME_EMPTY;
+        return 0;
+    }
+
+    if (f->refcount > 0)
+        return -1;
+
+    if (f->gfx != NULL)
+    {
+        lru_remove(fc, frame);
+        frame_evict(oam, fc, frame);
+    }
+
+    f->state = FRAME_EMPTY;
+    return 0;
+}
+
+static u32 frame_bytes(SpriteSize size, SpriteColorFormat format)
+{
+    u32 bytes = SPRITE_SIZE_PIXELS(size);
+
+    if (format == SpriteColorFormat_16Color)
+        bytes >>= 1;
+    else if (format == SpriteColorFormat_Bmp)
+        bytes <<= 1;
+
+    return bytes;
+}
+
+void oamCacheDeinit(OamState *oam)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL))
+        return;
+
+    for (int i = 0; i < fc->num_frames; i++)
+    {
+        cache_frame *f = &fc->frames[i];
+
+        if (f->gfx != NULL)
+            oamFreeGfx(oam, f->gfx);
+
+        free(f->staging);
+    }
+
+    free(fc->frames);
+    free(fc->queue);
+
+    memset(fc, 0, sizeof(frame_cache));
+}
+
+int oamCacheInit(OamState *oam, int numFrames, size_t uploadBudget)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (numFrames <= 0) || (numFrames >= FRAME_NONE))
+        return -1;
+
+    cache_frame *frames = calloc(numFrames, sizeof(cache_frame));
+    u16 *queue = malloc(numFrames * sizeof(u16));
+
+    if ((frames == NULL) || (queue == NULL))
+    {
+        free(frames);
+        free(queue);
+        return -1;
+    }
+
+    oamCacheDeinit(oam);
+
+    for (int i = 0; i < numFrames; i++)
+    {
+        frames[i].state = FRAME_EMPTY;
+        frames[i].alias = FRAME_NONE;
+        frames[i].lru_prev = FRAME_NONE;
+        frames[i].lru_next = FRAME_NONE;
+    }
+
+    fc->frames = frames;
+    fc->queue = queue;
+    fc->num_frames = numFrames;
+    fc->lru_first = FRAME_NONE;
+    fc->lru_last = FRAME_NONE;
+    fc->budget = uploadBudget;
+
+    return 0;
+}
+
+int oamCacheSetFrameRAM(OamState *oam, int frame, const void *data,
+                        SpriteSize size, SpriteColorFormat format)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL) || (data == NULL))
+        return -1;
+
+    if ((frame < 0) || (frame >= fc->num_frames))
+        return -1;
+
+    if (frame_unregister(oam, fc, frame) != 0)
+        return -1;
+
+    cache_frame *f = &fc->frames[frame];
+
+    f->data = data;
+    f->file = NULL;
+    f->bytes = frame_bytes(size, format);
+    f->size = size;
+    f->format = format;
+
+    // Look for a frame with the same graphics. Only frames that aren't aliases
+    // are checked, so that aliases always point to the frame with the data.
+    for (int i = 0; i < fc->num_frames; i++)
+    {
+        cache_frame *other = &fc->frames[i];
+
+        if ((i == frame) || (other->state == FRAME_EMPTY)
+            || (other->alias != FRAME_NONE) || (other->data == NULL))
+            continue;
+
+        if (other->bytes != f->bytes)
+            continue;
+
+        if ((other->data != data) && (memcmp(other->data, data, f->bytes) != 0))
+            continue;
+
+        f->alias = i;
+        other->aliases++;
+        break;
+    }
+
+    f->state = FRAME_EVICTED;
+
+    return 0;
+}
+
+int oamCacheSetFrameFile(OamState *oam, int frame, FILE *file, long offset,
+                         SpriteSize size, SpriteColorFormat format)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL) || (file == NULL))
+        return -1;
+
+    if ((frame < 0) || (frame >= fc->num_frames))
+        return -1;
+
+    if (frame_unregister(oam, fc, frame) != 0)
+        return -1;
+
+    cache_frame *f = &fc->frames[frame];
+
+    f->data = NULL;
+    f->file = file;
+    f->offset = offset;
+    f->bytes = frame_bytes(size, format);
+    f->size = size;
+    f->format = format;
+    f->state = FRAME_EVICTED;
+
+    return 0;
+}
+
+u16 *oamCacheAcquire(OamState *oam, int frame)
+{
+    frame_cache *fc = cache_get(oam);
+    cache_frame *f = cache_get_frame(fc, frame);
+
+    if (f == NULL)
+        return NULL;
+
+    int index = f - fc->frames;
+
+    if (f->gfx != NULL)
+    {
+        if (f->refcount == 0)
+            lru_remove(fc, index);
+
+        f->refcount++;
+        fc->stats.hits++;
+        return f->gfx;
+    }
+
+    fc->stats.misses++;
+
+    u8 *staging = NULL;
+
+    if (f->file != NULL)
+    {
+        staging = malloc(f->bytes);
+        if (staging == NULL)
+        {
+            fc->stats.failures++;
+            return NULL;
+        }
+
+        if ((fseek(f->file, f->offset, SEEK_SET) != 0)
+            || (fread(staging, 1, f->bytes, f->file) != f->bytes))
+        {
+            free(staging);
+            fc->stats.failures++;
+            return NULL;
+        }
+    }
+
+    u16 *gfx;
+
+    while (1)
+    {
+        gfx = oamAllocateGfx(oam, f->size, f->format);
+        if (gfx != NULL)
+            break;
+
+        if (!cache_evict_lru(oam, fc))
+        {
+            free(staging);
+            fc->stats.failures++;
+            return NULL;
+        }
+    }
+
+    f->gfx = gfx;
+    f->staging = staging;
+    f->state = FRAME_PENDING;
+    f->refcount = 1;
+
+    fc->stats.resident++;
+    fc->stats.pending++;
+
+    if (!f->queued)
+    {
+        int tail = fc->queue_head + fc->queue_count;
+        if (tail >= fc->num_frames)
+            tail -= fc->num_frames;
+
+        fc->queue[tail] = index;
+        fc->queue_count++;
+        f->queued = true;
+    }
+
+    return gfx;
+}
+
+void oamCacheRelease(OamState *oam, int frame)
+{
+    frame_cache *fc = cache_get(oam);
+    cache_frame *f = cache_get_frame(fc, frame);
+
+    if ((f == NULL) || (f->refcount == 0))
+        return;
+
+    f->refcount--;
+
+    if ((f->refcount == 0) && (f->gfx != NULL))
+        lru_append(fc, f - fc->frames);
+}
+
+bool oamCacheIsReady(OamState *oam, int frame)
+{
+    frame_cache *fc = cache_get(oam);
+    cache_frame *f = cache_get_frame(fc, frame);
+
+    if (f == NULL)
+        return false;
+
+    return f->state == FRAME_READY;
+}
+
+void oamCacheUpdate(OamState *oam)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL))
+        return;
+
+    size_t uploaded = 0;
+
+    while (fc->queue_count > 0)
+    {
+        cache_frame *f = &fc->frames[fc->queue[fc->queue_head]];
+
+        // Always copy at least one frame so that big frames can't get stuck
+        if ((f->state == FRAME_PENDING) && (uploaded > 0)
+            && (uploaded + f->bytes > fc->budget))
+            break;
+
+        fc->queue_head++;
+        if (fc->queue_head == fc->num_frames)
+            fc->queue_head = 0;
+        fc->queue_count--;
+
+        f->queued = false;
+
+        // Frames evicted before being copied are skipped
+        if (f->state != FRAME_PENDING)
+            continue;
+
+        const void *src = (f->staging != NULL) ? f->staging : f->data;
+
+        DC_FlushRange(src, f->bytes);
+        dmaCopy(src, f->gfx, f->bytes);
+
+        free(f->staging);
+        f->staging = NULL;
+
+        f->state = FRAME_READY;
+        fc->stats.pending--;
+
+        uploaded += f->bytes;
+    }
+
+    fc->stats.bytesUploaded = uploaded;
+}
+
+void oamCacheFlush(OamState *oam)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL))
+        return;
+
+    while (cache_evict_lru(oam, fc));
+}
+
+const OamCacheStats *oamCacheGetStats(OamState *oam)
+{
+    frame_cache *fc = cache_get(oam);
+
+    if ((fc == NULL) || (fc->frames == NULL))
+        return NULL;
+
+    return &fc->stats;
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#ifndef ARM9_VIDEO_SPRITE_INTERNAL_H__
+#define ARM9_VIDEO_SPRITE_INTERNAL_H__
+
+#include <stdbool.h>
+
+#include <nds/arm9/sprite.h>
+
+// Fills a sprite entry like oamSet(), but the entry can be anywhere in memory
+// and it isn't marked as dirty. "oam" is only used to convert the graphics
+// pointer to a tile index.
+void oam_set_entry(OamState *oam, SpriteEntry *entry, int x, int y, int priority,
+                   int palette_alpha, SpriteSize size, SpriteColorFormat format,
+                   const void *gfxOffset, int affineIndex, bool sizeDouble,
+                   bool hide, bool hflip, bool vflip, bool mosaic);
+
+#endif // ARM9_VIDEO_SPRITE_INTERNAL_H__
@@ -0,0 +1,526 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/cache.h>
+#include <nds/arm9/sassert.h>
+#include <nds/arm9/sprite.h>
+#include <nds/arm9/spriteMux.h>
+#include <nds/arm9/video.h>
+#include <nds/dma.h>
+#include <nds/interrupts.h>
+#include <nds/system.h>
+
+#include "arm9/video/sprite_internal.h"
+
+#define SCREEN_LINES    192
+
+// Range of OAM entries rewritten during the HBlank period of a scanline
+typedef struct
+{
+    u16 line;   // Scanline in which the entries are rewritten
+    u16 first;  // First entry in the staging buffer
+    u8 slot;    // First OAM entry to rewrite
+    u8 count;   // Number of OAM entries to rewrite
+} mux_band;
+
+static OamState *mux_oam;
+static u16 *mux_oam_hw; // OAM of the engine
+static int mux_dma_channel;
+
+// The logical sprites are stored in the same format as OAM. This OamState is
+// only used to convert graphics pointers to tile indices, as there are more
+// logical sprites than entries in its dirty mask.
+static OamState mux_state;
+static int mux_max;
+static s16 *mux_y;          // Y coordinates that don't fit in OAM
+static u16 *mux_order;      // Visible sprites sorted by Y coordinate
+
+// The staging buffer and the bands are double buffered. The front buffers are
+// used by the VCOUNT interrupt handler while the current frame is drawn, and
+// the back buffers are filled by oamMuxPrepare() for the next frame.
+static SpriteEntry *mux_staging[2]; // Entries copied by HBlank DMA
+static mux_band *mux_bands[2];
+static int mux_num_bands[2];
+static int mux_front;
+static volatile bool mux_prepared;  // The back buffers hold a new frame
+static volatile int mux_active_bands; // Bands of the front buffer
+static volatile int mux_next_band;
+
+static OamMuxStats mux_stats;
+static u16 mux_line_sprites[SCREEN_LINES];
+static u16 mux_line_cycles[SCREEN_LINES];
+
+// Width and height of the sprites of each shape and size
+static const u8 mux_sprite_width[3][4] =
+{
+    { 8, 16, 32, 64 },  // Square
+    { 16, 32, 32, 64 }, // Wide
+    { 8, 8, 16, 32 },   // Tall
+};
+
+static const u8 mux_sprite_height[3][4] =
+{
+    { 8, 16, 32, 64 },  // Square
+    { 8, 8, 16, 32 },   // Wide
+    { 16, 32, 32, 64 }, // Tall
+};
+
+static void oam_mux_vcount_handler(void)
+{
+    int i = mux_next_band;
+    if (i >= mux_active_bands)
+        return;
+
+    const mux_band *bands = mux_bands[mux_front];
+    const mux_band *band = &bands[i];
+
+    // The copy happens at the end of the current scanline. Each OAM entry is
+    // 8 bytes long (2 words).
+    dmaSetParams(mux_dma_channel, &mux_staging[mux_front][band->first],
+                 &mux_oam_hw[band->slot * 4],
+                 DMA_ENABLE | DMA_32_BIT | DMA_START_HBL | (band->count * 2));
+
+    i++;
+    mux_next_band = i;
+
+    if (i < mux_active_bands)
+        SetYtrigger(bands[i].line);
+}
+
+int oamMuxInit(OamState *oam, int max_sprites, int dma_channel)
+{
+    if ((oam != &oamMain) && (oam != &oamSub))
+        return 0;
+    if ((max_sprites <= 0) || (max_sprites > 1024))
+        return 0;
+    if ((dma_channel < 0) || (dma_channel > 3))
+        return 0;
+
+    oamMuxDeinit();
+
+    SpriteEntry *sprites = calloc(max_sprites, sizeof(SpriteEntry));
+    mux_y = calloc(max_sprites, sizeof(s16));
+    mux_order = malloc(max_sprites * sizeof(u16));
+    mux_staging[0] = malloc(2 * max_sprites * sizeof(SpriteEntry));
+    mux_bands[0] = malloc(2 * max_sprites * sizeof(mux_band));
+
+    if ((sprites == NULL) || (mux_y == NULL) || (mux_order == NULL)
+        || (mux_staging[0] == NULL) || (mux_bands[0] == NULL))
+    {
+        free(sprites);
+        mux_state.oamMemory = NULL;
+        oamMuxDeinit();
+        return 0;
+    }
+
+    mux_state = *oam;
+    mux_state.oamMemory = sprites;
+
+    mux_oam = oam;
+    mux_oam_hw = (oam == &oamMain) ? OAM : OAM_SUB;
+    mux_dma_channel = dma_channel;
+    mux_max = max_sprites;
+
+    mux_staging[1] = mux_staging[0] + max_sprites;
+    mux_bands[1] = mux_bands[0] + max_sprites;
+
+    oamMuxClear();
+
+    mux_num_bands[0] = 0;
+    mux_num_bands[1] = 0;
+    mux_front = 0;
+    mux_prepared = false;
+    mux_active_bands = 0;
+    mux_next_band = 0;
+
+    irqSet(IRQ_VCOUNT, oam_mux_vcount_handler);
+    irqEnable(IRQ_VCOUNT);
+
+    return 1;
+}
+
+void oamMuxDeinit(void)
+{
+    if (mux_oam != NULL)
+    {
+        irqDisable(IRQ_VCOUNT);
+        irqClear(IRQ_VCOUNT);
+        dmaStopSafe(mux_dma_channel);
+    }
+
+    free(mux_state.oamMemory);
+    free(mux_y);
+    free(mux_order);
+    free(mux_staging[0]);
+    free(mux_bands[0]);
+
+    mux_state.oamMemory = NULL;
+    mux_y = NULL;
+    mux_order = NULL;
+    mux_staging[0] = mux_staging[1] = NULL;
+    mux_bands[0] = mux_bands[1] = NULL;
+
+    mux_oam = NULL;
+    mux_max = 0;
+    mux_num_bands[0] = mux_num_bands[1] = 0;
+    mux_prepared = false;
+    mux_active_bands = 0;
+}
+
+void oamMuxSet(int id, int x, int y, int priority, int palette_alpha,
+               SpriteSize size, SpriteColorFormat format, const void *gfxOffset,
+               int affineIndex, bool sizeDouble, bool hide, bool hflip,
+               bool vflip, bool mosaic)
+{
+    sassert(id >= 0 && id < mux_max, "oamMuxSet() index is out of bounds");
+
+    oam_set_entry(&mux_state, &mux_state.oamMemory[id], x, y, priority,
+                  palette_alpha, size, format, gfxOffset, affineIndex,
+                  sizeDouble, hide, hflip, vflip, mosaic);
+
+    mux_y[id] = y;
+}
+
+void oamMuxSetXY(int id, int x, int y)
+{
+    sassert(id >= 0 && id < mux_max, "oamMuxSetXY() index is out of bounds");
+
+    // oamSetXY() only accepts oamMain and oamSub
+    mux_state.oamMemory[id].x = x;
+    mux_state.oamMemory[id].y = y;
+
+    mux_y[id] = y;
+}
+
+void oamMuxSetHidden(int id, bool hide)
+{
+    sassert(id >= 0 && id < mux_max, "oamMuxSetHidden() index is out of bounds");
+
+    sassert(!mux_state.oamMemory[id].isRotateScale,
+            "oamMuxSetHidden() cannot set hide on a RotateScale sprite");
+
+    mux_state.oamMemory[id].isHidden = hide ? true : false;
+}
+
+void oamMuxClear(void)
+{
+    for (int i = 0; i < mux_max; i++)
+        mux_state.oamMemory[i].attribute[0] = ATTR0_DISABLED;
+}
+
+// Returns true if the sprite is visible, and its first and last scanlines.
+static bool oam_mux_sprite_lines(int id, int *top, int *bottom, int *cycles)
+{
+    const SpriteEntry *e = &mux_state.oamMemory[id];
+
+    if ((e->attribute[0] & (3 << 8)) == ATTR0_DISABLED)
+        return false;
+
+    if (e->shape > OBJSHAPE_TALL)
+        return false;
+
+    int width = mux_sprite_width[e->shape][e->size];
+    int height = mux_sprite_height[e->shape][e->size];
+
+    int cost = width;
+    if (e->isRotateScale)
+    {
+        if (e->isSizeDouble)
+        {
+            width *= 2;
+            height *= 2;
+        }
+        cost = 10 + width * 2;
+    }
+
+    *top = mux_y[id];
+    *bottom = *top + height - 1;
+    *cycles = cost;
+
+    return (*bottom >= 0) && (*top < SCREEN_LINES);
+}
+
+// Calculates the sprites and cycles used by each scanline, and sorts the
+// visible sprites by their first scanline with a counting sort.
+static int oam_mux_sort(void)
+{
+    s16 line_sprites[SCREEN_LINES + 1];
+    s32 line_cycles[SCREEN_LINES + 1];
+    u16 offsets[SCREEN_LINES + 1];
+
+    memset(line_sprites, 0, sizeof(line_sprites));
+    memset(line_cycles, 0, sizeof(line_cycles));
+    memset(offsets, 0, sizeof(offsets));
+
+    int visible = 0;
+
+    for (int i = 0; i < mux_max; i++)
+    {
+        int top, bottom, cycles;
+        if (!oam_mux_sprite_lines(i, &top, &bottom, &cycles))
+            continue;
+
+        if (top < 0)
+            top = 0;
+        if (bottom > SCREEN_LINES - 1)
+            bottom = SCREEN_LINES - 1;
+
+        line_sprites[top]++;
+        line_sprites[bottom + 1]--;
+        line_cycles[top] += cycles;
+        line_cycles[bottom + 1] -= cycles;
+
+        offsets[top]++;
+        visible++;
+    }
+
+    u16 sum = 0;
+    for (int l = 0; l < SCREEN_LINES; l++)
+    {
+        u16 n = offsets[l];
+        offsets[l] = sum;
+        sum += n;
+    }
+
+    for (int i = 0; i < mux_max; i++)
+    {
+        int top, bottom, cycles;
+        if (!oam_mux_sprite_lines(i, &top, &bottom, &cycles))
+            continue;
+
+        if (top < 0)
+            top = 0;
+
+        mux_order[offsets[top]++] = i;
+    }
+
+    // Scanline statistics
+    int sprites = 0, cycles = 0;
+    int budget = (REG_DISPCNT & DISPLAY_SPR_HBLANK) ?
+                 OAM_MUX_LINE_CYCLES_HBLANK : OAM_MUX_LINE_CYCLES;
+    if (mux_oam == &oamSub)
+    {
+        budget = (REG_DISPCNT_SUB & DISPLAY_SPR_HBLANK) ?
+                 OAM_MUX_LINE_CYCLES_HBLANK : OAM_MUX_LINE_CYCLES;
+    }
+
+    mux_stats.max_line_sprites = 0;
+    mux_stats.max_line_cycles = 0;
+    mux_stats.busiest_line = 0;
+    mux_stats.overflow_lines = 0;
+
+    for (int l = 0; l < SCREEN_LINES; l++)
+    {
+        sprites += line_sprites[l];
+        cycles += line_cycles[l];
+
+        mux_line_sprites[l] = sprites;
+        mux_line_cycles[l] = cycles;
+
+        if (sprites > mux_stats.max_line_sprites)
+            mux_stats.max_line_sprites = sprites;
+        if (cycles > mux_stats.max_line_cycles)
+        {
+            mux_stats.max_line_cycles = cycles;
+            mux_stats.busiest_line = l;
+        }
+        if (cycles > budget)
+            mux_stats.overflow_lines++;
+    }
+
+    return visible;
+}
+
+void oamMuxPrepare(void)
+{
+    if (mux_oam == NULL)
+        return;
+
+    // Don't let oamMuxCommit() use the back buffers while they are rebuilt
+    mux_prepared = false;
+
+    int back = mux_front ^ 1;
+    SpriteEntry *staging = mux_staging[back];
+    mux_band *bands = mux_bands[back];
+
+    int visible = oam_mux_sort();
+
+    SpriteEntry *shadow = mux_oam->oamMemory;
+
+    // Last scanline of the sprite that was assigned to each OAM entry, or -1
+    // if the entry hasn't been assigned yet.
+    s16 slot_bottom[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++)
+        slot_bottom[i] = -1;
+
+    int next_slot = 0;
+    int num_bands = 0;
+    int staged = 0;
+    int dropped = 0;
+
+    // Range of scanlines in which the current band can be written
+    int band_lo = 0, band_hi = 0;
+    int prev_line = -1;
+
+    for (int i = 0; i < visible; i++)
+    {
+        int id = mux_order[i];
+        int top, bottom, cycles;
+        oam_mux_sprite_lines(id, &top, &bottom, &cycles);
+
+        int slot = next_slot;
+        const SpriteEntry *src = &mux_state.oamMemory[id];
+
+        if (slot_bottom[slot] < 0)
+        {
+            // This entry hasn't been used in this frame, it is written to OAM
+            // during VBlank.
+            shadow[slot].attribute[0] = src->attribute[0];
+            shadow[slot].attribute[1] = src->attribute[1];
+            shadow[slot].attribute[2] = src->attribute[2];
+        }
+        else
+        {
+            // The entry can be rewritten after the last scanline of the
+            // previous sprite has been drawn, and at least two scanlines
+            // before the first scanline of the new sprite (sprites are
+            // rendered one scanline in advance).
+            int lo = slot_bottom[slot];
+            int hi = top - 2;
+
+            mux_band *band = (num_bands > 0) ? &bands[num_bands - 1] : NULL;
+
+            bool join = (band != NULL) && (slot != 0)
+                        && (slot == band->slot + band->count)
+                        && (lo <= band_hi) && (hi >= band_lo);
+
+            if (join)
+            {
+                if (lo > band_lo)
+                    band_lo = lo;
+                if (hi < band_hi)
+                    band_hi = hi;
+            }
+            else
+            {
+                // Close the current band and start a new one
+                if (band != NULL)
+                {
+                    band->line = band_lo;
+                    prev_line = band_lo;
+                }
+
+                if (lo <= prev_line)
+                    lo = prev_line + 1;
+
+                if (lo > hi)
+                {
+                    // There is no time to reuse the OAM entry
+                    dropped++;
+                    continue;
+                }
+
+                band = &bands[num_bands++];
+                band->first = staged;
+                band->slot = slot;
+                band->count = 0;
+                band_lo = lo;
+                band_hi = hi;
+            }
+
+            SpriteEntry *dst = &staging[staged++];
+            dst->attribute[0] = src->attribute[0];
+            dst->attribute[1] = src->attribute[1];
+            dst->attribute[2] = src->attribute[2];
+            // Preserve the affine matrix stored in this OAM entry
+            dst->attribute3 = shadow[slot].attribute3;
+
+            band->count++;
+        }
+
+        slot_bottom[slot] = bottom;
+        next_slot = (slot + 1) & (SPRITE_COUNT - 1);
+    }
+
+    if (num_bands > 0)
+        bands[num_bands - 1].line = band_lo;
+
+    // Hide entries that haven't been used
+    for (int i = 0; i < SPRITE_COUNT; i++)
+    {
+        if (slot_bottom[i] < 0)
+            shadow[i].attribute[0] = ATTR0_DISABLED;
+    }
+
+    mux_stats.visible = visible;
+    mux_stats.dropped = dropped;
+    mux_stats.bands = num_bands;
+
+    DC_FlushRange(staging, staged * sizeof(SpriteEntry));
+
+    mux_num_bands[back] = num_bands;
+    mux_prepared = true;
+}
+
+void oamMuxCommit(void)
+{
+    if (mux_oam == NULL)
+        return;
+
+    // The first band can't start until the previous frame is done with the DMA
+    // channel, so stop it in case the last transfer hasn't happened.
+    mux_active_bands = 0;
+    dmaStopSafe(mux_dma_channel);
+
+    // If no new frame has been prepared, the bands of the previous frame are
+    // used again, as the shadow OAM hasn't changed either.
+    if (mux_prepared)
+    {
+        mux_front ^= 1;
+        mux_prepared = false;
+    }
+
+    // All entries are rewritten during the frame, so all of them need to be
+    // restored in case oamUpdate() only copies modified entries.
+    oamMarkDirty(mux_oam, 0, 0);
+    oamUpdate(mux_oam);
+
+    int num_bands = mux_num_bands[mux_front];
+
+    mux_next_band = 0;
+    mux_active_bands = num_bands;
+
+    if (num_bands > 0)
+        SetYtrigger(mux_bands[mux_front][0].line);
+}
+
+void oamMuxUpdate(void)
+{
+    oamMuxPrepare();
+    oamMuxCommit();
+}
+
+const OamMuxStats *oamMuxGetStats(void)
+{
+    return &mux_stats;
+}
+
+int oamMuxGetLineCycles(int line)
+{
+    if ((line < 0) || (line >= SCREEN_LINES))
+        return -1;
+
+    return mux_line_cycles[line];
+}
+
+int oamMuxGetLineSprites(int line)
+{
+    if ((line < 0) || (line >= SCREEN_LINES))
+        return -1;
+
+    return mux_line_sprites[line];
+}
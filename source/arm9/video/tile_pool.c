@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/tilePool.h>
+
+// Largest tile (8 bpp) in 32-bit words
+#define TILE_MAX_WORDS  16
+
+// The orientations are in the same order as the flip bits of map entries
+#define FLIP_NONE       0
+#define FLIP_H          1
+#define FLIP_V          2
+#define FLIP_HV         3
+
+static inline int tile_words(const TilePool *pool)
+{
+    return pool->bpp * 2;
+}
+
+static u32 tile_hash(const u32 *data, int words)
+{
+    // FNV-1a over 32-bit words
+    u32 hash = 2166136261u;
+
+    for (int i = 0; i < words; i++)
+        hash = (hash ^ data[i]) * 16777619u;
+
+    return hash;
+}
+
+static inline u32 tile_bucket(const TilePool *pool, u32 hash)
+{
+    return (hash ^ (hash >> 16)) & pool->bucketMask;
+}
+
+// Mirrors a tile horizontally
+static void tile_flip_h(u32 *dst, const u32 *src, int bpp)
+{
+    if (bpp == 4)
+    {
+        // Each row is one word with 8 pixels of 4 bits
+        for (int i = 0; i < 8; i++)
+        {
+            u32 v = __builtin_bswap32(src[i]);
+            dst[i] = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+        }
+    }
+    else
+    {
+        // Each row is two words with 4 pixels of 8 bits each
+        for (int i = 0; i < 16; i += 2)
+        {
+            u32 left = src[i];
+            dst[i] = __builtin_bswap32(src[i + 1]);
+            dst[i + 1] = __builtin_bswap32(left);
+        }
+    }
+}
+
+// Mirrors a tile vertically
+static void tile_flip_v(u32 *dst, const u32 *src, int bpp)
+{
+    int row_words = bpp / 4;
+
+    for (int row = 0; row < 8; row++)
+    {
+        for (int i = 0; i < row_words; i++)
+            dst[row * row_words + i] = src[(7 - row) * row_words + i];
+    }
+}
+
+// Returns the index of a stored tile equal to the provided one, or -1
+static int tile_find(const TilePool *pool, const u32 *data, u32 hash)
+{
+    int words = tile_words(pool);
+    u32 entry = pool->buckets[tile_bucket(pool, hash)];
+
+    while (entry != 0)
+    {
+        int index = entry - 1;
+
+        if (pool->hashes[index] == hash)
+        {
+            const u32 *stored = pool->gfx + index * words;
+
+            int i = 0;
+            while ((i < words) && (stored[i] == data[i]))
+                i++;
+
+            if (i == words)
+                return index;
+        }
+
+        entry = pool->next[index];
+    }
+
+    return -1;
+}
+
+int tilePoolInit(TilePool *pool, void *gfx, int maxTiles, int bpp)
+{
+    if ((pool == NULL) || (gfx == NULL) || ((uintptr_t)gfx & 3))
+        return -1;
+
+    if ((maxTiles <= 0) || (maxTiles > TILE_POOL_MAX_TILES))
+        return -1;
+
+    if ((bpp != 4) && (bpp != 8))
+        return -1;
+
+    // Use at least as many buckets as tiles, rounded up to a power of two
+    u32 num_buckets = 1;
+    while (num_buckets < (u32)maxTiles)
+        num_buckets <<= 1;
+
+    size_t size = maxTiles * (sizeof(u32) + sizeof(u16))
+                + num_buckets * sizeof(u16);
+
+    u8 *mem = malloc(size);
+    if (mem == NULL)
+        return -1;
+
+    pool->gfx = gfx;
+    pool->bpp = bpp;
+    pool->maxTiles = maxTiles;
+    pool->hashes = (u32 *)mem;
+    pool->next = (u16 *)(mem + maxTiles * sizeof(u32));
+    pool->buckets = pool->next + maxTiles;
+    pool->bucketMask = num_buckets - 1;
+
+    tilePoolReset(pool);
+
+    return 0;
+}
+
+void tilePoolDeinit(TilePool *pool)
+{
+    if (pool == NULL)
+        return;
+
+    // All arrays are part of the same allocation
+    free(pool->hashes);
+
+    pool->hashes = NULL;
+    pool->next = NULL;
+    pool->buckets = NULL;
+    pool->numTiles = 0;
+    pool->maxTiles = 0;
+}
+
+void tilePoolReset(TilePool *pool)
+{
+    if ((pool == NULL) || (pool->buckets == NULL))
+        return;
+
+    memset(pool->buckets, 0, (pool->bucketMask + 1) * sizeof(u16));
+    pool->numTiles = 0;
+}
+
+int tilePoolAddTile(TilePool *pool, const void *tile)
+{
+    if ((pool == NULL) || (pool->hashes == NULL) || (tile == NULL))
+        return -1;
+
+    int words = tile_words(pool);
+
+    // Generate all orientations of the tile. If a flipped version of the tile
+    // is stored, displaying the stored tile with the same flip results in the
+    // original tile.
+    u32 orient[4][TILE_MAX_WORDS];
+
+    memcpy(orient[FLIP_NONE], tile, words * sizeof(u32));
+    tile_flip_h(orient[FLIP_H], orient[FLIP_NONE], pool->bpp);
+    tile_flip_v(orient[FLIP_V], orient[FLIP_NONE], pool->bpp);
+    tile_flip_v(orient[FLIP_HV], orient[FLIP_H], pool->bpp);
+
+    u32 hash[4];
+
+    for (int flip = 0; flip < 4; flip++)
+    {
+        hash[flip] = tile_hash(orient[flip], words);
+
+        int index = tile_find(pool, orient[flip], hash[flip]);
+        if (index >= 0)
+            return index | (flip << 10);
+    }
+
+    if (pool->numTiles >= pool->maxTiles)
+        return -1;
+
+    int index = pool->numTiles++;
+
+    u32 *dst = pool->gfx + index * words;
+    for (int i = 0; i < words; i++)
+        dst[i] = orient[FLIP_NONE][i];
+
+    u32 bucket = tile_bucket(pool, hash[FLIP_NONE]);
+
+    pool->hashes[index] = hash[FLIP_NONE];
+    pool->next[index] = pool->buckets[bucket];
+    pool->buckets[bucket] = index + 1;
+
+    return index;
+}
+
+int tilePoolAddMap(TilePool *pool, const void *tiles, int numTiles,
+                   const u16 *srcMap, u16 *dstMap, size_t numEntries)
+{
+    if ((pool == NULL) || (pool->hashes == NULL) || (tiles == NULL))
+        return -1;
+
+    if ((srcMap == NULL) || (dstMap == NULL))
+        return -1;
+
+    if ((numTiles <= 0) || (numTiles > TILE_POOL_MAX_TILES))
+        return -1;
+
+    // Map entry of each tile of the tileset in the pool, or 0xFFFF if the tile
+    // hasn't been added yet.
+    u16 *remap = malloc(numTiles * sizeof(u16));
+    if (remap == NULL)
+        return -1;
+
+    memset(remap, 0xFF, numTiles * sizeof(u16));
+
+    const u32 *src_gfx = tiles;
+    int words = tile_words(pool);
+
+    // First, add all the tiles used by the map. The map isn't modified until
+    // all tiles have been added successfully.
+    for (size_t i = 0; i < numEntries; i++)
+    {
+        int index = srcMap[i] & 0x3FF;
+
+        if (index >= numTiles)
+        {
+            free(remap);
+            return -1;
+        }
+
+        if (remap[index] != 0xFFFF)
+            continue;
+
+        int entry = tilePoolAddTile(pool, src_gfx + index * words);
+        if (entry < 0)
+        {
+            free(remap);
+            return -1;
+        }
+
+        remap[index] = entry;
+    }
+
+    // Now, rewrite the map. The flip bits of the original entry are combined
+    // with the flip bits required to display the stored tile.
+    for (size_t i = 0; i < numEntries; i++)
+    {
+        u16 entry = srcMap[i];
+        u16 pooled = remap[entry & 0x3FF];
+
+        dstMap[i] = (entry & ~0x3FF) ^ pooled;
+    }
+
+    free(remap);
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: Zlib
+//
+// Copyright (C) 2026 Antonio Niño Díaz
+
+#include <nds/arm9/background.h>
+#include <nds/arm9/sprite.h>
+#include <nds/arm9/video.h>
+#include <nds/arm9/videoCapture.h>
+#include <nds/arm9/videoGL.h>
+#include <nds/dma.h>
+#include <nds/system.h>
+
+#include "arm9/libnds_internal.h"
+
+typedef enum
+{
+    CAPTURE_IDLE,
+    CAPTURE_PENDING,    // Requested, it will start in the next VBlank
+    CAPTURE_RUNNING,    // The capture circuit is writing to VRAM
+} capture_state;
+
+static bool dual_active;
+static bool dual_top; // Screen of the scene that is being drawn
+
+static capture_state tex_state;
+static int tex_bank;        // Destination bank (0 = A, ..., 3 = D)
+static u32 tex_capcnt;      // Value to write to REG_DISPCAPCNT
+static u8 tex_bank_cr;      // Original setting of the destination bank
+
+// Value of the control register of a VRAM bank in LCD mode
+#define VRAM_CR_LCD     (VRAM_ENABLE | 0)
+
+// Sets the control registers of VRAM banks C and D with one write, without
+// modifying the settings of banks A and B.
+static void capture_set_banks_cd(u8 c_cr, u8 d_cr)
+{
+    vramRestorePrimaryBanks((VRAM_CR & 0xFFFF) | ((u32)c_cr << 16)
+                            | ((u32)d_cr << 24));
+}
+
+static void dual3d_setup_sub_engine(void)
+{
+    // Bank C is displayed as a 256x256 16-bit bitmap background
+    videoSetModeSub(MODE_5_2D | DISPLAY_BG2_ACTIVE | DISPLAY_SPR_ACTIVE
+                    | DISPLAY_SPR_2D_BMP_256);
+
+    // This goes through the shadow registers if they are enabled, so that the
+    // background isn't overwritten by bgShadowCommit().
+    bgInitSub(2, BgType_Bmp16, BgSize_B16_256x256, 0, 0);
+
+    // Bank D is displayed as a grid of 4x3 bitmap sprites of 64x64 pixels. In
+    // 2D bitmap mode with a width of 256 pixels, the tile index of a sprite is
+    // (x / 8) + (y / 8) * 32.
+    SpriteEntry *oam = (SpriteEntry *)OAM_SUB;
+
+    for (int i = 0; i < SPRITE_COUNT; i++)
+    {
+        oam[i].attribute[0] = ATTR0_DISABLED;
+        oam[i].attribute[1] = 0;
+        oam[i].attribute[2] = 0;
+    }
+
+    int i = 0;
+    for (int y = 0; y < 192; y += 64)
+    {
+        for (int x = 0; x < 256; x += 64)
+        {
+            oam[i].attribute[0] = ATTR0_BMP | ATTR0_SQUARE | OBJ_Y(y);
+            oam[i].attribute[1] = ATTR1_SIZE_64 | OBJ_X(x);
+            oam[i].attribute[2] = ATTR2_ALPHA(15) | ATTR2_PRIORITY(0)
+                                  | ((x / 8) + (y / 8) * 32);
+            i++;
+        }
+    }
+}
+
+int videoDual3DInit(void)
+{
+    if (dual_active || (tex_state != CAPTURE_IDLE))
+        return 0;
+
+    // Banks C and D can't be taken if videoGL has textures in them
+    if (libnds_gl_texture_vram_in_use(VRAM_C, VRAM_E))
+        return 0;
+
+    if (glLockVRAMBank(VRAM_C) == 0)
+        return 0;
+
+    if (glLockVRAMBank(VRAM_D) == 0)
+    {
+        glUnlockVRAMBank(VRAM_C);
+        return 0;
+    }
+
+    // Clear both banks so that the first frames don't show garbage
+    capture_set_banks_cd(VRAM_CR_LCD, VRAM_CR_LCD);
+    dmaFillWords(0, VRAM_C, 128 * 1024);
+    dmaFillWords(0, VRAM_D, 128 * 1024);
+
+    dual3d_setup_sub_engine();
+
+    dual_top = true;
+    dual_active = true;
+
+    return 1;
+}
+
+int videoDual3DDeinit(void)
+{
+    if (!dual_active)
+        return 0;
+
+    dual_active = false;
+
+    // Wait until the last capture ends before changing the banks
+    while (REG_DISPCAPCNT & DCAP_ENABLE);
+
+    capture_set_banks_cd(VRAM_CR_LCD, VRAM_CR_LCD);
+
+    lcdMainOnTop();
+
+    int ret = glUnlockVRAMBank(VRAM_C);
+    ret &= glUnlockVRAMBank(VRAM_D);
+
+    return ret;
+}
+
+bool videoDual3DIsTopScreen(void)
+{
+    return dual_top;
+}
+
+int videoCaptureTextureInit(int name, int width, int height)
+{
+    // Only the sizes supported by the capture circuit are allowed
+    if (width == 128)
+    {
+        if (height != 128)
+            return 0;
+    }
+    else if (width == 256)
+    {
+        if ((height != 64) && (height != 128) && (height != 256))
+            return 0;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (libnds_gl_texture_alloc_aligned(name, width, height) == NULL)
+        return 0;
+
+    return 1;
+}
+
+int videoCaptureTexture(int name)
+{
+    if (dual_active || (tex_state != CAPTURE_IDLE))
+        return 0;
+
+    u8 *addr = glGetTexturePointer(name);
+    if (addr == NULL)
+        return 0;
+
+    // Textures prepared by videoCaptureTextureInit() are GL_RGBA textures that
+    // don't cross the boundary between two VRAM banks.
+    u32 format = libnds_gl_texture_format(name);
+    if (((format >> 26) & 7) != GL_RGBA)
+        return 0;
+
+    int width = 8 << ((format >> 20) & 7);
+    int height = 8 << ((format >> 23) & 7);
+
+    u32 size;
+    if (width == 128)
+        size = DCAP_SIZE_128x128;
+    else if (height == 64)
+        size = DCAP_SIZE_256x64;
+    else if (height == 128)
+        size = DCAP_SIZE_256x128;
+    else
+        size = DCAP_SIZE_256x192;
+
+    u32 offset = (u32)addr - (u32)VRAM_A;
+    if (offset & 0x7FFF)
+        return 0;
+
+    tex_bank = offset >> 17;
+    if (tex_bank > DCAP_BANK_VRAM_D)
+        return 0;
+
+    tex_capcnt = DCAP_ENABLE | DCAP_MODE(DCAP_MODE_A)
+               | DCAP_SRC_A(DCAP_SRC_A_3DONLY) | DCAP_SIZE(size)
+               | DCAP_OFFSET((offset >> 15) & 3) | DCAP_BANK(tex_bank);
+
+    tex_state = CAPTURE_PENDING;
+
+    return 1;
+}
+
+bool videoCaptureIsBusy(void)
+{
+    return tex_state != CAPTURE_IDLE;
+}
+
+void videoCaptureVBlank(void)
+{
+    if (dual_active)
+    {
+        // The scene that has just been flushed is displayed by the main engine
+        // during this frame, and captured so that the sub engine can display
+        // it on the other screen during the next frame.
+        if (dual_top)
+        {
+            lcdMainOnTop();
+            capture_set_banks_cd(VRAM_CR_LCD, VRAM_ENABLE | VRAM_D_SUB_SPRITE);
+            REG_DISPCAPCNT = DCAP_ENABLE | DCAP_MODE(DCAP_MODE_A)
+                           | DCAP_SRC_A(DCAP_SRC_A_COMPOSITED)
+                           | DCAP_SIZE(DCAP_SIZE_256x192)
+                           | DCAP_BANK(DCAP_BANK_VRAM_C);
+        }
+        else
+        {
+            lcdMainOnBottom();
+            capture_set_banks_cd(VRAM_ENABLE | VRAM_C_SUB_BG, VRAM_CR_LCD);
+            REG_DISPCAPCNT = DCAP_ENABLE | DCAP_MODE(DCAP_MODE_A)
+                           | DCAP_SRC_A(DCAP_SRC_A_COMPOSITED)
+                           | DCAP_SIZE(DCAP_SIZE_256x192)
+                           | DCAP_BANK(DCAP_BANK_VRAM_D);
+        }
+
+        dual_top = !dual_top;
+        return;
+    }
+
+    vu8 *bank_cr = &VRAM_A_CR + tex_bank;
+
+    if (tex_state == CAPTURE_PENDING)
+    {
+        // The capture circuit can only write to banks mapped as LCD
+        tex_bank_cr = *bank_cr;
+        *bank_cr = VRAM_CR_LCD;
+        REG_DISPCAPCNT = tex_capcnt;
+        tex_state = CAPTURE_RUNNING;
+    }
+    else if (tex_state == CAPTURE_RUNNING)
+    {
+        if (REG_DISPCAPCNT & DCAP_ENABLE)
+            return;
+
+        *bank_cr = tex_bank_cr;
+        tex_state = CAPTURE_IDLE;
+    }
+}
@@ -17,6 +17,9 @@
 #include <nds/memory.h>
 #include <nds/ndstypes.h>
 #include <nds/system.h>
+#include <nds/system_counter.h>
+
+#include "arm9/libnds_internal.h"
 
 // Structures specific to allocating and deallocating texture and palette VRAM
 // ---------------------------------------------------------------------------
@@ -1748,6 +1751,94 @@ void *glGetColorTablePointer(int name)
     return pal->vramAddr;
 }
 
+// Allocates a GL_RGBA texture at an address aligned to its own size (and at
+// least to 32 KB). Textures allocated like this never cross the boundary
+// between two VRAM banks, so they can be used as destination of the display
+// capture circuit. The previous data of the texture is discarded.
+void *libnds_gl_texture_alloc_aligned(int name, int sizeX, int sizeY)
+{
+    gl_texture_data *tex = DynamicArrayGet(&glGlob.texturePtrs, name);
+    if (tex == NULL)
+        return NULL;
+
+    int sx = glTexSizeToEnum(sizeX);
+    int sy = glTexSizeToEnum(sizeY);
+    if ((sx == TEXTURE_SIZE_INVALID) || (sy == TEXTURE_SIZE_INVALID))
+        return NULL;
+
+    uint32_t size = (1 << (sx + sy + 6)) << 1;
+    if (size > 128 * 1024)
+        return NULL;
+
+    uint32_t align = size < 0x8000 ? 0x8000 : size;
+
+    if (tex->texIndexExt)
+        vramBlock_deallocateBlock(glGlob.vramBlocksTex, tex->texIndexExt);
+    if (tex->texIndex)
+        vramBlock_deallocateBlock(glGlob.vramBlocksTex, tex->texIndex);
+    if (tex->palIndex)
+        removePaletteFromTexture(tex);
+
+    tex->texIndex = tex->texIndexExt = 0;
+    tex->vramAddr = NULL;
+    tex->texFormat = 0;
+    tex->texSize = 0;
+
+    // vramBlock_examineSpecial() returns the first free address after the one
+    // provided, so the address is free if the result is the same one.
+    for (uint8_t *addr = (uint8_t *)VRAM_A; addr < (uint8_t *)VRAM_E; addr += align)
+    {
+        if (vramBlock_examineSpecial(glGlob.vramBlocksTex, addr, size, 0) != addr)
+            continue;
+
+        tex->texIndex = vramBlock_allocateSpecial(glGlob.vramBlocksTex, addr, size);
+        if (tex->texIndex == 0)
+            break;
+
+        tex->vramAddr = addr;
+        tex->texSize = size;
+        tex->texFormat = (sx << 20) | (sy << 23) | (GL_RGBA << 26)
+                         | (((uint32_t)addr >> 3) & 0xFFFF);
+        break;
+    }
+
+    if (glGlob.activeTexture == name)
+        GFX_TEX_FORMAT = tex->texFormat;
+
+    return tex->vramAddr;
+}
+
+// Returns true if videoGL has allocated any texture between the two addresses.
+bool libnds_gl_texture_vram_in_use(const void *start, const void *end)
+{
+    if (glGlob.vramBlocksTex == NULL)
+        return false;
+
+    for (struct s_SingleBlock *block = glGlob.vramBlocksTex->firstBlock;
+         block != NULL; block = block->node[1])
+    {
+        // Only allocated blocks have an index
+        if (block->indexOut == 0)
+            continue;
+
+        if ((block->AddrSet < (const uint8_t *)end)
+            && (block->AddrSet + block->blockSize > (const uint8_t *)start))
+            return true;
+    }
+
+    return false;
+}
+
+// Returns the format of any texture, not only the active one.
+u32 libnds_gl_texture_format(int name)
+{
+    gl_texture_data *tex = DynamicArrayGet(&glGlob.texturePtrs, name);
+    if (tex == NULL)
+        return 0;
+
+    return tex->texFormat;
+}
+
 // Retrieves the currently bound texture's format.
 u32 glGetTexParameter(void)
 {
@@ -2172,6 +2263,10 @@ void glCallList(const void *list)
     // Flush the area that we are going to DMA
     DC_FlushRange(ptr, count * 4);
 
+    uint64_t start = 0;
+    if (libnds_gl_profiler_active)
+        start = systemCounterGetTicks();
+
     // There is a hardware bug that affects DMA when there are multiple channels
     // active, under certain conditions. Instead of checking for said
     // conditions, simply ensure that there are no DMA channels active.
@@ -2180,6 +2275,11 @@ void glCallList(const void *list)
     // Send the packed list asynchronously via DMA to the FIFO
     dmaSetParams(0, ptr, (void*) &GFX_FIFO, DMA_FIFO | count);
     while (dmaBusy(0));
+
+    // The DMA transfer waits for the FIFO to have free space, so the time spent
+    // here is the time the CPU has been stalled by the geometry FIFO.
+    if (libnds_gl_profiler_active)
+        libnds_gl_profiler_list(ptr, count, systemCounterGetTicks() - start);
 }
 
 void glClearColor(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Benchmarks of the FAT stack of libnds running on the host on top of a disk
+// image. Each test prints the time it has taken (including the simulated
+// latency of the storage device) and the number of commands and sectors sent
+// to the driver, which doesn't depend on the speed of the host.
+//
+// Usage: bench_fat <image> [command latency (us)] [sector latency (us)]
+//
+// The image is modified, so it should be a copy.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arm9/libc/fat_device.h"
+#include "arm9/libc/fat_dircache.h"
+#include "arm9/libc/fat_linkmap.h"
+#include "arm9/libc/filesystem_includes.h"
+
+#include "disc_file.h"
+#include "fat_host.h"
+
+#define SEQ_FILE_SIZE       (8 * 1024 * 1024)
+#define RANDOM_READS        2000
+#define RANDOM_READ_SIZE    4096
+#define STORM_FILES         500
+#define STORM_ROUNDS        4
+#define LIST_FILES          2000
+
+static uint8_t buffer[32 * 1024];
+
+static uint64_t bench_start_usec;
+
+static void bench_start(void)
+{
+    disc_file_reset_stats();
+    bench_start_usec = disc_file_clock_usec();
+}
+
+static void bench_end(const char *name)
+{
+    uint64_t usec = disc_file_clock_usec() - bench_start_usec;
+
+    disc_file_stats stats;
+    disc_file_get_stats(&stats);
+
+    printf("%-36s %8lu ms | R %6u cmds %8lu sect | W %6u cmds %8lu sect\n",
+           name, (unsigned long)(usec / 1000),
+           (unsigned)stats.read_cmds, (unsigned long)stats.read_sectors,
+           (unsigned)stats.write_cmds, (unsigned long)stats.write_sectors);
+}
+
+static void fail(const char *what)
+{
+    perror(what);
+    exit(1);
+}
+
+static void bench_seq_write(const char *name, size_t chunk, bool prealloc)
+{
+    bench_start();
+
+    int fd = fat_open("fat:/seq.bin", O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd == -1)
+        fail("fat_open(seq.bin)");
+
+    if (prealloc && (fat_preallocate(fd, SEQ_FILE_SIZE) != 0))
+        fail("fat_preallocate()");
+
+    for (size_t done = 0; done < SEQ_FILE_SIZE; done += chunk)
+    {
+        if (fat_write(fd, buffer, chunk) != (ssize_t)chunk)
+            fail("fat_write()");
+    }
+
+    if (fat_close(fd) != 0)
+        fail("fat_close()");
+
+    bench_end(name);
+}
+
+static void bench_seq_read(const char *name, size_t chunk)
+{
+    bench_start();
+
+    int fd = fat_open("fat:/seq.bin", O_RDONLY, 0);
+    if (fd == -1)
+        fail("fat_open(seq.bin)");
+
+    for (size_t done = 0; done < SEQ_FILE_SIZE; done += chunk)
+    {
+        if (fat_read(fd, buffer, chunk) != (ssize_t)chunk)
+            fail("fat_read()");
+    }
+
+    fat_close(fd);
+
+    bench_end(name);
+}
+
+static void bench_random_read(const char *name)
+{
+    srand(1234);
+
+    bench_start();
+
+    int fd = fat_open("fat:/seq.bin", O_RDONLY, 0);
+    if (fd == -1)
+        fail("fat_open(seq.bin)");
+
+    for (int i = 0; i < RANDOM_READS; i++)
+    {
+        off_t offset = rand() % (SEQ_FILE_SIZE - RANDOM_READ_SIZE);
+
+        if (fat_lseek(fd, offset, SEEK_SET) != offset)
+            fail("fat_lseek()");
+
+        if (fat_read(fd, buffer, RANDOM_READ_SIZE) != RANDOM_READ_SIZE)
+            fail("fat_read()");
+    }
+
+    fat_close(fd);
+
+    bench_end(name);
+}
+
+static void create_files(const char *dir, int count)
+{
+    if ((fat_mkdir(dir, 0) != 0) && (errno != EEXIST))
+        fail("fat_mkdir()");
+
+    for (int i = 0; i < count; i++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "%s/file_%04d.bin", dir, i);
+
+        int fd = fat_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (fd == -1)
+            fail("fat_open()");
+
+        fat_write(fd, buffer, i % 100);
+        fat_close(fd);
+    }
+}
+
+static void bench_stat_storm(const char *name)
+{
+    bench_start();
+
+    for (int r = 0; r < STORM_ROUNDS; r++)
+    {
+        for (int i = 0; i < STORM_FILES; i++)
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "fat:/storm/file_%04d.bin", i);
+
+            struct stat st;
+            if (fat_stat(path, &st) != 0)
+                fail("fat_stat()");
+        }
+    }
+
+    bench_end(name);
+}
+
+static void bench_open_storm(const char *name)
+{
+    bench_start();
+
+    for (int r = 0; r < STORM_ROUNDS; r++)
+    {
+        for (int i = 0; i < STORM_FILES; i++)
+        {
+            char path[64];
+            snprintf(path, sizeof(path), "fat:/storm/file_%04d.bin", i);
+
+            int fd = fat_open(path, O_RDONLY, 0);
+            if (fd == -1)
+                fail("fat_open()");
+
+            fat_read(fd, buffer, 16);
+            fat_close(fd);
+        }
+    }
+
+    bench_end(name);
+}
+
+// Lists a directory like "ls -l" does. If "mode" is 0 it only reads the names,
+// if it's 1 it calls stat() for each entry, and if it's 2 it uses
+// fat_readdir_stat() (fatReadDirStat()).
+static void bench_list(const char *name, int mode)
+{
+    bench_start();
+
+    DIR *dirp = fat_host_opendir("fat:/list");
+    if (dirp == NULL)
+        fail("fat_opendir()");
+
+    int count = 0;
+
+    while (1)
+    {
+        struct stat st;
+        struct dirent *ent;
+
+        if (mode == 2)
+            ent = fat_readdir_stat(dirp, &st);
+        else
+            ent = fat_readdir(dirp);
+
+        if (ent == NULL)
+            break;
+
+        if (mode == 1)
+        {
+            char path[300];
+            snprintf(path, sizeof(path), "fat:/list/%s", ent->d_name);
+            if (fat_stat(path, &st) != 0)
+                fail("fat_stat()");
+        }
+
+        count++;
+    }
+
+    fat_host_closedir(dirp);
+
+    bench_end(name);
+
+    // "." and ".." are listed too
+    if (count < LIST_FILES)
+    {
+        printf("Only %d entries found\n", count);
+        exit(1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <image> [command latency (us)] [sector latency (us)]\n",
+               argv[0]);
+        return 1;
+    }
+
+    uint32_t cmd_usec = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0;
+    uint32_t sector_usec = (argc > 3) ? strtoul(argv[3], NULL, 0) : 0;
+
+    if (fat_host_mount(argv[1], FAT_HOST_CACHE_SECTORS) != 0)
+        return 1;
+
+    disc_file_set_latency(cmd_usec, sector_usec);
+
+    printf("Latency: %u us per command, %u us per sector\n\n",
+           (unsigned)cmd_usec, (unsigned)sector_usec);
+
+    memset(buffer, 0x5A, sizeof(buffer));
+
+    bench_seq_write("Write 8 MiB, 32 KiB chunks", 32 * 1024, false);
+    bench_seq_write("Write 8 MiB, 4 KiB chunks", 4 * 1024, false);
+    bench_seq_write("Write 8 MiB, 512 B chunks", 512, false);
+    bench_seq_write("Write 8 MiB, 512 B chunks, prealloc", 512, true);
+
+    bench_seq_read("Read 8 MiB, 32 KiB chunks", 32 * 1024);
+    bench_seq_read("Read 8 MiB, 4 KiB chunks", 4 * 1024);
+    bench_seq_read("Read 8 MiB, 512 B chunks", 512);
+
+    fat_linkmap_configure(0, 0);
+    bench_random_read("Random 4 KiB reads");
+    fat_linkmap_configure(1024 * 1024, 64 * 1024);
+    bench_random_read("Random 4 KiB reads, link map");
+    fat_linkmap_configure(0, 0);
+
+    create_files("fat:/storm", STORM_FILES);
+    create_files("fat:/list", LIST_FILES);
+
+    fat_dircache_set_size(0);
+    bench_stat_storm("stat() storm");
+    bench_open_storm("open() storm");
+    bench_list("readdir()", 0);
+    bench_list("readdir() + stat()", 1);
+    bench_list("fatReadDirStat()", 2);
+
+    fat_dircache_set_size(LIST_FILES + 16);
+    bench_stat_storm("stat() storm, dircache");
+    bench_list("readdir() + stat(), dircache", 1);
+    bench_list("readdir() + stat(), dircache (2)", 1);
+    fat_dircache_set_size(0);
+
+    fat_host_unmount();
+
+    return 0;
+}
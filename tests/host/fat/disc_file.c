@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "disc_file.h"
+
+#define SECTOR_SIZE     512
+
+static FILE *image;
+static uint64_t image_sectors;
+
+static uint32_t latency_cmd_usec;
+static uint32_t latency_sector_usec;
+
+static disc_file_stats stats;
+
+// Simulated latency of all commands since the program started. It isn't reset
+// by disc_file_reset_stats() so that the clock never goes back.
+static uint64_t clock_latency_usec;
+
+static void add_latency(sec_t numSectors)
+{
+    uint64_t usec = latency_cmd_usec + (uint64_t)latency_sector_usec * numSectors;
+
+    stats.latency_usec += usec;
+    clock_latency_usec += usec;
+}
+
+static bool disc_file_startup(void)
+{
+    return image != NULL;
+}
+
+static bool disc_file_is_inserted(void)
+{
+    return image != NULL;
+}
+
+static bool disc_file_read_sectors(sec_t sector, sec_t numSectors, void *buffer)
+{
+    stats.read_cmds++;
+    stats.read_sectors += numSectors;
+    add_latency(numSectors);
+
+    if ((uint64_t)sector + numSectors > image_sectors)
+        return false;
+
+    if (fseek(image, (long)sector * SECTOR_SIZE, SEEK_SET) != 0)
+        return false;
+
+    return fread(buffer, SECTOR_SIZE, numSectors, image) == numSectors;
+}
+
+static bool disc_file_write_sectors(sec_t sector, sec_t numSectors,
+                                    const void *buffer)
+{
+    stats.write_cmds++;
+    stats.write_sectors += numSectors;
+    add_latency(numSectors);
+
+    if ((uint64_t)sector + numSectors > image_sectors)
+        return false;
+
+    if (fseek(image, (long)sector * SECTOR_SIZE, SEEK_SET) != 0)
+        return false;
+
+    return fwrite(buffer, SECTOR_SIZE, numSectors, image) == numSectors;
+}
+
+static bool disc_file_clear_status(void)
+{
+    return true;
+}
+
+static bool disc_file_shutdown(void)
+{
+    if (image == NULL)
+        return true;
+
+    bool ok = fclose(image) == 0;
+    image = NULL;
+    return ok;
+}
+
+static const DISC_INTERFACE disc_file_interface = {
+    .ioType = ('F') | ('I' << 8) | ('L' << 16) | ('E' << 24),
+    .features = FEATURE_MEDIUM_CANREAD | FEATURE_MEDIUM_CANWRITE,
+    .startup = disc_file_startup,
+    .isInserted = disc_file_is_inserted,
+    .readSectors = disc_file_read_sectors,
+    .writeSectors = disc_file_write_sectors,
+    .clearStatus = disc_file_clear_status,
+    .shutdown = disc_file_shutdown,
+};
+
+const DISC_INTERFACE *disc_file_open(const char *path)
+{
+    if (image != NULL)
+        return NULL;
+
+    image = fopen(path, "r+b");
+    if (image == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    if (fseek(image, 0, SEEK_END) != 0)
+    {
+        fclose(image);
+        image = NULL;
+        return NULL;
+    }
+
+    image_sectors = ftell(image) / SECTOR_SIZE;
+
+    disc_file_reset_stats();
+
+    return &disc_file_interface;
+}
+
+void disc_file_set_latency(uint32_t cmd_usec, uint32_t sector_usec)
+{
+    latency_cmd_usec = cmd_usec;
+    latency_sector_usec = sector_usec;
+}
+
+void disc_file_get_stats(disc_file_stats *out)
+{
+    *out = stats;
+}
+
+void disc_file_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint64_t disc_file_clock_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    uint64_t real_usec = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+    return real_usec + clock_latency_usec;
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// DISC_INTERFACE backed by a disk image stored in a file of the host. Every
+// command sent by the FAT stack is counted, and it can add a simulated latency
+// to each command to model a slow flashcart or SD card.
+//
+// The latency isn't spent sleeping: it's added to a simulated clock that is
+// returned by disc_file_clock_usec() (and by systemCounterGetTicks() in the
+// host build). This makes the results of the benchmarks reproducible and the
+// benchmarks fast even with big latencies.
+
+#ifndef DISC_FILE_H__
+#define DISC_FILE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nds/disc_io.h>
+
+typedef struct
+{
+    uint32_t read_cmds;     // Calls to readSectors()
+    uint32_t write_cmds;    // Calls to writeSectors()
+    uint64_t read_sectors;  // Sectors read by all readSectors() calls
+    uint64_t write_sectors; // Sectors written by all writeSectors() calls
+    uint64_t latency_usec;  // Simulated time spent by all commands
+} disc_file_stats;
+
+// Opens a disk image. It returns NULL on error. Only one image can be open at
+// a time. The file is closed when the FAT stack calls shutdown().
+const DISC_INTERFACE *disc_file_open(const char *path);
+
+// Sets the simulated latency of each command: a fixed cost per command and a
+// cost per sector transferred.
+void disc_file_set_latency(uint32_t cmd_usec, uint32_t sector_usec);
+
+void disc_file_get_stats(disc_file_stats *stats);
+void disc_file_reset_stats(void);
+
+// Time of the host's monotonic clock plus the simulated latency of all the
+// commands sent since the program started.
+uint64_t disc_file_clock_usec(void);
+
+#endif // DISC_FILE_H__
@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Host versions of the functions of libnds and of the OS-dependent functions
+// of FatFs that the FAT stack needs. There is only one thread: threads run to
+// completion when they are created, and mutexes are never contended.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nds/arm9/dldi.h>
+#include <nds/arm9/sdmmc.h>
+#include <nds/cothread.h>
+#include <nds/disc_io.h>
+#include <nds/system.h>
+#include <nds/system_counter.h>
+
+#include "arm9/libc/device_io_internal.h"
+#include "arm9/libc/fat_device.h"
+#include "arm9/libc/nitrofs_device.h"
+#include "arm9/libc/file_descriptors.h"
+#include "arm9/libc/filesystem_includes.h"
+#include "arm9/libc/fatfs/cache.h"
+#include "arm9/libc/fatfs/diskio_internal.h"
+
+#include "disc_file.h"
+#include "fat_host.h"
+
+// File descriptors of FAT files are pointers to their fat_file_t. They only
+// have 28 bits, which works on the host as long as the heap is in the lowest
+// 256 MiB of the address space (this is why the tests are built with -no-pie).
+#define FD_MAX_ADDRESS  0x10000000
+
+PARTITION VolToPart[FF_VOLUMES] = {
+    {0, 0}, // "fat:"
+    {1, 0}, // "sd:"
+    {2, 1}, // "nand:"
+    {2, 2}, // "nand2:"
+};
+
+static FATFS fat_host_fs;
+
+int fat_host_mount(const char *image, int32_t cache_sectors)
+{
+    if ((uintptr_t)sbrk(0) >= FD_MAX_ADDRESS)
+    {
+        printf("The heap is too high for FAT file descriptors\n");
+        return -1;
+    }
+
+    const DISC_INTERFACE *io = disc_file_open(image);
+    if (io == NULL)
+        return -1;
+
+    if (cache_init(cache_sectors) != 0)
+        return -1;
+
+    disk_set_custom_io(io);
+
+    FRESULT result = f_mount(&fat_host_fs, "fat:", 1);
+    if (result != FR_OK)
+    {
+        printf("f_mount(): %d\n", result);
+        disk_set_custom_io(NULL);
+        return -1;
+    }
+
+    if (f_chdrive("fat:") != FR_OK)
+        return -1;
+
+    return 0;
+}
+
+void fat_host_unmount(void)
+{
+    f_mount(NULL, "fat:", 0);
+
+    // This shuts down the driver, which closes the image
+    disk_set_custom_io(NULL);
+}
+
+DIR *fat_host_opendir(const char *path)
+{
+    DIR *dirp = calloc(1, sizeof(DIR));
+    if (dirp == NULL)
+        return NULL;
+
+    dirp->dptype = FD_TYPE_FAT;
+    dirp->dp = fat_opendir(path, dirp);
+    if (dirp->dp == NULL)
+    {
+        free(dirp);
+        return NULL;
+    }
+
+    return dirp;
+}
+
+void fat_host_closedir(DIR *dirp)
+{
+    fat_closedir(dirp);
+    free(dirp);
+}
+
+// OS-dependent functions of FatFs (ffsystem.c)
+
+int ff_mutex_create(int vol)
+{
+    (void)vol;
+    return 1;
+}
+
+void ff_mutex_delete(int vol)
+{
+    (void)vol;
+}
+
+int ff_mutex_take(int vol)
+{
+    (void)vol;
+    return 1;
+}
+
+void ff_mutex_give(int vol)
+{
+    (void)vol;
+}
+
+// Cooperative threads
+
+cothread_t cothread_create(cothread_entrypoint_t entrypoint, void *arg,
+                           size_t stack_size, unsigned int flags)
+{
+    (void)stack_size;
+    (void)flags;
+
+    entrypoint(arg);
+    return 1;
+}
+
+void cothread_yield(void)
+{
+}
+
+void cothread_yield_signal(uint32_t signal_id)
+{
+    (void)signal_id;
+}
+
+void cothread_send_signal(uint32_t signal_id)
+{
+    (void)signal_id;
+}
+
+// Drivers. "fat:" always uses the driver of disc_file.c, and the DSi drives
+// don't exist.
+
+const DISC_INTERFACE *dldiGetInternal(void)
+{
+    return NULL;
+}
+
+// There is no DLDI stub, so the sector cache is always allocated with malloc()
+static uint8_t dldi_stub[1];
+
+uint8_t *dldiGetStubDataEnd(void)
+{
+    return dldi_stub;
+}
+
+uint8_t *dldiGetStubEnd(void)
+{
+    return dldi_stub;
+}
+
+const DISC_INTERFACE *get_io_dsisd(void)
+{
+    return NULL;
+}
+
+const DISC_INTERFACE *get_io_dsinand(void)
+{
+    return NULL;
+}
+
+u8 sdmmc_GetDiskStatus(void)
+{
+    return 0;
+}
+
+u8 nand_GetDiskStatus(void)
+{
+    return 0;
+}
+
+u32 sdmmc_GetSectors(void)
+{
+    return 0;
+}
+
+u32 nand_GetSectors(void)
+{
+    return 0;
+}
+
+// System
+
+bool memBufferIsInMainRam(const void *buffer, size_t size)
+{
+    (void)buffer;
+    (void)size;
+    return true;
+}
+
+void __aeabi_memcpy(void *restrict dest, const void *restrict src, size_t n)
+{
+    memcpy(dest, src, n);
+}
+
+int deviceIoGetIndexFromPath(const char *path)
+{
+    (void)path;
+    return FD_TYPE_FAT;
+}
+
+VoidFunction deviceIoGetFunctionFromIndex(int index, size_t offset)
+{
+    (void)index;
+    (void)offset;
+    return NULL;
+}
+
+// NitroFS isn't available
+
+int nitrofs_fat_get_attr(const char *name)
+{
+    (void)name;
+    errno = ENODEV;
+    return -1;
+}
+
+int nitrofs_fat_set_attr(const char *file, uint8_t attr)
+{
+    (void)file;
+    (void)attr;
+    errno = ENODEV;
+    return -1;
+}
+
+bool nitrofs_fat_get_short_name_for(const char *path, char *buf)
+{
+    (void)path;
+    (void)buf;
+    return false;
+}
+
+struct dirent *nitrofs_readdir_stat(DIR *dirp, struct stat *st)
+{
+    (void)dirp;
+    (void)st;
+    errno = ENODEV;
+    return NULL;
+}
+
+uint64_t systemCounterGetTicks(void)
+{
+    return disc_file_clock_usec() * (BUS_CLOCK / 64) / 1000000;
+}
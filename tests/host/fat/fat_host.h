@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Helpers to run the FAT stack of libnds (FatFs, the sector cache in diskio.c
+// and the POSIX layer in fat_device.c) on the host on top of a disk image.
+
+#ifndef FAT_HOST_H__
+#define FAT_HOST_H__
+
+#include <stdint.h>
+
+#include "arm9/libc/filesystem_includes.h"
+
+// Size of the sector cache used by fat_host_mount(), in sectors. It's the
+// same as the default of fatInitDefault() with a common DLDI driver.
+#define FAT_HOST_CACHE_SECTORS  32
+
+// Mounts the image as "fat:" and makes it the current drive. It returns 0 on
+// success, -1 on error.
+int fat_host_mount(const char *image, int32_t cache_sectors);
+
+// Unmounts "fat:" and closes the image.
+void fat_host_unmount(void);
+
+// Equivalent to opendir() and closedir() for FAT directories
+DIR *fat_host_opendir(const char *path);
+void fat_host_closedir(DIR *dirp);
+
+#endif // FAT_HOST_H__
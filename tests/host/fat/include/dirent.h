@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// The DIR of glibc is an opaque "struct __dirstream". libnds defines that
+// struct in include/sys/dirent.h, which isn't included by glibc, so it's
+// defined here with the same members.
+
+#ifndef HOST_DIRENT_H__
+#define HOST_DIRENT_H__
+
+#include_next <dirent.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+struct __dirstream
+{
+    struct dirent dirent;
+    void *dp;
+    off_t index;
+    uint8_t dptype;
+};
+
+#endif // HOST_DIRENT_H__
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// The offsets used by the assembly code of the scheduler assume 32-bit
+// pointers. The host build doesn't use that code, so the offsets are replaced
+// by the ones of the host.
+
+#ifndef HOST_COTHREAD_ASM_H__
+#define HOST_COTHREAD_ASM_H__
+
+#include_next <nds/cothread_asm.h>
+
+#undef COTHREAD_INFO_NEXT_IRQ_OFFSET
+#undef COTHREAD_INFO_FLAGS_OFFSET
+#define COTHREAD_INFO_NEXT_IRQ_OFFSET   offsetof(cothread_info_t, next_irq)
+#define COTHREAD_INFO_FLAGS_OFFSET      offsetof(cothread_info_t, flags)
+
+#endif // HOST_COTHREAD_ASM_H__
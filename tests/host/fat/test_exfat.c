@@ -0,0 +1,420 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Host tests of the FAT stack of libnds on an exFAT disk image. The image must
+// be at least 4 GiB so that files bigger than 2 GiB can be created (it can be
+// a sparse file).
+//
+// Usage: test_exfat <image>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fat.h>
+
+#include "arm9/libc/fat_device.h"
+#include "arm9/libc/fat_linkmap.h"
+#include "arm9/libc/filesystem_includes.h"
+
+#include "disc_file.h"
+#include "fat_host.h"
+
+#define DATA_SIZE       (300 * 1024 + 123)
+#define STAT_FILES      40
+#define BIG_FILE_SIZE   (3LL * 1024 * 1024 * 1024)
+#define FRAG_CHUNK      (32 * 1024)
+#define FRAG_CHUNKS     16
+
+static int failures;
+
+#define CHECK(cond, ...)                                        \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+        {                                                       \
+            printf("%s:%d: ", __func__, __LINE__);              \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            failures++;                                         \
+        }                                                       \
+    } while (0)
+
+static const char *disc_image;
+
+static uint8_t data[DATA_SIZE];
+static uint8_t readback[DATA_SIZE];
+
+static void fill_pattern(uint8_t *buf, size_t size, unsigned int seed)
+{
+    for (size_t i = 0; i < size; i++)
+        buf[i] = (i * 31 + seed + (i >> 9)) & 0xFF;
+}
+
+static bool write_file(const char *path, const void *buf, size_t size)
+{
+    int fd = fat_open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd == -1)
+        return false;
+
+    bool ok = fat_write(fd, buf, size) == (ssize_t)size;
+
+    return (fat_close(fd) == 0) && ok;
+}
+
+static void test_mount(void)
+{
+    struct statvfs vfs;
+    CHECK(fat_statvfs("fat:/", &vfs) == 0, "statvfs failed");
+    CHECK(vfs.f_blocks > 0, "no clusters");
+    CHECK(vfs.f_bfree <= vfs.f_blocks, "%lu free of %lu clusters",
+          (unsigned long)vfs.f_bfree, (unsigned long)vfs.f_blocks);
+
+    // The label of exFAT volumes is stored in UTF-16, with up to 11 characters
+    const char *label = "NDS ÉXFAT ✓";
+
+    CHECK(fatSetVolumeLabel("fat:/", label), "fatSetVolumeLabel() failed");
+
+    char buf[FAT_VOLUME_LABEL_MAX + 1];
+    CHECK(fatGetVolumeLabel("fat:", buf), "fatGetVolumeLabel() failed");
+    CHECK(strcmp(buf, label) == 0, "label is \"%s\"", buf);
+}
+
+static void test_read_write(void)
+{
+    // Long name with characters that aren't in any code page
+    const char *dir = "fat:/Directory with a long name ñ";
+    const char *path = "fat:/Directory with a long name ñ/Ωmega file name.bin";
+
+    CHECK(fat_mkdir(dir, 0) == 0, "mkdir failed");
+
+    fill_pattern(data, sizeof(data), 1);
+
+    // Write in chunks that aren't aligned to sectors or clusters
+    int fd = fat_open(path, O_RDWR | O_CREAT | O_TRUNC, 0);
+    CHECK(fd != -1, "open failed");
+
+    size_t done = 0;
+    size_t chunk = 1;
+    while (done < sizeof(data))
+    {
+        size_t size = sizeof(data) - done;
+        if (size > chunk)
+            size = chunk;
+
+        ssize_t ret = fat_write(fd, data + done, size);
+        CHECK(ret == (ssize_t)size, "write of %zu bytes at %zu returned %zd",
+              size, done, ret);
+        if (ret != (ssize_t)size)
+            break;
+
+        done += size;
+        chunk = chunk * 3 + 7;
+        if (chunk > 70000)
+            chunk = 5;
+    }
+
+    CHECK(fat_lseek(fd, 0, SEEK_CUR) == DATA_SIZE, "wrong file position");
+    CHECK(fat_lseek(fd, -100, SEEK_END) == DATA_SIZE - 100, "SEEK_END failed");
+    CHECK(fat_read(fd, readback, 200) == 100, "short read at the end failed");
+    CHECK(memcmp(readback, data + DATA_SIZE - 100, 100) == 0,
+          "data at the end differs");
+
+    CHECK(fat_lseek(fd, -1, SEEK_SET) == -1, "negative position accepted");
+    CHECK(errno == EINVAL, "errno = %d", errno);
+
+    CHECK(fat_close(fd) == 0, "close failed");
+
+    // Read it again after mounting the image again, so that nothing can come
+    // from the sector cache.
+    fat_host_unmount();
+    CHECK(fat_host_mount(disc_image, FAT_HOST_CACHE_SECTORS) == 0,
+          "mount failed");
+
+    fd = fat_open(path, O_RDONLY, 0);
+    CHECK(fd != -1, "open failed");
+    memset(readback, 0, sizeof(readback));
+    CHECK(fat_read(fd, readback, sizeof(readback)) == DATA_SIZE, "read failed");
+    CHECK(memcmp(readback, data, sizeof(data)) == 0, "data differs");
+
+    // Unaligned random reads
+    for (int i = 0; i < 100; i++)
+    {
+        off_t offset = rand() % (DATA_SIZE - 5000);
+        size_t size = 1 + rand() % 5000;
+
+        CHECK(fat_lseek(fd, offset, SEEK_SET) == offset, "seek failed");
+        CHECK(fat_read(fd, readback, size) == (ssize_t)size, "read failed");
+        CHECK(memcmp(readback, data + offset, size) == 0,
+              "data at %ld differs", (long)offset);
+    }
+
+    CHECK(fat_close(fd) == 0, "close failed");
+}
+
+static void check_stat_equal(const char *name, const struct stat *a,
+                             const struct stat *b)
+{
+    CHECK(a->st_size == b->st_size, "%s: size %ld != %ld", name,
+          (long)a->st_size, (long)b->st_size);
+    CHECK(a->st_mode == b->st_mode, "%s: mode 0x%x != 0x%x", name,
+          (unsigned)a->st_mode, (unsigned)b->st_mode);
+    CHECK(a->st_dev == b->st_dev, "%s: dev %lu != %lu", name,
+          (unsigned long)a->st_dev, (unsigned long)b->st_dev);
+    CHECK(a->st_ino == b->st_ino, "%s: ino %lu != %lu", name,
+          (unsigned long)a->st_ino, (unsigned long)b->st_ino);
+    CHECK(a->st_mtime == b->st_mtime, "%s: mtime %ld != %ld", name,
+          (long)a->st_mtime, (long)b->st_mtime);
+}
+
+// stat(), fstat() and fatReadDirStat() must report the same information
+static void test_stat(void)
+{
+    CHECK(fat_mkdir("fat:/stat", 0) == 0, "mkdir failed");
+    CHECK(fat_mkdir("fat:/stat/subdir", 0) == 0, "mkdir failed");
+
+    for (int i = 0; i < STAT_FILES; i++)
+    {
+        char path[64];
+        snprintf(path, sizeof(path), "fat:/stat/file_%02d.bin", i);
+        CHECK(write_file(path, data, i * 1000), "can't create %s", path);
+    }
+
+    DIR *dirp = fat_host_opendir("fat:/stat");
+    CHECK(dirp != NULL, "opendir failed");
+    if (dirp == NULL)
+        return;
+
+    int files = 0;
+    int dirs = 0;
+
+    while (1)
+    {
+        struct stat st_dir;
+        struct dirent *ent = fatReadDirStat(dirp, &st_dir);
+        if (ent == NULL)
+            break;
+
+        if ((strcmp(ent->d_name, ".") == 0) || (strcmp(ent->d_name, "..") == 0))
+            continue;
+
+        char path[300];
+        snprintf(path, sizeof(path), "fat:/stat/%s", ent->d_name);
+
+        struct stat st_path;
+        CHECK(fat_stat(path, &st_path) == 0, "stat(%s) failed", path);
+        check_stat_equal(ent->d_name, &st_dir, &st_path);
+
+        if (S_ISDIR(st_dir.st_mode))
+        {
+            CHECK(ent->d_type == DT_DIR, "%s: d_type %d", ent->d_name,
+                  ent->d_type);
+            dirs++;
+            continue;
+        }
+
+        CHECK(ent->d_type == DT_REG, "%s: d_type %d", ent->d_name,
+              ent->d_type);
+
+        // FatFs doesn't report the first cluster of exFAT entries, so st_ino
+        // is 0 in all cases.
+        CHECK(st_dir.st_ino == 0, "%s: ino %lu", ent->d_name,
+              (unsigned long)st_dir.st_ino);
+
+        int fd = fat_open(path, O_RDONLY, 0);
+        CHECK(fd != -1, "open(%s) failed", path);
+
+        struct stat st_fd;
+        CHECK(fat_fstat(fd, &st_fd) == 0, "fstat(%s) failed", path);
+        CHECK(st_fd.st_size == st_dir.st_size, "%s: fstat size %ld != %ld",
+              ent->d_name, (long)st_fd.st_size, (long)st_dir.st_size);
+        CHECK(st_fd.st_ino == st_dir.st_ino, "%s: fstat ino %lu != %lu",
+              ent->d_name, (unsigned long)st_fd.st_ino,
+              (unsigned long)st_dir.st_ino);
+        CHECK(S_ISREG(st_fd.st_mode), "%s: fstat mode 0x%x", ent->d_name,
+              (unsigned)st_fd.st_mode);
+
+        fat_close(fd);
+        files++;
+    }
+
+    fat_host_closedir(dirp);
+
+    CHECK(files == STAT_FILES, "%d files found", files);
+    CHECK(dirs == 1, "%d directories found", dirs);
+
+    // Renaming and deleting entries
+    CHECK(fat_rename("fat:/stat/file_00.bin", "fat:/stat/subdir/renamed.bin") == 0,
+          "rename failed");
+
+    struct stat st;
+    CHECK(fat_stat("fat:/stat/file_00.bin", &st) == -1, "old name exists");
+    CHECK(fat_stat("fat:/stat/subdir/renamed.bin", &st) == 0, "new name missing");
+    CHECK(fat_unlink("fat:/stat/subdir/renamed.bin") == 0, "unlink failed");
+    CHECK(fat_rmdir("fat:/stat/subdir") == 0, "rmdir failed");
+    CHECK(fat_stat("fat:/stat/subdir", &st) == -1, "directory exists");
+}
+
+// Files of 2 GiB or more only fit in off_t on hosts with a 64-bit off_t. On the
+// DS, where it's 32-bit, the functions must fail with EOVERFLOW.
+static void test_big_file(void)
+{
+    const char *path = "fat:/big.bin";
+    bool off_t_64 = sizeof(off_t) > 4;
+
+    int fd = fat_open(path, O_RDWR | O_CREAT | O_TRUNC, 0);
+    CHECK(fd != -1, "open failed");
+    if (fd == -1)
+        return;
+
+    // Allocate a contiguous file without writing its contents
+    CHECK(fat_preallocate(fd, BIG_FILE_SIZE) == 0, "preallocate failed");
+
+    struct stat st;
+    int ret = fat_fstat(fd, &st);
+    if (off_t_64)
+    {
+        CHECK(ret == 0, "fstat failed");
+        CHECK(st.st_size == BIG_FILE_SIZE, "fstat size %lld",
+              (long long)st.st_size);
+    }
+    else
+    {
+        CHECK((ret == -1) && (errno == EOVERFLOW), "fstat didn't overflow");
+    }
+
+    off_t end = fat_lseek(fd, 0, SEEK_END);
+    if (off_t_64)
+    {
+        CHECK(end == BIG_FILE_SIZE, "SEEK_END returned %lld", (long long)end);
+
+        // Data written after the first 2 GiB can be read back
+        fill_pattern(data, 4096, 2);
+        CHECK(fat_lseek(fd, -4096, SEEK_END) == BIG_FILE_SIZE - 4096,
+              "seek failed");
+        CHECK(fat_write(fd, data, 4096) == 4096, "write failed");
+        CHECK(fat_lseek(fd, BIG_FILE_SIZE - 4096, SEEK_SET)
+              == BIG_FILE_SIZE - 4096, "seek failed");
+        CHECK(fat_read(fd, readback, 4096) == 4096, "read failed");
+        CHECK(memcmp(readback, data, 4096) == 0, "data differs");
+    }
+    else
+    {
+        CHECK((end == -1) && (errno == EOVERFLOW), "SEEK_END didn't overflow");
+    }
+
+    CHECK(fat_close(fd) == 0, "close failed");
+
+    ret = fat_stat(path, &st);
+    if (off_t_64)
+        CHECK((ret == 0) && (st.st_size == BIG_FILE_SIZE), "stat failed");
+    else
+        CHECK((ret == -1) && (errno == EOVERFLOW), "stat didn't overflow");
+
+    CHECK(fat_unlink(path) == 0, "unlink failed");
+}
+
+// exFAT files allocated in one block don't use the FAT, so they don't get an
+// automatic link map. Fragmented files do.
+static void test_linkmap(void)
+{
+    fill_pattern(data, FRAG_CHUNK * 2, 3);
+
+    // Write two files at the same time so that their clusters are interleaved
+    int fd_a = fat_open("fat:/frag_a.bin", O_WRONLY | O_CREAT | O_TRUNC, 0);
+    int fd_b = fat_open("fat:/frag_b.bin", O_WRONLY | O_CREAT | O_TRUNC, 0);
+    CHECK((fd_a != -1) && (fd_b != -1), "open failed");
+
+    for (int i = 0; i < FRAG_CHUNKS; i++)
+    {
+        CHECK(fat_write(fd_a, data, FRAG_CHUNK) == FRAG_CHUNK, "write failed");
+        CHECK(fat_write(fd_b, data + FRAG_CHUNK, FRAG_CHUNK) == FRAG_CHUNK,
+              "write failed");
+    }
+
+    fat_close(fd_a);
+    fat_close(fd_b);
+
+    int fd_c = fat_open("fat:/contig.bin", O_WRONLY | O_CREAT | O_TRUNC, 0);
+    CHECK(fat_preallocate(fd_c, FRAG_CHUNK * FRAG_CHUNKS) == 0,
+          "preallocate failed");
+    for (int i = 0; i < FRAG_CHUNKS; i++)
+        CHECK(fat_write(fd_c, data, FRAG_CHUNK) == FRAG_CHUNK, "write failed");
+    fat_close(fd_c);
+
+    fat_linkmap_configure(1, 64 * 1024);
+
+    fd_a = fat_open("fat:/frag_a.bin", O_RDONLY, 0);
+    CHECK(fat_file_from_fd(fd_a)->fil.cltbl != NULL,
+          "fragmented file without link map");
+
+    fd_c = fat_open("fat:/contig.bin", O_RDONLY, 0);
+    CHECK(fat_file_from_fd(fd_c)->fil.cltbl == NULL,
+          "contiguous file with link map");
+
+    // Seek backwards through the file using the link map
+    for (int i = FRAG_CHUNKS - 1; i >= 0; i--)
+    {
+        off_t offset = i * FRAG_CHUNK + 1000;
+        CHECK(fat_lseek(fd_a, offset, SEEK_SET) == offset, "seek failed");
+        CHECK(fat_read(fd_a, readback, 100) == 100, "read failed");
+        CHECK(memcmp(readback, data + 1000, 100) == 0, "chunk %d differs", i);
+    }
+
+    fat_close(fd_a);
+    fat_close(fd_c);
+
+    fat_linkmap_configure(0, 0);
+}
+
+static void test_free_space(void)
+{
+    struct statvfs before, after;
+
+    CHECK(fat_statvfs("fat:/", &before) == 0, "statvfs failed");
+    CHECK(write_file("fat:/space.bin", data, DATA_SIZE), "write failed");
+    CHECK(fat_statvfs("fat:/", &after) == 0, "statvfs failed");
+
+    unsigned long used = (before.f_bfree - after.f_bfree) * before.f_bsize;
+    CHECK(used >= DATA_SIZE, "the file used %lu bytes", used);
+
+    CHECK(fat_unlink("fat:/space.bin") == 0, "unlink failed");
+    CHECK(fat_statvfs("fat:/", &after) == 0, "statvfs failed");
+    CHECK(after.f_bfree == before.f_bfree, "%lu clusters leaked",
+          (unsigned long)(before.f_bfree - after.f_bfree));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <image>\n", argv[0]);
+        return 1;
+    }
+
+    disc_image = argv[1];
+
+    if (fat_host_mount(disc_image, FAT_HOST_CACHE_SECTORS) != 0)
+        return 1;
+
+    srand(1234);
+
+    test_mount();
+    test_read_write();
+    test_stat();
+    test_big_file();
+    test_linkmap();
+    test_free_space();
+
+    fat_host_unmount();
+
+    if (failures != 0)
+    {
+        printf("exFAT: %d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("exFAT: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Host tests of the mesh encoder of nds/arm9/glMesh.h. The encoded display
+// lists are decoded with glMeshDecodePositions() and compared with the source
+// vertices.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/glMesh.h>
+
+#define MAX_VERTICES    512
+#define MAX_WORDS       (MAX_VERTICES * 8 + 16)
+#define ITERATIONS      2000
+
+static int failures;
+
+#define CHECK(cond, ...)                                        \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+        {                                                       \
+            printf("%s:%d: ", __func__, __LINE__);              \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            failures++;                                         \
+        }                                                       \
+    } while (0)
+
+static int16_t positions[MAX_VERTICES * 3];
+static int16_t decoded[MAX_VERTICES * 3];
+static uint32_t normals[MAX_VERTICES];
+static uint32_t texcoords[MAX_VERTICES];
+static uint16_t colors[MAX_VERTICES];
+static uint32_t list[MAX_WORDS];
+
+// Generates a stream that exercises all the vertex commands: shared
+// coordinates, small differences, multiples of 64 and arbitrary values.
+static void random_positions(size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int16_t *v = &positions[i * 3];
+        const int16_t *p = (i > 0) ? &positions[(i - 1) * 3] : NULL;
+
+        for (int c = 0; c < 3; c++)
+            v[c] = (int16_t)(rand() & 0xFFFF);
+
+        switch (rand() % 5)
+        {
+            case 0: // One coordinate shared with the previous vertex
+                if (p != NULL)
+                {
+                    int c = rand() % 3;
+                    v[c] = p[c];
+                }
+                break;
+            case 1: // Small difference, it may wrap around
+                if (p != NULL)
+                {
+                    // VTX_DIFF can only encode multiples of 8. Use values just
+                    // outside of the valid range too.
+                    int scale = (rand() & 1) ? 8 : 1;
+                    for (int c = 0; c < 3; c++)
+                    {
+                        int d = (rand() % 1040) - 520;
+                        v[c] = (int16_t)(p[c] + d * scale);
+                    }
+                }
+                break;
+            case 2: // Representable with VTX_10
+                for (int c = 0; c < 3; c++)
+                    v[c] &= ~0x3F;
+                break;
+            default: // Anything
+                break;
+        }
+    }
+}
+
+static void test_round_trip(void)
+{
+    for (int it = 0; it < ITERATIONS; it++)
+    {
+        size_t count = rand() % MAX_VERTICES;
+        random_positions(count);
+
+        glMeshStream stream = {
+            .positions = positions,
+            .count = count,
+            .primitive = rand() & 3,
+        };
+
+        unsigned int flags = (it & 1) ? GL_MESH_NO_BEGIN_END : 0;
+
+        glMeshStats stats;
+        size_t size = glMeshEncode(&stream, NULL, 0, flags, &stats);
+        size_t words = glMeshEncode(&stream, list, MAX_WORDS, flags, NULL);
+
+        CHECK(size != 0, "size query failed");
+        CHECK(size == words, "size query %zu != %zu", size, words);
+        CHECK(stats.words == words, "stats.words %u != %zu",
+              (unsigned)stats.words, words);
+        CHECK(list[0] == words - 1, "list size %u != %zu",
+              (unsigned)list[0], words - 1);
+        CHECK(stats.vtx16 + stats.vtx10 + stats.vtx_xy_xz_yz + stats.vtx_diff
+              == count, "vertex command count mismatch");
+        CHECK(stats.rounded == 0, "vertices rounded without the flag");
+
+        int n = glMeshDecodePositions(list, decoded, MAX_VERTICES);
+        CHECK(n == (int)count, "decoded %d vertices, expected %zu", n, count);
+        if (n != (int)count)
+            continue;
+
+        for (size_t i = 0; i < count * 3; i++)
+        {
+            if (decoded[i] != positions[i])
+            {
+                CHECK(0, "iteration %d, vertex %zu: %d != %d", it, i / 3,
+                      decoded[i], positions[i]);
+                break;
+            }
+        }
+
+        // The encoder must reject buffers that are one word too small
+        if (words > 1)
+        {
+            size_t r = glMeshEncode(&stream, list, words - 1, flags, NULL);
+            CHECK(r == 0, "short buffer accepted");
+        }
+    }
+}
+
+static void test_commands(void)
+{
+    // Each vertex of this stream can only be encoded with one command
+    static const int16_t v[] = {
+        0x1234, 0x0567, 0x0089, // VTX_16 (first vertex, not multiple of 64)
+        0x1111, 0x2222, 0x0089, // VTX_XY
+        0x3333, 0x2222, 0x4444, // VTX_XZ
+        0x3333, 0x5555, 0x6666, // VTX_YZ
+        0x333B, 0x554D, 0x666E, // VTX_DIFF (+8, -8, +8)
+        0x0040, 0x0080, 0x00C0, // VTX_10
+    };
+
+    glMeshStream stream = {
+        .positions = v,
+        .count = 6,
+        .primitive = 0,
+    };
+
+    glMeshStats stats;
+    size_t words = glMeshEncode(&stream, list, MAX_WORDS, 0, &stats);
+
+    CHECK(stats.vtx16 == 1, "vtx16 = %u", (unsigned)stats.vtx16);
+    CHECK(stats.vtx_xy_xz_yz == 3, "vtx_xy_xz_yz = %u",
+          (unsigned)stats.vtx_xy_xz_yz);
+    CHECK(stats.vtx_diff == 1, "vtx_diff = %u", (unsigned)stats.vtx_diff);
+    CHECK(stats.vtx10 == 1, "vtx10 = %u", (unsigned)stats.vtx10);
+
+    // Size word, 2 command words, BEGIN_VTXS (1), VTX_16 (2), 5 vertices with
+    // one parameter each.
+    CHECK(words == 1 + 2 + 1 + 2 + 5, "words = %zu", words);
+
+    // BEGIN_VTXS, VTX_16, VTX_XY, VTX_XZ, then VTX_YZ, VTX_DIFF, VTX_10, END
+    CHECK(list[1] == 0x26252340, "first command word = 0x%08X",
+          (unsigned)list[1]);
+
+    // The differences are stored divided by 8: (1, -1, 1)
+    CHECK(list[9] == 0x001FFC01, "VTX_DIFF parameter = 0x%08X",
+          (unsigned)list[9]);
+
+    int n = glMeshDecodePositions(list, decoded, 6);
+    CHECK(n == 6, "decoded %d vertices", n);
+    CHECK(memcmp(decoded, v, sizeof(v)) == 0, "decoded positions differ");
+
+    // Not enough space in the destination of the decoder
+    n = glMeshDecodePositions(list, decoded, 5);
+    CHECK(n == -1, "decoder overflow not detected (%d)", n);
+
+    // Small differences that aren't multiples of 8 can't use VTX_DIFF
+    static const int16_t w[] = {
+        0x1234, 0x0567, 0x0089, // VTX_16
+        0x1235, 0x0566, 0x008D, // VTX_16 (+1, -1, +4)
+        0x123D, 0x055E, 0x0095, // VTX_DIFF (+8, -8, +8)
+        0x1245, 0x0560, 0x009D, // VTX_16 (+8, +2, +8)
+    };
+
+    stream.positions = w;
+    stream.count = 4;
+
+    words = glMeshEncode(&stream, list, MAX_WORDS, 0, &stats);
+
+    CHECK(stats.vtx16 == 3, "vtx16 = %u", (unsigned)stats.vtx16);
+    CHECK(stats.vtx_diff == 1, "vtx_diff = %u", (unsigned)stats.vtx_diff);
+
+    n = glMeshDecodePositions(list, decoded, 4);
+    CHECK(n == 4, "decoded %d vertices", n);
+    CHECK(memcmp(decoded, w, sizeof(w)) == 0, "decoded positions differ");
+}
+
+static void test_rounding(void)
+{
+    for (int it = 0; it < ITERATIONS; it++)
+    {
+        size_t count = 1 + rand() % (MAX_VERTICES - 1);
+
+        // Far apart vertices so that they can't use VTX_DIFF. Keep them below
+        // the point where rounding clamps to the largest 4.6 value.
+        for (size_t i = 0; i < count * 3; i++)
+            positions[i] = (int16_t)((rand() % 0xFFE0) - 0x8000);
+
+        glMeshStream stream = {
+            .positions = positions,
+            .count = count,
+        };
+
+        glMeshStats stats;
+        size_t words = glMeshEncode(&stream, list, MAX_WORDS,
+                                    GL_MESH_ROUND_VTX10, &stats);
+        CHECK(words != 0, "encoding failed");
+        CHECK(stats.vtx16 == 0, "VTX_16 used with rounding enabled");
+
+        int n = glMeshDecodePositions(list, decoded, MAX_VERTICES);
+        CHECK(n == (int)count, "decoded %d vertices, expected %zu", n, count);
+        if (n != (int)count)
+            continue;
+
+        for (size_t i = 0; i < count * 3; i++)
+        {
+            int diff = abs(decoded[i] - positions[i]);
+
+            // 1/128 units in 4.12 format
+            if (diff > 32)
+            {
+                CHECK(0, "vertex %zu: %d rounded to %d", i / 3, positions[i],
+                      decoded[i]);
+                break;
+            }
+        }
+    }
+
+    // Values that don't fit in 4.6 after rounding are clamped
+    static const int16_t big[] = { 0x7FFF, 0x7FFF, 0x7FFF };
+    glMeshStream stream = { .positions = big, .count = 1 };
+    glMeshEncode(&stream, list, MAX_WORDS, GL_MESH_ROUND_VTX10, NULL);
+    glMeshDecodePositions(list, decoded, 1);
+    CHECK(decoded[0] == 511 << 6, "0x7FFF rounded to %d", decoded[0]);
+}
+
+static void test_attributes(void)
+{
+    size_t count = 64;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        positions[i * 3 + 0] = i * 64;
+        positions[i * 3 + 1] = 0;
+        positions[i * 3 + 2] = 0;
+        normals[i] = i / 4;   // 3 of every 4 are redundant
+        texcoords[i] = i / 2; // 1 of every 2 is redundant
+    }
+
+    glMeshStream stream = {
+        .positions = positions,
+        .normals = normals,
+        .texcoords = texcoords,
+        .count = count,
+    };
+
+    glMeshStats stats;
+    glMeshEncode(&stream, list, MAX_WORDS, 0, &stats);
+    CHECK(stats.skipped_attrs == count * 3 / 4 + count / 2,
+          "skipped %u attributes", (unsigned)stats.skipped_attrs);
+
+    // A color between two identical normals means that the second normal has
+    // to be sent again.
+    for (size_t i = 0; i < count; i++)
+        colors[i] = i;
+
+    stream.colors = colors;
+    glMeshEncode(&stream, list, MAX_WORDS, 0, &stats);
+    CHECK(stats.skipped_attrs == count / 2, "skipped %u attributes with colors",
+          (unsigned)stats.skipped_attrs);
+
+    int n = glMeshDecodePositions(list, decoded, MAX_VERTICES);
+    CHECK(n == (int)count, "decoded %d vertices", n);
+    CHECK(memcmp(decoded, positions, count * 3 * sizeof(int16_t)) == 0,
+          "decoded positions differ");
+}
+
+static void test_pack(void)
+{
+    // 1.0 in a 16x16 texture is 16 texels, 256 in 12.4
+    CHECK(glMeshPackTexCoordf32(1 << 12, 1 << 12, 16, 16) == 0x01000100,
+          "texcoord 1.0");
+
+    // Rounding to the nearest 1/16 of a texel
+    CHECK(glMeshPackTexCoordf32(7, 8, 16, 16) == 0x00010000,
+          "texcoord rounding 0x%08X",
+          (unsigned)glMeshPackTexCoordf32(7, 8, 16, 16));
+
+    // Negative coordinates
+    CHECK(glMeshPackTexCoordf32(-(1 << 12), 0, 16, 16) == 0x0000FF00,
+          "texcoord -1.0");
+
+    // Out of range values are clamped instead of wrapping around
+    CHECK(glMeshPackTexCoordf32(100 << 12, -(100 << 12), 1024, 1024)
+          == 0x80007FFF, "texcoord clamp 0x%08X",
+          (unsigned)glMeshPackTexCoordf32(100 << 12, -(100 << 12), 1024, 1024));
+
+    CHECK(glMeshPackNormalf32(1 << 12, -(1 << 12), 0) == 0x000801FF,
+          "normal clamp 0x%08X",
+          (unsigned)glMeshPackNormalf32(1 << 12, -(1 << 12), 0));
+}
+
+int main(void)
+{
+    srand(1234);
+
+    test_round_trip();
+    test_commands();
+    test_rounding();
+    test_attributes();
+    test_pack();
+
+    if (failures != 0)
+    {
+        printf("glMesh: %d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("glMesh: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: CC0-1.0
+//
+// SPDX-FileContributor: Antonio Niño Díaz, 2026
+
+// Host tests of the tile deduplication of nds/arm9/tilePool.h. Maps are added
+// to a pool and the result is rendered pixel by pixel and compared with the
+// original map.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nds/arm9/tilePool.h>
+
+#define TILE_FLIP_H     (1 << 10)
+#define TILE_FLIP_V     (1 << 11)
+
+#define UNIQUE_TILES    200
+#define TILESET_SIZE    600
+#define MAP_ENTRIES     (64 * 32)
+#define ITERATIONS      50
+
+static int failures;
+
+#define CHECK(cond, ...)                                        \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+        {                                                       \
+            printf("%s:%d: ", __func__, __LINE__);              \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            failures++;                                         \
+        }                                                       \
+    } while (0)
+
+static u32 tileset[TILESET_SIZE * 16];
+static u32 gfx[TILE_POOL_MAX_TILES * 16];
+static u16 src_map[MAP_ENTRIES];
+static u16 dst_map[MAP_ENTRIES];
+
+static int get_pixel(const u32 *tile, int bpp, int x, int y)
+{
+    const u8 *bytes = (const u8 *)tile;
+
+    if (bpp == 8)
+        return bytes[y * 8 + x];
+
+    u8 b = bytes[y * 4 + x / 2];
+    return (x & 1) ? (b >> 4) : (b & 0xF);
+}
+
+static void set_pixel(u32 *tile, int bpp, int x, int y, int value)
+{
+    u8 *bytes = (u8 *)tile;
+
+    if (bpp == 8)
+    {
+        bytes[y * 8 + x] = value;
+        return;
+    }
+
+    u8 *b = &bytes[y * 4 + x / 2];
+    if (x & 1)
+        *b = (*b & 0x0F) | (value << 4);
+    else
+        *b = (*b & 0xF0) | value;
+}
+
+// Returns the pixel displayed by a map entry, taking the flip bits into account
+static int entry_pixel(const u32 *tiles, int bpp, u16 entry, int x, int y)
+{
+    if (entry & TILE_FLIP_H)
+        x = 7 - x;
+    if (entry & TILE_FLIP_V)
+        y = 7 - y;
+
+    return get_pixel(tiles + (entry & 0x3FF) * bpp * 2, bpp, x, y);
+}
+
+// Fills the tileset with UNIQUE_TILES random tiles followed by copies of them
+// with random flips. Returns the number of different tiles.
+static int make_tileset(int bpp)
+{
+    int words = bpp * 2;
+    int mask = (1 << bpp) - 1;
+
+    for (int t = 0; t < UNIQUE_TILES; t++)
+    {
+        for (int y = 0; y < 8; y++)
+        {
+            for (int x = 0; x < 8; x++)
+                set_pixel(&tileset[t * words], bpp, x, y, rand() & mask);
+        }
+    }
+
+    for (int t = UNIQUE_TILES; t < TILESET_SIZE; t++)
+    {
+        int orig = rand() % UNIQUE_TILES;
+        int flip = rand() & 3;
+
+        for (int y = 0; y < 8; y++)
+        {
+            for (int x = 0; x < 8; x++)
+            {
+                int sx = (flip & 1) ? 7 - x : x;
+                int sy = (flip & 2) ? 7 - y : y;
+                int p = get_pixel(&tileset[orig * words], bpp, sx, sy);
+                set_pixel(&tileset[t * words], bpp, x, y, p);
+            }
+        }
+    }
+
+    return UNIQUE_TILES;
+}
+
+static void make_map(void)
+{
+    for (int i = 0; i < MAP_ENTRIES; i++)
+    {
+        // All tiles of the tileset are used at least once. The rest of the
+        // entries use random tiles. Flip bits and palettes are random.
+        int tile = (i < TILESET_SIZE) ? i : (rand() % TILESET_SIZE);
+        src_map[i] = tile | (rand() & 0xFC00);
+    }
+}
+
+// Returns the index of the first entry that looks different, or -1
+static int compare_maps(int bpp, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((src_map[i] & 0xF000) != (dst_map[i] & 0xF000))
+            return i;
+
+        for (int y = 0; y < 8; y++)
+        {
+            for (int x = 0; x < 8; x++)
+            {
+                int a = entry_pixel(tileset, bpp, src_map[i], x, y);
+                int b = entry_pixel(gfx, bpp, dst_map[i], x, y);
+                if (a != b)
+                    return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+static void test_round_trip(int bpp)
+{
+    for (int it = 0; it < ITERATIONS; it++)
+    {
+        int unique = make_tileset(bpp);
+        make_map();
+
+        TilePool pool;
+        CHECK(tilePoolInit(&pool, gfx, TILE_POOL_MAX_TILES, bpp) == 0,
+              "init failed");
+
+        int ret = tilePoolAddMap(&pool, tileset, TILESET_SIZE, src_map, dst_map,
+                                 MAP_ENTRIES);
+        CHECK(ret == 0, "tilePoolAddMap() failed");
+
+        CHECK(pool.numTiles == unique, "%d bpp: %d tiles stored, expected %d",
+              bpp, pool.numTiles, unique);
+
+        int bad = compare_maps(bpp, MAP_ENTRIES);
+        CHECK(bad == -1, "%d bpp: map entry %d differs", bpp, bad);
+
+        // Adding the same map again doesn't add any tile, and it can be done in
+        // place.
+        memcpy(dst_map, src_map, sizeof(src_map));
+        ret = tilePoolAddMap(&pool, tileset, TILESET_SIZE, dst_map, dst_map,
+                             MAP_ENTRIES);
+        CHECK(ret == 0, "tilePoolAddMap() in place failed");
+        CHECK(pool.numTiles == unique, "%d bpp: tiles added again", bpp);
+
+        bad = compare_maps(bpp, MAP_ENTRIES);
+        CHECK(bad == -1, "%d bpp: in place map entry %d differs", bpp, bad);
+
+        tilePoolDeinit(&pool);
+    }
+}
+
+static void test_add_tile(void)
+{
+    TilePool pool;
+    CHECK(tilePoolInit(&pool, gfx, 4, 4) == 0, "init failed");
+
+    make_tileset(4);
+
+    // A tile and its flipped versions are stored once
+    u32 flipped[8];
+    memset(flipped, 0, sizeof(flipped));
+    for (int y = 0; y < 8; y++)
+    {
+        for (int x = 0; x < 8; x++)
+            set_pixel(flipped, 4, x, y, get_pixel(tileset, 4, 7 - x, 7 - y));
+    }
+
+    CHECK(tilePoolAddTile(&pool, tileset) == 0, "first tile");
+    CHECK(tilePoolAddTile(&pool, tileset) == 0, "same tile");
+    CHECK(tilePoolAddTile(&pool, flipped) == (0 | TILE_FLIP_H | TILE_FLIP_V),
+          "flipped tile");
+
+    // Fill the pool and check that it rejects new tiles
+    CHECK(tilePoolAddTile(&pool, &tileset[8]) == 1, "second tile");
+    CHECK(tilePoolAddTile(&pool, &tileset[16]) == 2, "third tile");
+    CHECK(tilePoolAddTile(&pool, &tileset[24]) == 3, "fourth tile");
+    CHECK(tilePoolAddTile(&pool, &tileset[32]) == -1, "pool not full");
+    CHECK(tilePoolAddTile(&pool, &tileset[8]) == 1, "stored tile rejected");
+
+    // A map that doesn't fit leaves the destination untouched
+    for (int i = 0; i < 16; i++)
+        src_map[i] = i;
+    memset(dst_map, 0xAB, sizeof(dst_map));
+
+    CHECK(tilePoolAddMap(&pool, tileset, 16, src_map, dst_map, 16) == -1,
+          "map accepted in a full pool");
+    CHECK(dst_map[0] == 0xABAB, "map modified on error");
+
+    // Entries that point outside of the tileset are rejected
+    tilePoolReset(&pool);
+    src_map[0] = 20;
+    CHECK(tilePoolAddMap(&pool, tileset, 16, src_map, dst_map, 1) == -1,
+          "invalid tile index accepted");
+
+    tilePoolDeinit(&pool);
+
+    // Invalid arguments
+    CHECK(tilePoolInit(&pool, gfx, 0, 4) == -1, "0 tiles accepted");
+    CHECK(tilePoolInit(&pool, gfx, TILE_POOL_MAX_TILES + 1, 4) == -1,
+          "too many tiles accepted");
+    CHECK(tilePoolInit(&pool, gfx, 16, 2) == -1, "2 bpp accepted");
+    CHECK(tilePoolInit(&pool, (u8 *)gfx + 2, 16, 4) == -1,
+          "unaligned buffer accepted");
+}
+
+int main(void)
+{
+    srand(1234);
+
+    test_round_trip(4);
+    test_round_trip(8);
+    test_add_tile();
+
+    if (failures != 0)
+    {
+        printf("tilePool: %d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("tilePool: all checks passed\n");
+    return 0;
+}